@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File BaseFlowSliceStore.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Memory-mapped storage of the Fourier coefficients of a
+// periodic base flow
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./BaseFlowSliceStore.h"
+#include <LibUtilities/BasicUtils/ErrorUtil.hpp>
+#include <cstring>
+#include <fstream>
+
+namespace Nektar
+{
+    namespace
+    {
+        const char   StoreTag[8]  = {'B','F','S','T','O','R','E','1'};
+        const size_t HeaderSize   = 64;
+
+        struct StoreHeader
+        {
+            char m_tag[8];
+            int  m_nvar;
+            int  m_ngrad;
+            int  m_npoints;
+            int  m_slices;
+        };
+
+        bool ReadHeader(const std::string &filename, StoreHeader &header)
+        {
+            std::ifstream in(filename.c_str(), std::ios::binary);
+            if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+            {
+                return false;
+            }
+            return std::memcmp(header.m_tag, StoreTag, 8) == 0;
+        }
+    }
+
+    BaseFlowSliceStore::BaseFlowSliceStore(const std::string &filename)
+        : m_file(filename.c_str(), boost::interprocess::read_only),
+          m_region(m_file, boost::interprocess::read_only)
+    {
+        const char *base = static_cast<const char *>(m_region.get_address());
+
+        StoreHeader header;
+        ASSERTL0(m_region.get_size() >= HeaderSize,
+                 "Cannot read base flow store " + filename);
+        std::memcpy(&header, base, sizeof(header));
+        ASSERTL0(std::memcmp(header.m_tag, StoreTag, 8) == 0,
+                 "Not a base flow store: " + filename);
+
+        m_nvar    = header.m_nvar;
+        m_ngrad   = header.m_ngrad;
+        m_npoints = header.m_npoints;
+        m_slices  = header.m_slices;
+
+        size_t expected = HeaderSize + size_t(m_nvar + m_ngrad) * m_slices
+                                     * m_npoints * sizeof(NekDouble);
+        ASSERTL0(m_region.get_size() >= expected,
+                 "Base flow store " + filename + " is truncated");
+
+        m_data = reinterpret_cast<const NekDouble *>(base + HeaderSize);
+    }
+
+    void BaseFlowSliceStore::Write(
+        const std::string                          &filename,
+        const Array<OneD, Array<OneD, NekDouble> > &coeffs,
+        const Array<OneD, Array<OneD, NekDouble> > &grads,
+        const int                                   npoints,
+        const int                                   slices)
+    {
+        StoreHeader header;
+        std::memcpy(header.m_tag, StoreTag, 8);
+        header.m_nvar    = coeffs.num_elements();
+        header.m_ngrad   = grads.num_elements();
+        header.m_npoints = npoints;
+        header.m_slices  = slices;
+
+        std::ofstream out(filename.c_str(), std::ios::binary);
+        ASSERTL0(out.good(), "Cannot write base flow store " + filename);
+
+        char padded[HeaderSize];
+        std::memset(padded, 0, HeaderSize);
+        std::memcpy(padded, &header, sizeof(header));
+        out.write(padded, HeaderSize);
+
+        size_t nbytes = size_t(npoints) * slices * sizeof(NekDouble);
+        for (int i = 0; i < header.m_nvar; ++i)
+        {
+            out.write(reinterpret_cast<const char *>(&coeffs[i][0]), nbytes);
+        }
+        for (int i = 0; i < header.m_ngrad; ++i)
+        {
+            out.write(reinterpret_cast<const char *>(&grads[i][0]), nbytes);
+        }
+        ASSERTL0(out.good(), "Error writing base flow store " + filename);
+    }
+
+    bool BaseFlowSliceStore::IsValid(
+        const std::string &filename,
+        const int          nvar,
+        const int          npoints,
+        const int          slices)
+    {
+        StoreHeader header;
+        return ReadHeader(filename, header) &&
+               header.m_nvar    == nvar    &&
+               header.m_npoints == npoints &&
+               header.m_slices  == slices;
+    }
+}
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File BaseFlowSliceStore.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Memory-mapped storage of the Fourier coefficients of a
+// periodic base flow
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_BASEFLOWSLICESTORE_H
+#define NEKTAR_SOLVERS_BASEFLOWSLICESTORE_H
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <string>
+
+namespace Nektar
+{
+    class BaseFlowSliceStore;
+    typedef boost::shared_ptr<BaseFlowSliceStore> BaseFlowSliceStoreSharedPtr;
+
+    /**
+     * Binary file holding, for one rank, the Fourier coefficients of a
+     * periodic base flow as produced by LinearisedAdvection::DFT and
+     * optionally their gradients. The file is mapped read-only, so only the
+     * pages of the coefficients that are actually used are read from disk
+     * and they can be dropped again by the operating system.
+     *
+     * Layout: a 64 byte header (tag, number of variables, number of
+     * gradient arrays, points per slice, slices) followed by the
+     * coefficients, variable by variable and slice by slice, and then the
+     * gradients in the same order.
+     */
+    class BaseFlowSliceStore
+    {
+    public:
+        BaseFlowSliceStore(const std::string &filename);
+
+        /// Write coefficients (and gradients, may be empty) to \a filename.
+        static void Write(
+            const std::string                          &filename,
+            const Array<OneD, Array<OneD, NekDouble> > &coeffs,
+            const Array<OneD, Array<OneD, NekDouble> > &grads,
+            const int                                   npoints,
+            const int                                   slices);
+
+        /// True if \a filename exists and matches the given sizes.
+        static bool IsValid(
+            const std::string &filename,
+            const int          nvar,
+            const int          npoints,
+            const int          slices);
+
+        const NekDouble *GetCoeff(const int var, const int slice) const
+        {
+            return m_data + (size_t(var)*m_slices + slice)*m_npoints;
+        }
+
+        /// Gradient \a index (var*nBaseDerivs + direction) of a slice.
+        const NekDouble *GetGrad(const int index, const int slice) const
+        {
+            return m_data + (size_t(m_nvar + index)*m_slices + slice)
+                            *m_npoints;
+        }
+
+        int GetNumGrads() const
+        {
+            return m_ngrad;
+        }
+
+    protected:
+        boost::interprocess::file_mapping  m_file;
+        boost::interprocess::mapped_region m_region;
+        const NekDouble                   *m_data;
+        int                                m_nvar;
+        int                                m_ngrad;
+        int                                m_npoints;
+        int                                m_slices;
+    };
+}
+
+#endif
@@ -35,6 +35,9 @@
 
 #include "./LinearisedAdvection.h"
 #include <StdRegions/StdSegExp.h>
+#include <LibUtilities/BasicUtils/Timer.h>
+#include <boost/format.hpp>
+#include <sys/resource.h>
 
 using namespace std;
 
@@ -53,7 +56,9 @@ string LinearisedAdvection::className
  */
 
 LinearisedAdvection::LinearisedAdvection():
-    Advection()
+    Advection(),
+    m_baseUpdateTime(0.0),
+    m_baseUpdateCalls(0)
 {
 }
 
@@ -181,7 +186,7 @@ void LinearisedAdvection::v_InitObject(
             ASSERTL0(m_session->GetFunctionType("BaseFlow", 0)
                 == LibUtilities::eFunctionTypeFile,
                 "Base flow should be a sequence of files.");
-            DFT(file,pFields,m_slices);
+            LoadPeriodicBase(file,pFields);
         }
         else
         {
@@ -241,6 +246,12 @@ void LinearisedAdvection::v_InitObject(
 
 LinearisedAdvection::~LinearisedAdvection()
 {
+    if (m_baseUpdateCalls > 0 && m_session->GetComm()->GetRank() == 0)
+    {
+        cout << "Periodic base flow update: " << m_baseUpdateCalls
+             << " calls, mean time " << m_baseUpdateTime/m_baseUpdateCalls
+             << " s" << endl;
+    }
 }
 
 
@@ -287,12 +298,23 @@ void LinearisedAdvection::v_Advect(
     // Evaluation of the base flow for periodic cases
     if (m_slices > 1)
     {
+        LibUtilities::Timer timer;
+        timer.Start();
+
+        bool precomputed = HasSliceGrads();
+        UpdateDFTWeights(time);
         for (int i = 0; i < ndim; ++i)
         {
-            UpdateBase(m_slices, m_interp[i], m_baseflow[i],
-                       time, m_period);
-            UpdateGradBase(i, fields[i]);
+            UpdateBaseAndGrad(i, precomputed);
+            if (!precomputed)
+            {
+                UpdateGradBase(i, fields[i]);
+            }
         }
+
+        timer.Stop();
+        m_baseUpdateTime += timer.TimePerTest(1);
+        ++m_baseUpdateCalls;
     }
 
     //Evaluate the linearised advection term
@@ -497,7 +519,6 @@ void LinearisedAdvection::UpdateBase(
     int npoints     = m_baseflow[0].num_elements();
     NekDouble BetaT = 2*M_PI*fmod (m_time, m_period) / m_period;
     NekDouble phase;
-    Array<OneD, NekDouble> auxiliary(npoints);
 
     Vmath::Vcopy(npoints,&inarray[0],1,&outarray[0],1);
     Vmath::Svtvp(npoints, cos(0.5*m_slices*BetaT),&inarray[npoints],1,&outarray[0],1,&outarray[0],1);
@@ -512,6 +533,254 @@ void LinearisedAdvection::UpdateBase(
 
 }
 
+/**
+ * Weights of the Fourier coefficients of the base flow at time \a time, in
+ * the order used by UpdateBase. The table is kept until the time changes,
+ * so the stages of a step and all variables share it.
+ */
+void LinearisedAdvection::UpdateDFTWeights(const NekDouble time)
+{
+    if (m_dftWeights.num_elements() == m_slices && time == m_weightsTime)
+    {
+        return;
+    }
+    if (m_dftWeights.num_elements() != m_slices)
+    {
+        m_dftWeights = Array<OneD, NekDouble>(m_slices, 0.0);
+    }
+
+    NekDouble BetaT = 2*M_PI*fmod (time, m_period) / m_period;
+    NekDouble phase;
+
+    m_dftWeights[0] = 1.0;
+    m_dftWeights[1] = cos(0.5*m_slices*BetaT);
+    for (int i = 2; i < m_slices; i += 2)
+    {
+        phase = (i>>1) * BetaT;
+        m_dftWeights[i]   =  cos(phase);
+        m_dftWeights[i+1] = -sin(phase);
+    }
+    m_weightsTime = time;
+}
+
+/**
+ * Base flow, and its gradient if \a withGrad, for variable \a var from the
+ * Fourier coefficients in m_activeSlices and their precomputed gradients,
+ * using the weights of UpdateDFTWeights. With all coefficients active the
+ * base flow is bitwise that of UpdateBase; differentiation is linear, so
+ * the gradient equals that of UpdateGradBase up to round-off.
+ */
+void LinearisedAdvection::UpdateBaseAndGrad(const int var, const bool withGrad)
+{
+    int npoints     = m_baseflow[0].num_elements();
+    int nBaseDerivs = (m_halfMode || m_singleMode) ? 2 : m_spacedim;
+    int nactive     = m_activeSlices.size();
+
+    Vmath::Vcopy(npoints, GetSliceCoeff(var, 0), 1, &m_baseflow[var][0], 1);
+    for (int n = 1; n < nactive; ++n)
+    {
+        int s = m_activeSlices[n];
+        Vmath::Svtvp(npoints, m_dftWeights[s], GetSliceCoeff(var, s), 1,
+                     &m_baseflow[var][0], 1, &m_baseflow[var][0], 1);
+    }
+
+    if (!withGrad)
+    {
+        return;
+    }
+
+    for (int j = 0; j < nBaseDerivs; ++j)
+    {
+        int index = var*nBaseDerivs + j;
+        Array<OneD, NekDouble> &out = m_gradBase[index];
+
+        Vmath::Vcopy(npoints, GetSliceGrad(index, 0), 1, &out[0], 1);
+        for (int n = 1; n < nactive; ++n)
+        {
+            int s = m_activeSlices[n];
+            Vmath::Svtvp(npoints, m_dftWeights[s], GetSliceGrad(index, s), 1,
+                         &out[0], 1, &out[0], 1);
+        }
+    }
+}
+
+const NekDouble *LinearisedAdvection::GetSliceCoeff(
+        const int var, const int slice) const
+{
+    if (m_sliceStore)
+    {
+        return m_sliceStore->GetCoeff(var, slice);
+    }
+    return &m_interp[var][slice*m_baseflow[0].num_elements()];
+}
+
+const NekDouble *LinearisedAdvection::GetSliceGrad(
+        const int index, const int slice) const
+{
+    if (m_sliceStore)
+    {
+        return m_sliceStore->GetGrad(index, slice);
+    }
+    return &m_interpGrad[index][slice*m_baseflow[0].num_elements()];
+}
+
+bool LinearisedAdvection::HasSliceGrads() const
+{
+    if (m_sliceStore)
+    {
+        return m_sliceStore->GetNumGrads() > 0;
+    }
+    return m_interpGrad.num_elements() > 0;
+}
+
+/**
+ * Sets up the Fourier coefficients of a periodic base flow.
+ *
+ * By default all slices are imported and transformed by DFT and kept in
+ * memory. With BaseFlowStore = 1 the coefficients (and the gradients of
+ * GradDFT) are written once to a binary file per rank next to the base
+ * flow files, and later runs memory-map that file instead of importing the
+ * slices, so only the coefficients actually used are paged in.
+ * BaseFlowHarmonics = K keeps the mean and the first K harmonics only.
+ */
+void LinearisedAdvection::LoadPeriodicBase(
+        const std::string                            file,
+        Array<OneD, MultiRegions::ExpListSharedPtr> &pFields)
+{
+    int useStore, harmonics;
+    m_session->LoadParameter("BaseFlowStore",     useStore,  0);
+    m_session->LoadParameter("BaseFlowHarmonics", harmonics, -1);
+
+    // coefficient 1 is the cosine of harmonic m_slices/2, then the
+    // cosine/sine pairs of harmonics 1, 2, ...
+    m_activeSlices.clear();
+    m_activeSlices.push_back(0);
+    for (int i = 1; i < m_slices; ++i)
+    {
+        int harmonic = (i == 1) ? m_slices/2 : i/2;
+        if (harmonics < 0 || harmonic <= harmonics)
+        {
+            m_activeSlices.push_back(i);
+        }
+    }
+
+    int rank = m_session->GetComm()->GetRank();
+    if (!useStore)
+    {
+        DFT(file,pFields,m_slices);
+        GradDFT(pFields);
+    }
+    else
+    {
+        int ConvectedFields = m_baseflow.num_elements()-1;
+        int npoints         = m_baseflow[0].num_elements();
+
+        std::string store = file;
+        ASSERTL0(store.find("%d") != string::npos,
+                 "BaseFlow filename must include '%d' to index the slices.");
+        store.replace(store.find("%d"), 2, "dft");
+        store += boost::str(boost::format(".P%07d.bin") % rank);
+
+        // rebuild on all ranks if any store is missing, the import of the
+        // slices may be collective
+        int valid = BaseFlowSliceStore::IsValid(store, ConvectedFields,
+                                                npoints, m_slices);
+        m_session->GetComm()->AllReduce(valid, LibUtilities::ReduceMin);
+
+        if (!valid)
+        {
+            DFT(file,pFields,m_slices);
+            GradDFT(pFields);
+            BaseFlowSliceStore::Write(store, m_interp, m_interpGrad,
+                                      npoints, m_slices);
+            m_interp     = Array<OneD, Array<OneD, NekDouble> >();
+            m_interpGrad = Array<OneD, Array<OneD, NekDouble> >();
+        }
+        m_sliceStore = MemoryManager<BaseFlowSliceStore>
+                                        ::AllocateSharedPtr(store);
+    }
+
+    if (rank == 0)
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        cout << "Periodic base flow: " << m_activeSlices.size() << " of "
+             << m_slices << " Fourier coefficients, "
+             << (m_sliceStore ? "memory-mapped" : "in memory")
+             << (HasSliceGrads() ? " with" : " without")
+             << " precomputed gradients, peak RSS "
+             << usage.ru_maxrss/1024.0 << " MB" << endl;
+    }
+}
+
+/**
+ * Differentiates each Fourier coefficient of the periodic base flow once,
+ * so that v_Advect does not call PhysDeriv on the base flow at every step.
+ * The storage is nBaseDerivs times that of m_interp; if it exceeds
+ * BaseGradientMemoryMB (default 512) or PrecomputeBaseGradients is 0 the
+ * gradients are recomputed at every step as before.
+ */
+void LinearisedAdvection::GradDFT(
+        Array<OneD, MultiRegions::ExpListSharedPtr> &pFields)
+{
+    int precompute;
+    NekDouble memoryMB;
+    m_session->LoadParameter("PrecomputeBaseGradients", precompute, 1);
+    m_session->LoadParameter("BaseGradientMemoryMB", memoryMB, 512.0);
+
+    int ConvectedFields = m_interp.num_elements();
+    int npoints         = m_baseflow[0].num_elements();
+    int nBaseDerivs     = (m_halfMode || m_singleMode) ? 2 : m_spacedim;
+    NekDouble requiredMB = NekDouble(ConvectedFields) * nBaseDerivs *
+        npoints * m_slices * sizeof(NekDouble) / (1024.0*1024.0);
+
+    if (!precompute)
+    {
+        return;
+    }
+    if (requiredMB > memoryMB)
+    {
+        if (m_session->GetComm()->GetRank() == 0)
+        {
+            cout << "Base flow gradients need " << requiredMB
+                 << " MB > BaseGradientMemoryMB = " << memoryMB
+                 << ", recomputing them at every step" << endl;
+        }
+        return;
+    }
+
+    m_interpGrad = Array<OneD, Array<OneD, NekDouble> >
+                                        (ConvectedFields*nBaseDerivs);
+    Array<OneD, NekDouble> base(npoints);
+    for (int i = 0; i < ConvectedFields; ++i)
+    {
+        Vmath::Vcopy(npoints, &m_baseflow[i][0], 1, &base[0], 1);
+
+        for (int j = 0; j < nBaseDerivs; ++j)
+        {
+            m_interpGrad[i*nBaseDerivs + j] =
+                Array<OneD, NekDouble>(npoints*m_slices, 0.0);
+        }
+
+        // differentiate each coefficient with the same routine as the
+        // base flow itself
+        for (int s = 0; s < m_slices; ++s)
+        {
+            Vmath::Vcopy(npoints, &m_interp[i][s*npoints], 1,
+                                  &m_baseflow[i][0], 1);
+            UpdateGradBase(i, pFields[i]);
+            for (int j = 0; j < nBaseDerivs; ++j)
+            {
+                Vmath::Vcopy(npoints, &m_gradBase[i*nBaseDerivs + j][0], 1,
+                             &m_interpGrad[i*nBaseDerivs + j][s*npoints], 1);
+            }
+        }
+
+        Vmath::Vcopy(npoints, &base[0], 1, &m_baseflow[i][0], 1);
+        UpdateGradBase(i, pFields[i]);
+    }
+}
+
 void LinearisedAdvection::UpdateGradBase(
         const int                                var,
         const MultiRegions::ExpListSharedPtr     &field)
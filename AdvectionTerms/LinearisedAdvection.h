@@ -38,6 +38,7 @@
 
 #include <SolverUtils/Advection/Advection.h>
 #include <LibUtilities/FFT/NektarFFT.h>
+#include "./BaseFlowSliceStore.h"
 
 
 namespace Nektar
@@ -84,6 +85,19 @@ protected:
     NekDouble                                       m_period;
     /// interpolation vector
     Array<OneD, Array<OneD, NekDouble> >            m_interp;
+    /// gradients of the Fourier coefficients in m_interp, empty if the
+    /// gradients are recomputed at every step
+    Array<OneD, Array<OneD, NekDouble> >            m_interpGrad;
+    /// weights of the Fourier coefficients at m_weightsTime
+    Array<OneD, NekDouble>                          m_dftWeights;
+    NekDouble                                       m_weightsTime;
+    /// memory-mapped coefficients, replaces m_interp if BaseFlowStore = 1
+    BaseFlowSliceStoreSharedPtr                     m_sliceStore;
+    /// coefficients used in the reconstruction (BaseFlowHarmonics)
+    std::vector<int>                                m_activeSlices;
+    /// time spent updating the periodic base flow
+    NekDouble                                       m_baseUpdateTime;
+    int                                             m_baseUpdateCalls;
     /// auxiliary variables
     LibUtilities::NektarFFTSharedPtr                m_FFT;
     Array<OneD,NekDouble>                           m_tmpIN;
@@ -138,6 +152,26 @@ protected:
         const int                                          var,
         const MultiRegions::ExpListSharedPtr              &field);
 
+    void GradDFT(
+        Array<OneD, MultiRegions::ExpListSharedPtr>       &pFields);
+
+    void UpdateDFTWeights(
+        const NekDouble                                    time);
+
+    void UpdateBaseAndGrad(
+        const int                                          var,
+        const bool                                         withGrad);
+
+    void LoadPeriodicBase(
+        const std::string                                  file,
+              Array<OneD, MultiRegions::ExpListSharedPtr> &pFields);
+
+    const NekDouble *GetSliceCoeff(const int var, const int slice) const;
+
+    const NekDouble *GetSliceGrad(const int index, const int slice) const;
+
+    bool HasSliceGrads() const;
+
     void DFT(
         const std::string                                  file,
               Array<OneD, MultiRegions::ExpListSharedPtr> &pFields,
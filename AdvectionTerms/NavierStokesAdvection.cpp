@@ -34,6 +34,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "./NavierStokesAdvection.h"
+#include <LibUtilities/Foundations/Interp.h>
+#include <LibUtilities/Foundations/PhysGalerkinProject.h>
 
 using namespace std;
 
@@ -75,8 +77,81 @@ namespace Nektar
         }
         pSession->MatchSolverInfo("ModeType","SingleMode",m_SingleMode,false);
         pSession->MatchSolverInfo("ModeType","HalfMode",m_HalfMode,false);
+        pSession->MatchSolverInfo("FusedAdvection","True",m_fusedAdvection,true);
 
         Advection::v_InitObject(pSession, pFields);
+
+        if(m_fusedAdvection)
+        {
+            InitWorkspace(pFields);
+        }
+    }
+
+    /**
+     * Allocates the buffers used by AdvectFused once, so that v_Advect does
+     * not allocate in the time loop. The element scratch is sized for the
+     * largest element of a 2D plane, on the 3/2 grid if dealiasing.
+     */
+    void NavierStokesAdvection::InitWorkspace(
+        const Array<OneD, MultiRegions::ExpListSharedPtr> &pFields)
+    {
+        NekDouble OneDptscale = 1.5;
+        int nqtot   = pFields[0]->GetTotPoints();
+        int nscaled = m_specHP_dealiasing ?
+            pFields[0]->Get1DScaledTotPoints(OneDptscale) : nqtot;
+
+        m_wsVelocity = Array<OneD, Array<OneD, NekDouble> >(3);
+        m_wsAdvVel   = Array<OneD, Array<OneD, NekDouble> >(3);
+        for(int i = 0; i < 3; ++i)
+        {
+            m_wsVelocity[i] = Array<OneD, NekDouble>(nqtot, 0.0);
+            if(m_specHP_dealiasing)
+            {
+                m_wsAdvVel[i] = Array<OneD, NekDouble>(nscaled, 0.0);
+            }
+        }
+        m_wsPhys  = Array<OneD, NekDouble>(nqtot, 0.0);
+        m_wsGradZ = Array<OneD, NekDouble>(nqtot, 0.0);
+
+        MultiRegions::ExpListSharedPtr plane = pFields[0];
+        if(pFields[0]->GetExpType() == MultiRegions::e3DH1D)
+        {
+            plane = pFields[0]->GetPlane(0);
+        }
+
+        int maxPts = 1, maxScaled = 1;
+        for(int e = 0; e < plane->GetExpSize(); ++e)
+        {
+            LocalRegions::ExpansionSharedPtr exp = plane->GetExp(e);
+            int npts = exp->GetTotPoints();
+            int nsc  = 1;
+            for(int j = 0; j < exp->GetShapeDimension(); ++j)
+            {
+                nsc *= (int) (exp->GetNumPoints(j)*OneDptscale);
+            }
+            maxPts    = max(maxPts, npts);
+            maxScaled = max(maxScaled, nsc);
+        }
+        m_wsDeriv0 = Array<OneD, NekDouble>(maxPts, 0.0);
+        m_wsDeriv1 = Array<OneD, NekDouble>(maxPts, 0.0);
+        m_wsInterp = Array<OneD, NekDouble>(maxScaled, 0.0);
+        m_wsAccum  = Array<OneD, NekDouble>(maxScaled, 0.0);
+    }
+
+    bool NavierStokesAdvection::UseFusedKernel(
+        const int                                          ndim,
+        const Array<OneD, MultiRegions::ExpListSharedPtr> &fields) const
+    {
+        if(!m_fusedAdvection)
+        {
+            return false;
+        }
+        if(ndim == 2 && fields[0]->GetExpType() == MultiRegions::e2D)
+        {
+            return true;
+        }
+        return ndim == 3 && !m_homogen_dealiasing &&
+               fields[0]->GetExpType() == MultiRegions::e3DH1D;
     }
 
 
@@ -93,6 +168,35 @@ namespace Nektar
         int nqtot            = fields[0]->GetTotPoints();
         ASSERTL1(nConvectiveFields == inarray.num_elements(),"Number of convective fields and Inarray are not compatible");
 
+        if(UseFusedKernel(advVel.num_elements(), fields))
+        {
+            AdvectFused(nConvectiveFields, fields, advVel, inarray, outarray);
+        }
+        else
+        {
+            AdvectSeparate(nConvectiveFields, fields, advVel, inarray, outarray);
+        }
+
+        for(int n = 0; n < nConvectiveFields; ++n)
+        {
+            Vmath::Neg(nqtot,outarray[n],1);
+        }
+    }
+
+    /**
+     * Original evaluation: every pass (interpolation, derivative, product,
+     * projection) runs over the whole field with temporaries allocated per
+     * call.
+     */
+    void NavierStokesAdvection::AdvectSeparate(
+        const int nConvectiveFields,
+        const Array<OneD, MultiRegions::ExpListSharedPtr> &fields,
+        const Array<OneD, Array<OneD, NekDouble> >        &advVel,
+        const Array<OneD, Array<OneD, NekDouble> >        &inarray,
+        Array<OneD, Array<OneD, NekDouble> >              &outarray)
+    {
+        int nqtot            = fields[0]->GetTotPoints();
+
         // use dimension of Velocity vector to dictate dimension of operation
         int ndim       = advVel.num_elements();
         Array<OneD, Array<OneD, NekDouble> > AdvVel   (advVel.num_elements());
@@ -335,12 +439,191 @@ namespace Nektar
         default:
             ASSERTL0(false,"dimension unknown");
         }
+    }
+
+    /**
+     * Same result as AdvectSeparate for 2D and Homogeneous1D fields, using
+     * the workspace of InitWorkspace. The in-plane derivatives, the
+     * interpolation to the 3/2 grid, the products with the advection
+     * velocity and the projection back are done element by element by
+     * FusedPlaneAdvect, so the intermediate gradients stay in cache. The
+     * z-derivative of Homogeneous1D fields is global and computed first.
+     */
+    void NavierStokesAdvection::AdvectFused(
+        const int nConvectiveFields,
+        const Array<OneD, MultiRegions::ExpListSharedPtr> &fields,
+        const Array<OneD, Array<OneD, NekDouble> >        &advVel,
+        const Array<OneD, Array<OneD, NekDouble> >        &inarray,
+        Array<OneD, Array<OneD, NekDouble> >              &outarray)
+    {
+        int ndim  = advVel.num_elements();
+        bool waveSpace = fields[0]->GetWaveSpace();
+        NekDouble OneDptscale = 1.5;
+
+        Array<OneD, Array<OneD, NekDouble> > velocity(ndim);
+        for(int i = 0; i < ndim; ++i)
+        {
+            if(waveSpace && !m_SingleMode && !m_HalfMode)
+            {
+                fields[i]->HomogeneousBwdTrans(advVel[i],m_wsVelocity[i]);
+                velocity[i] = m_wsVelocity[i];
+            }
+            else
+            {
+                velocity[i] = advVel[i];
+            }
+        }
+
+        const NekDouble *vel[3];
+        for(int i = 0; i < ndim; ++i)
+        {
+            if(m_specHP_dealiasing)
+            {
+                fields[0]->PhysInterp1DScaled(OneDptscale,velocity[i],
+                                              m_wsAdvVel[i]);
+                vel[i] = m_wsAdvVel[i].get();
+            }
+            else
+            {
+                vel[i] = velocity[i].get();
+            }
+        }
+
+        if(ndim == 2)
+        {
+            for(int n = 0; n < nConvectiveFields; ++n)
+            {
+                FusedPlaneAdvect(fields[0], ndim, inarray[n], vel, NULL,
+                                 outarray[n].get());
+            }
+            return;
+        }
+
+        MultiRegions::ExpListSharedPtr plane = fields[0]->GetPlane(0);
+        int nqplane = plane->GetTotPoints();
+        int nscaled = m_specHP_dealiasing ?
+            plane->Get1DScaledTotPoints(OneDptscale) : nqplane;
+        int nplanes = fields[0]->GetTotPoints()/nqplane;
 
         for(int n = 0; n < nConvectiveFields; ++n)
         {
-            Vmath::Neg(nqtot,outarray[n],1);
+            Array<OneD, const NekDouble> phys;
+            if(waveSpace)
+            {
+                if(n < ndim)
+                {
+                    phys = velocity[n];
+                }
+                else
+                {
+                    fields[0]->HomogeneousBwdTrans(inarray[n],m_wsPhys);
+                    phys = m_wsPhys;
+                }
+                // Take d/dz derivative using wave space field
+                fields[0]->PhysDeriv(MultiRegions::DirCartesianMap[2],
+                                     inarray[n], outarray[n]);
+                fields[0]->HomogeneousBwdTrans(outarray[n],m_wsGradZ);
+            }
+            else
+            {
+                phys = inarray[n];
+                fields[0]->PhysDeriv(MultiRegions::DirCartesianMap[2],
+                                     inarray[n], m_wsGradZ);
+            }
+
+            for(int p = 0; p < nplanes; ++p)
+            {
+                const NekDouble *planeVel[3];
+                for(int i = 0; i < 3; ++i)
+                {
+                    planeVel[i] = vel[i] + p*nscaled;
+                }
+                FusedPlaneAdvect(fields[0]->GetPlane(p), ndim,
+                                 phys + p*nqplane, planeVel,
+                                 m_wsGradZ.get() + p*nqplane,
+                                 outarray[n].get() + p*nqplane);
+            }
+
+            if(waveSpace)
+            {
+                fields[0]->HomogeneousFwdTrans(outarray[n],outarray[n]);
+            }
         }
+    }
+
+    /**
+     * u.grad(inarray) on one 2D expansion list, one element at a time.
+     * advVel points to the (dealiased) velocity of this plane, gradZ to
+     * the physical z-derivative or NULL in 2D.
+     */
+    void NavierStokesAdvection::FusedPlaneAdvect(
+        const MultiRegions::ExpListSharedPtr &plane,
+        const int                             ndim,
+        const Array<OneD, const NekDouble>   &inarray,
+        const NekDouble * const              *advVel,
+        const NekDouble                      *gradZ,
+              NekDouble                      *outarray)
+    {
+        NekDouble OneDptscale = 1.5;
+        NekDouble *grad0  = m_wsDeriv0.get();
+        NekDouble *grad1  = m_wsDeriv1.get();
+        NekDouble *interp = m_wsInterp.get();
+        NekDouble *accum  = m_wsAccum.get();
+        int cnt = 0, cnt1 = 0;
 
+        for(int e = 0; e < plane->GetExpSize(); ++e)
+        {
+            LocalRegions::ExpansionSharedPtr exp = plane->GetExp(e);
+            int pt0 = exp->GetNumPoints(0);
+            int pt1 = exp->GetNumPoints(1);
+            int nq  = pt0*pt1;
+
+            exp->PhysDeriv(inarray + cnt, m_wsDeriv0, m_wsDeriv1);
+
+            if(m_specHP_dealiasing)
+            {
+                int npt0 = (int) pt0*OneDptscale;
+                int npt1 = (int) pt1*OneDptscale;
+                int nqs  = npt0*npt1;
+
+                const LibUtilities::PointsKey &key0 =
+                    exp->GetBasis(0)->GetPointsKey();
+                const LibUtilities::PointsKey &key1 =
+                    exp->GetBasis(1)->GetPointsKey();
+                LibUtilities::PointsKey newKey0(npt0, exp->GetPointsType(0));
+                LibUtilities::PointsKey newKey1(npt1, exp->GetPointsType(1));
+
+                LibUtilities::Interp2D(key0, key1, grad0,
+                                       newKey0, newKey1, interp);
+                Vmath::Vmul (nqs,interp,1,advVel[0]+cnt1,1,accum,1);
+                LibUtilities::Interp2D(key0, key1, grad1,
+                                       newKey0, newKey1, interp);
+                Vmath::Vvtvp(nqs,interp,1,advVel[1]+cnt1,1,accum,1,accum,1);
+                if(ndim == 3)
+                {
+                    LibUtilities::Interp2D(key0, key1, gradZ+cnt,
+                                           newKey0, newKey1, interp);
+                    Vmath::Vvtvp(nqs,interp,1,advVel[2]+cnt1,1,
+                                 accum,1,accum,1);
+                }
+                // Galerkin project back to the original points
+                LibUtilities::PhysGalerkinProject2D(newKey0, newKey1, accum,
+                                                    key0, key1, outarray+cnt);
+                cnt1 += nqs;
+            }
+            else
+            {
+                Vmath::Vmul (nq,grad0,1,advVel[0]+cnt,1,outarray+cnt,1);
+                Vmath::Vvtvp(nq,grad1,1,advVel[1]+cnt,1,outarray+cnt,1,
+                             outarray+cnt,1);
+                if(ndim == 3)
+                {
+                    Vmath::Vvtvp(nq,gradZ+cnt,1,advVel[2]+cnt,1,
+                                 outarray+cnt,1,outarray+cnt,1);
+                }
+            }
+            cnt += nq;
+        }
     }
 
 } //end of namespace
@@ -88,6 +88,49 @@ private:
     bool m_homogen_dealiasing;
     bool m_SingleMode;
     bool m_HalfMode;
+    /// Use the workspace and the fused element kernel (SOLVERINFO
+    /// FusedAdvection, default True), False selects the original path
+    bool m_fusedAdvection;
+
+    // Workspace, sized once in v_InitObject
+    Array<OneD, Array<OneD, NekDouble> > m_wsVelocity;
+    Array<OneD, Array<OneD, NekDouble> > m_wsAdvVel;
+    Array<OneD, NekDouble>               m_wsPhys;
+    Array<OneD, NekDouble>               m_wsGradZ;
+    // element scratch of the fused kernel
+    Array<OneD, NekDouble>               m_wsDeriv0;
+    Array<OneD, NekDouble>               m_wsDeriv1;
+    Array<OneD, NekDouble>               m_wsInterp;
+    Array<OneD, NekDouble>               m_wsAccum;
+
+    void InitWorkspace(
+        const Array<OneD, MultiRegions::ExpListSharedPtr> &pFields);
+
+    bool UseFusedKernel(
+        const int                                          ndim,
+        const Array<OneD, MultiRegions::ExpListSharedPtr> &fields) const;
+
+    void AdvectFused(
+        const int nConvectiveFields,
+        const Array<OneD, MultiRegions::ExpListSharedPtr> &fields,
+        const Array<OneD, Array<OneD, NekDouble> >        &advVel,
+        const Array<OneD, Array<OneD, NekDouble> >        &inarray,
+              Array<OneD, Array<OneD, NekDouble> >        &outarray);
+
+    void AdvectSeparate(
+        const int nConvectiveFields,
+        const Array<OneD, MultiRegions::ExpListSharedPtr> &fields,
+        const Array<OneD, Array<OneD, NekDouble> >        &advVel,
+        const Array<OneD, Array<OneD, NekDouble> >        &inarray,
+              Array<OneD, Array<OneD, NekDouble> >        &outarray);
+
+    void FusedPlaneAdvect(
+        const MultiRegions::ExpListSharedPtr &plane,
+        const int                             ndim,
+        const Array<OneD, const NekDouble>   &inarray,
+        const NekDouble * const              *advVel,
+        const NekDouble                      *gradZ,
+              NekDouble                      *outarray);
 };
     
     
@@ -0,0 +1,160 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File AsyncFieldWriter.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Background writer for fld output of ROM reconstructions
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./AsyncFieldWriter.h"
+#include <LibUtilities/BasicUtils/Timer.h>
+
+namespace Nektar
+{
+    AsyncFieldWriter::AsyncFieldWriter(
+        const LibUtilities::FieldIOSharedPtr &fld,
+        const int capacity)
+        : m_fld(fld),
+          m_capacity(capacity > 0 ? capacity : 1),
+          m_busy(false),
+          m_stop(false),
+          m_numQueued(0),
+          m_numWritten(0),
+          m_numStalls(0),
+          m_maxDepth(0),
+          m_sumDepth(0),
+          m_writeTime(0.0)
+    {
+        m_thread = boost::thread(&AsyncFieldWriter::Run, this);
+    }
+
+    AsyncFieldWriter::~AsyncFieldWriter()
+    {
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            m_stop = true;
+        }
+        m_notEmpty.notify_all();
+        // the worker drains the queue before leaving Run()
+        m_thread.join();
+    }
+
+    void AsyncFieldWriter::Push(
+        const std::string &outname,
+        std::vector<LibUtilities::FieldDefinitionsSharedPtr> &fielddefs,
+        std::vector<std::vector<NekDouble> > &fielddata,
+        const LibUtilities::FieldMetaDataMap &fieldinfomap)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        if (int(m_queue.size()) >= m_capacity)
+        {
+            ++m_numStalls;
+            while (int(m_queue.size()) >= m_capacity)
+            {
+                m_notFull.wait(lock);
+            }
+        }
+
+        m_queue.push_back(WriteJob());
+        WriteJob &job = m_queue.back();
+        job.m_outname      = outname;
+        job.m_fieldinfomap = fieldinfomap;
+        job.m_fielddefs.swap(fielddefs);
+        job.m_fielddata.swap(fielddata);
+
+        int depth   = m_queue.size();
+        m_maxDepth  = std::max(m_maxDepth, depth);
+        m_sumDepth += depth;
+        ++m_numQueued;
+
+        m_notEmpty.notify_one();
+    }
+
+    void AsyncFieldWriter::Flush()
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        while (!m_queue.empty() || m_busy)
+        {
+            m_idle.wait(lock);
+        }
+    }
+
+    void AsyncFieldWriter::Run()
+    {
+        LibUtilities::Timer timer;
+
+        while (true)
+        {
+            WriteJob job;
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                while (m_queue.empty() && !m_stop)
+                {
+                    m_notEmpty.wait(lock);
+                }
+                if (m_queue.empty())
+                {
+                    return;
+                }
+                job.m_outname = m_queue.front().m_outname;
+                job.m_fielddefs.swap(m_queue.front().m_fielddefs);
+                job.m_fielddata.swap(m_queue.front().m_fielddata);
+                job.m_fieldinfomap.swap(m_queue.front().m_fieldinfomap);
+                m_queue.pop_front();
+                m_busy = true;
+            }
+            m_notFull.notify_one();
+
+            timer.Start();
+            m_fld->Write(job.m_outname, job.m_fielddefs, job.m_fielddata,
+                         job.m_fieldinfomap);
+            timer.Stop();
+
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_busy = false;
+                ++m_numWritten;
+                m_writeTime += timer.TimePerTest(1);
+            }
+            m_idle.notify_all();
+        }
+    }
+
+    void AsyncFieldWriter::PrintStats(std::ostream &out) const
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        out << "AsyncFieldWriter: " << m_numWritten << " of " << m_numQueued
+            << " files written in " << m_writeTime << " s, queue capacity "
+            << m_capacity << ", max depth " << m_maxDepth << ", mean depth "
+            << (m_numQueued > 0 ? NekDouble(m_sumDepth) / m_numQueued : 0.0)
+            << ", producer stalls " << m_numStalls << std::endl;
+    }
+}
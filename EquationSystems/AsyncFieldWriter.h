@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File AsyncFieldWriter.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Background writer for fld output of ROM reconstructions
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_ASYNCFIELDWRITER_H
+#define NEKTAR_SOLVERS_ASYNCFIELDWRITER_H
+
+#include <LibUtilities/BasicUtils/FieldIO.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <deque>
+#include <iostream>
+
+namespace Nektar
+{
+    class AsyncFieldWriter;
+    typedef boost::shared_ptr<AsyncFieldWriter> AsyncFieldWriterSharedPtr;
+
+    /**
+     * Writes fld files on a worker thread so that the online phase does not
+     * wait on the file system. The field definitions and the packed
+     * coefficient data are handed over with Push(), which swaps them into a
+     * bounded queue; the caller's vectors are left empty. The worker issues
+     * exactly the same FieldIO::Write call as EquationSystem::WriteFld, so
+     * the files are identical to the synchronous path.
+     *
+     * FieldIO::Write is collective in parallel runs, hence this class is only
+     * meant to be used on a single rank.
+     */
+    class AsyncFieldWriter
+    {
+    public:
+        AsyncFieldWriter(const LibUtilities::FieldIOSharedPtr &fld,
+                         const int capacity = 8);
+
+        ~AsyncFieldWriter();
+
+        /// Queue one file, blocks while the queue is full.
+        void Push(const std::string &outname,
+                  std::vector<LibUtilities::FieldDefinitionsSharedPtr> &fielddefs,
+                  std::vector<std::vector<NekDouble> > &fielddata,
+                  const LibUtilities::FieldMetaDataMap &fieldinfomap);
+
+        /// Block until every queued file has been written.
+        void Flush();
+
+        void PrintStats(std::ostream &out) const;
+
+    protected:
+        struct WriteJob
+        {
+            std::string                                          m_outname;
+            std::vector<LibUtilities::FieldDefinitionsSharedPtr> m_fielddefs;
+            std::vector<std::vector<NekDouble> >                 m_fielddata;
+            LibUtilities::FieldMetaDataMap                       m_fieldinfomap;
+        };
+
+        void Run();
+
+        LibUtilities::FieldIOSharedPtr      m_fld;
+        int                                 m_capacity;
+        std::deque<WriteJob>                m_queue;
+        bool                                m_busy;
+        bool                                m_stop;
+
+        mutable boost::mutex                m_mutex;
+        boost::condition_variable           m_notEmpty;
+        boost::condition_variable           m_notFull;
+        boost::condition_variable           m_idle;
+        boost::thread                       m_thread;
+
+        // statistics
+        int                                 m_numQueued;
+        int                                 m_numWritten;
+        int                                 m_numStalls;
+        int                                 m_maxDepth;
+        long                                m_sumDepth;
+        NekDouble                           m_writeTime;
+    };
+}
+
+#endif
@@ -0,0 +1,365 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File CoupledElementBlocks.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Cached velocity independent element blocks of the coupled solver
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./CoupledElementBlocks.h"
+#include <LocalRegions/MatrixKey.h>
+#include <LocalRegions/Expansion.h>
+#include <LibUtilities/BLAS/Blas.hpp>
+
+namespace Nektar
+{
+    CoupledElementBlocks::CoupledElementBlocks()
+    {
+    }
+
+    bool CoupledElementBlocks::Enable(
+        const LibUtilities::SessionReaderSharedPtr &session,
+        const MultiRegions::ExpListSharedPtr &velocity,
+        const MultiRegions::ExpListSharedPtr &pressure,
+        const bool AddAdvectionTerms,
+        const NekDouble lambda,
+        const NekDouble lambda_imag,
+        const int nz_loc,
+        const int nvel)
+    {
+        // The Stokes blocks and the pressure coupling do not depend on the
+        // advection field, in the ROM setting keep them per element and only
+        // contract the element trilinear form with Advfield in each step.
+        bool enable = AddAdvectionTerms && (lambda == 0.0) && (nz_loc == 1) &&
+            (nvel == m_nvel) &&
+            (lambda_imag == NekConstants::kNekUnsetDouble);
+        if(enable && session->DefinesParameter("cache_element_blocks"))
+        {
+            enable = session->GetParameter("cache_element_blocks");
+        }
+        if(enable && !IsInitialised())
+        {
+            Initialise(velocity, pressure);
+        }
+        return enable;
+    }
+
+    void CoupledElementBlocks::ReportAssemblyTime(
+        const LibUtilities::SessionReaderSharedPtr &session,
+        const NekDouble time)
+    {
+        if(session->DefinesParameter("report_assembly_time") &&
+           session->GetParameter("report_assembly_time") &&
+           session->GetComm()->GetRank() == 0)
+        {
+            std::cout << "Matrix Setup Costs: " << time << std::endl;
+        }
+    }
+
+    void CoupledElementBlocks::Initialise(
+        const MultiRegions::ExpListSharedPtr &velocity,
+        const MultiRegions::ExpListSharedPtr &pressure)
+    {
+        int  n, i, j, m, q;
+        int  nel = velocity->GetNumElmts();
+        int  maxcoeffs = 0;
+        int  maxphys   = 0;
+        Array<OneD, NekDouble> tmp;
+
+        m_blocks = Array<OneD, ElementBlocks>(nel);
+
+        for(n = 0; n < nel; ++n)
+        {
+            int eid = velocity->GetOffset_Elmt_Id(n);
+            ElementBlocks &e = m_blocks[n];
+
+            e.locExp = velocity->GetExp(eid);
+            e.locExp->GetBoundaryMap(e.bmap);
+            e.locExp->GetInteriorMap(e.imap);
+            e.ncoeffs     = e.locExp->GetNcoeffs();
+            e.nphys       = e.locExp->GetTotPoints();
+            e.phys_offset = velocity->GetPhys_Offset(eid);
+
+            int ncoeffs = e.ncoeffs;
+            int nphys   = e.nphys;
+            int nbmap   = e.bmap.num_elements();
+            int nimap   = e.imap.num_elements();
+            int psize   = pressure->GetExp(eid)->GetNcoeffs();
+
+            maxcoeffs = std::max(maxcoeffs, ncoeffs);
+            maxphys   = std::max(maxphys, nphys);
+
+            // velocity matrix, lambda = 0
+            StdRegions::ConstFactorMap factors;
+            factors[StdRegions::eFactorLambda] = 0.0;
+            LocalRegions::MatrixKey helmkey(StdRegions::eHelmholtz,
+                                            e.locExp->DetShapeType(),
+                                            *e.locExp,
+                                            factors);
+            DNekScalMat &HelmMat = *(e.locExp->as<LocalRegions::Expansion>()
+                                     ->GetLocMatrix(helmkey));
+            ASSERTL1(HelmMat.GetRows() == ncoeffs,
+                     "Unexpected size of elemental Helmholtz matrix");
+            Array<OneD, const NekDouble> HelmMat_data =
+                HelmMat.GetOwnedMatrix()->GetPtr();
+            e.helm = Array<OneD, NekDouble>(ncoeffs*ncoeffs);
+            Vmath::Smul(ncoeffs*ncoeffs, HelmMat.Scale(),
+                        &HelmMat_data[0], 1, &e.helm[0], 1);
+
+            // basis and its derivatives at the quadrature points
+            Array<OneD, NekDouble> coeffs(ncoeffs);
+            e.basis = Array<OneD, NekDouble>(nphys*ncoeffs);
+            e.deriv = Array<OneD, Array<OneD, NekDouble> >(m_nvel);
+            for(j = 0; j < m_nvel; ++j)
+            {
+                e.deriv[j] = Array<OneD, NekDouble>(nphys*ncoeffs);
+            }
+
+            for(m = 0; m < ncoeffs; ++m)
+            {
+                Vmath::Zero(ncoeffs, coeffs, 1);
+                coeffs[m] = 1.0;
+                e.locExp->BwdTrans(coeffs, tmp = e.basis + m*nphys);
+                for(j = 0; j < m_nvel; ++j)
+                {
+                    e.locExp->PhysDeriv(MultiRegions::DirCartesianMap[j],
+                                        e.basis + m*nphys,
+                                        tmp = e.deriv[j] + m*nphys);
+                }
+            }
+
+            // inner product with respect to the basis as a matrix
+            Array<OneD, NekDouble> phys(nphys);
+            e.iprod = Array<OneD, NekDouble>(ncoeffs*nphys);
+            for(q = 0; q < nphys; ++q)
+            {
+                Vmath::Zero(nphys, phys, 1);
+                phys[q] = 1.0;
+                e.locExp->IProductWRTBase(phys, tmp = e.iprod + q*ncoeffs);
+            }
+
+            // pressure coupling, column major as in SetUpCoupledMatrix
+            Array<OneD, NekDouble> pcoeffs(psize);
+            e.Dbnd = MemoryManager<DNekMat>::AllocateSharedPtr(
+                psize, m_nvel*nbmap, 0.0);
+            e.Dint = MemoryManager<DNekMat>::AllocateSharedPtr(
+                psize, m_nvel*nimap, 0.0);
+            for(i = 0; i < nbmap; ++i)
+            {
+                for(j = 0; j < m_nvel; ++j)
+                {
+                    pressure->GetExp(eid)->IProductWRTBase(
+                        e.deriv[j] + e.bmap[i]*nphys, pcoeffs);
+                    Blas::Dcopy(psize, &pcoeffs[0], 1,
+                                e.Dbnd->GetRawPtr() + (j*nbmap + i)*psize, 1);
+                }
+            }
+            for(i = 0; i < nimap; ++i)
+            {
+                for(j = 0; j < m_nvel; ++j)
+                {
+                    pressure->GetExp(eid)->IProductWRTBase(
+                        e.deriv[j] + e.imap[i]*nphys, pcoeffs);
+                    Blas::Dcopy(psize, &pcoeffs[0], 1,
+                                e.Dint->GetRawPtr() + (j*nimap + i)*psize, 1);
+                }
+            }
+        }
+
+        m_wsp  = Array<OneD, NekDouble>(maxphys*maxcoeffs);
+        m_form = Array<OneD, NekDouble>(maxcoeffs*maxcoeffs);
+        m_grad = Array<OneD, NekDouble>(maxphys);
+    }
+
+    void CoupledElementBlocks::Assemble(
+        const int n,
+        const NekDouble kinvis,
+        const Array<OneD, Array<OneD, NekDouble> > &Advfield,
+        const bool IsLinearNSEquation,
+        DNekMat &Ah,
+        DNekMat &B,
+        DNekMat &C,
+        DNekMat &D,
+        DNekMat &Dbnd,
+        DNekMat &Dint)
+    {
+        const ElementBlocks &e = m_blocks[n];
+        int  i, j, k, c, nv;
+        int  ncoeffs = e.ncoeffs;
+        int  nphys   = e.nphys;
+        int  nbmap   = e.bmap.num_elements();
+        int  nimap   = e.imap.num_elements();
+        int  nbndry  = m_nvel*nbmap;
+        int  nint    = m_nvel*nimap;
+        int  AhRows  = Ah.GetRows();
+
+        NekDouble *Ah_data = Ah.GetRawPtr();
+        NekDouble *B_data  = B.GetRawPtr();
+        NekDouble *C_data  = C.GetRawPtr();
+        NekDouble *D_data  = D.GetRawPtr();
+        const NekDouble *H = e.helm.get();
+        NekDouble *wsp     = m_wsp.get();
+        NekDouble *F       = m_form.get();
+
+        // Stokes part, identical for every velocity component
+        for(k = 0; k < m_nvel; ++k)
+        {
+            for(i = 0; i < nbmap; ++i)
+            {
+                for(j = 0; j < nbmap; ++j)
+                {
+                    Ah_data[i+k*nbmap + (j+k*nbmap)*AhRows] +=
+                        kinvis*H[e.bmap[i] + ncoeffs*e.bmap[j]];
+                }
+                for(j = 0; j < nimap; ++j)
+                {
+                    B_data[i+k*nbmap + (j+k*nimap)*nbndry] +=
+                        kinvis*H[e.bmap[i] + ncoeffs*e.imap[j]];
+                }
+            }
+            for(i = 0; i < nimap; ++i)
+            {
+                for(j = 0; j < nbmap; ++j) // C set up as transpose
+                {
+                    C_data[j+k*nbmap + (i+k*nimap)*nbndry] +=
+                        kinvis*H[e.imap[i] + ncoeffs*e.bmap[j]];
+                }
+                for(j = 0; j < nimap; ++j)
+                {
+                    D_data[i+k*nimap + (j+k*nimap)*nint] +=
+                        kinvis*H[e.imap[i] + ncoeffs*e.imap[j]];
+                }
+            }
+        }
+
+        Vmath::Vcopy(e.Dbnd->GetRows()*e.Dbnd->GetColumns(),
+                     e.Dbnd->GetRawPtr(), 1, Dbnd.GetRawPtr(), 1);
+        Vmath::Vcopy(e.Dint->GetRows()*e.Dint->GetColumns(),
+                     e.Dint->GetRawPtr(), 1, Dint.GetRawPtr(), 1);
+
+        // U . Grad u' terms: contract the trilinear form with Advfield
+        for(c = 0; c < ncoeffs; ++c)
+        {
+            Vmath::Vmul(nphys, &Advfield[0][e.phys_offset], 1,
+                        &e.deriv[0][c*nphys], 1, wsp + c*nphys, 1);
+            for(k = 1; k < m_nvel; ++k)
+            {
+                Vmath::Vvtvp(nphys, &Advfield[k][e.phys_offset], 1,
+                             &e.deriv[k][c*nphys], 1,
+                             wsp + c*nphys, 1, wsp + c*nphys, 1);
+            }
+        }
+        Blas::Dgemm('N', 'N', ncoeffs, ncoeffs, nphys, 1.0,
+                    e.iprod.get(), ncoeffs, wsp, nphys, 0.0, F, ncoeffs);
+
+        for(i = 0; i < nbmap; ++i)
+        {
+            const NekDouble *Fc = F + e.bmap[i]*ncoeffs;
+            for(nv = 0; nv < m_nvel; ++nv)
+            {
+                for(j = 0; j < nbmap; ++j)
+                {
+                    Ah_data[j+nv*nbmap + (i+nv*nbmap)*AhRows] += Fc[e.bmap[j]];
+                }
+                for(j = 0; j < nimap; ++j)
+                {
+                    C_data[i+nv*nbmap + (j+nv*nimap)*nbndry] += Fc[e.imap[j]];
+                }
+            }
+        }
+        for(i = 0; i < nimap; ++i)
+        {
+            const NekDouble *Fc = F + e.imap[i]*ncoeffs;
+            for(nv = 0; nv < m_nvel; ++nv)
+            {
+                for(j = 0; j < nbmap; ++j)
+                {
+                    B_data[j+nv*nbmap + (i+nv*nimap)*nbndry] += Fc[e.bmap[j]];
+                }
+                for(j = 0; j < nimap; ++j)
+                {
+                    D_data[j+nv*nimap + (i+nv*nimap)*nint] += Fc[e.imap[j]];
+                }
+            }
+        }
+
+        if(IsLinearNSEquation)
+        {
+            // u' . Grad U terms, one block per pair of components
+            Array<OneD, NekDouble> Advtmp;
+            for(k = 0; k < m_nvel; ++k)
+            {
+                for(nv = 0; nv < m_nvel; ++nv)
+                {
+                    e.locExp->PhysDeriv(MultiRegions::DirCartesianMap[nv],
+                                        Advtmp = Advfield[k] + e.phys_offset,
+                                        m_grad);
+                    for(c = 0; c < ncoeffs; ++c)
+                    {
+                        Vmath::Vmul(nphys, m_grad.get(), 1,
+                                    &e.basis[c*nphys], 1, wsp + c*nphys, 1);
+                    }
+                    Blas::Dgemm('N', 'N', ncoeffs, ncoeffs, nphys, 1.0,
+                                e.iprod.get(), ncoeffs, wsp, nphys, 0.0,
+                                F, ncoeffs);
+
+                    for(i = 0; i < nbmap; ++i)
+                    {
+                        const NekDouble *Fc = F + e.bmap[i]*ncoeffs;
+                        for(j = 0; j < nbmap; ++j)
+                        {
+                            Ah_data[j+k*nbmap + (i+nv*nbmap)*AhRows] +=
+                                Fc[e.bmap[j]];
+                        }
+                        for(j = 0; j < nimap; ++j)
+                        {
+                            C_data[i+nv*nbmap + (j+k*nimap)*nbndry] +=
+                                Fc[e.imap[j]];
+                        }
+                    }
+                    for(i = 0; i < nimap; ++i)
+                    {
+                        const NekDouble *Fc = F + e.imap[i]*ncoeffs;
+                        for(j = 0; j < nbmap; ++j)
+                        {
+                            B_data[j+k*nbmap + (i+nv*nimap)*nbndry] +=
+                                Fc[e.bmap[j]];
+                        }
+                        for(j = 0; j < nimap; ++j)
+                        {
+                            D_data[j+k*nimap + (i+nv*nimap)*nint] +=
+                                Fc[e.imap[j]];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File CoupledElementBlocks.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Cached velocity independent element blocks of the coupled solver
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_COUPLEDELEMENTBLOCKS_H
+#define NEKTAR_SOLVERS_COUPLEDELEMENTBLOCKS_H
+
+#include <MultiRegions/ExpList.h>
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <LibUtilities/LinearAlgebra/NekTypeDefs.hpp>
+
+namespace Nektar
+{
+    /**
+     * Element level data of the coupled Oseen/linearised NS matrix that does
+     * not depend on the advection field: the Helmholtz matrix, the pressure
+     * coupling blocks Dbnd/Dint and the matrix form of the basis, its
+     * derivatives and the inner product at the quadrature points. With
+     * these the advection blocks become a contraction of the element
+     * trilinear form with the current velocity,
+     *
+     * \f$ N_{ji} = \sum_q W_{jq} \left( U_k(x_q) \partial_k \phi_i(x_q) \right) \f$,
+     *
+     * which is a single dense matrix product per element instead of one
+     * BwdTrans/PhysDeriv/IProductWRTBase sweep per mode.
+     *
+     * Only the case treated by the ROM solvers is supported: two velocity
+     * components, no homogeneous direction and lambda = 0.
+     */
+    class CoupledElementBlocks
+    {
+    public:
+        CoupledElementBlocks();
+
+        bool IsInitialised() const
+        {
+            return m_blocks.num_elements() > 0;
+        }
+
+        void Initialise(const MultiRegions::ExpListSharedPtr &velocity,
+                        const MultiRegions::ExpListSharedPtr &pressure);
+
+        /// True if the cached blocks apply to a SetUpCoupledMatrix call
+        /// with these arguments, building them on first use. The session
+        /// parameter cache_element_blocks = 0 disables the cache.
+        bool Enable(const LibUtilities::SessionReaderSharedPtr &session,
+                    const MultiRegions::ExpListSharedPtr &velocity,
+                    const MultiRegions::ExpListSharedPtr &pressure,
+                    const bool AddAdvectionTerms,
+                    const NekDouble lambda,
+                    const NekDouble lambda_imag,
+                    const int nz_loc,
+                    const int nvel);
+
+        /// Print the time of one matrix assembly on rank 0 if the session
+        /// sets report_assembly_time.
+        static void ReportAssemblyTime(
+            const LibUtilities::SessionReaderSharedPtr &session,
+            const NekDouble time);
+
+        /// Add the Stokes and advection contributions of element n to the
+        /// zero initialised blocks and copy the pressure coupling blocks.
+        void Assemble(const int n,
+                      const NekDouble kinvis,
+                      const Array<OneD, Array<OneD, NekDouble> > &Advfield,
+                      const bool IsLinearNSEquation,
+                      DNekMat &Ah,
+                      DNekMat &B,
+                      DNekMat &C,
+                      DNekMat &D,
+                      DNekMat &Dbnd,
+                      DNekMat &Dint);
+
+    protected:
+        struct ElementBlocks
+        {
+            StdRegions::StdExpansionSharedPtr locExp;
+            Array<OneD, unsigned int>         bmap;
+            Array<OneD, unsigned int>         imap;
+            int                               ncoeffs;
+            int                               nphys;
+            int                               phys_offset;
+            /// scaled Helmholtz matrix, ncoeffs x ncoeffs
+            Array<OneD, NekDouble>            helm;
+            /// basis at the quadrature points, nphys x ncoeffs
+            Array<OneD, NekDouble>            basis;
+            /// basis derivatives at the quadrature points, nphys x ncoeffs
+            Array<OneD, Array<OneD, NekDouble> > deriv;
+            /// inner product wrt the basis, ncoeffs x nphys
+            Array<OneD, NekDouble>            iprod;
+            DNekMatSharedPtr                  Dbnd;
+            DNekMatSharedPtr                  Dint;
+        };
+
+        static const int m_nvel = 2;
+
+        Array<OneD, ElementBlocks> m_blocks;
+
+        // workspace reused between elements
+        Array<OneD, NekDouble> m_wsp;
+        Array<OneD, NekDouble> m_form;
+        Array<OneD, NekDouble> m_grad;
+    };
+}
+
+#endif
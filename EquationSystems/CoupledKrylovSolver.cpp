@@ -0,0 +1,478 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File CoupledKrylovSolver.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Matrix-free Krylov solver for the coupled Oseen system
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./CoupledKrylovSolver.h"
+#include <LibUtilities/BasicUtils/Timer.h>
+#include <LibUtilities/BLAS/Blas.hpp>
+#include <boost/algorithm/string.hpp>
+
+namespace Nektar
+{
+    CoupledKrylovSolver::CoupledKrylovSolver(
+        const LibUtilities::SessionReaderSharedPtr &session)
+        : m_session(session),
+          m_nGlobal(0),
+          m_nDir(0),
+          m_numSolves(0),
+          m_lastIterations(0),
+          m_totalIterations(0),
+          m_totalInnerIterations(0),
+          m_lastResidual(0.0),
+          m_lastTime(0.0),
+          m_totalTime(0.0)
+    {
+        m_session->LoadParameter("krylov_tolerance",            m_tol,        1e-10);
+        m_session->LoadParameter("krylov_max_iterations",       m_maxIt,      1000);
+        m_session->LoadParameter("krylov_restart",              m_restart,    100);
+        m_session->LoadParameter("krylov_inner_tolerance",      m_innerTol,   1e-2);
+        m_session->LoadParameter("krylov_inner_max_iterations", m_innerMaxIt, 30);
+
+        int verbose;
+        m_session->LoadParameter("krylov_verbose", verbose, 0);
+        m_verbose = verbose && (m_session->GetComm()->GetRank() == 0);
+
+        m_useLSC = true;
+        if(m_session->DefinesSolverInfo("KrylovPreconditioner"))
+        {
+            std::string precon = m_session->GetSolverInfo("KrylovPreconditioner");
+            if(boost::iequals(precon, "None"))
+            {
+                m_useLSC = false;
+            }
+            else
+            {
+                ASSERTL0(boost::iequals(precon, "LSC"),
+                         "KrylovPreconditioner should be LSC or None");
+            }
+        }
+    }
+
+    void CoupledKrylovSolver::SetElementMatrix(
+        const int n,
+        const int nel,
+        const DNekMatSharedPtr &mat,
+        const int nvelrows)
+    {
+        if(m_elmtMat.num_elements() != nel)
+        {
+            m_elmtMat  = Array<OneD, DNekMatSharedPtr>(nel);
+            m_nVelRows = Array<OneD, int>(nel, 0);
+        }
+        m_elmtMat[n]  = mat;
+        m_nVelRows[n] = nvelrows;
+    }
+
+    void CoupledKrylovSolver::SetCondensedElementMatrix(
+        const int n,
+        const int nel,
+        const int nvelrows,
+        const DNekMat &Ah,
+        const DNekMat &BCinvDTint_m_DTbnd,
+        const DNekMat &DintCinvBTtilde_m_Dbnd,
+        const DNekMat &DintCinvDTint)
+    {
+        int i, j;
+        int psize = DintCinvDTint.GetRows();
+        DNekMatSharedPtr mat = MemoryManager<DNekMat>::AllocateSharedPtr(
+            nvelrows + psize, nvelrows + psize, 0.0);
+
+        for(i = 0; i < nvelrows; ++i)
+        {
+            for(j = 0; j < nvelrows; ++j)
+            {
+                (*mat)(i,j) = Ah(i,j);
+            }
+            for(j = 0; j < psize; ++j)
+            {
+                (*mat)(i,nvelrows+j) = BCinvDTint_m_DTbnd(i,j);
+                (*mat)(nvelrows+j,i) = DintCinvBTtilde_m_Dbnd(j,i);
+            }
+        }
+        for(i = 0; i < psize; ++i)
+        {
+            for(j = 0; j < psize; ++j)
+            {
+                (*mat)(nvelrows+i,nvelrows+j) = -DintCinvDTint(i,j);
+            }
+        }
+
+        SetElementMatrix(n, nel, mat, nvelrows);
+    }
+
+    void CoupledKrylovSolver::Initialise(
+        const CoupledLocalToGlobalC0ContMapSharedPtr &locToGloMap)
+    {
+        int n, i, offset;
+        int nel = m_elmtMat.num_elements();
+        int maxrows = 0;
+
+        m_nGlobal = locToGloMap->GetNumGlobalCoeffs();
+        m_nDir    = locToGloMap->GetNumGlobalDirBndCoeffs();
+        m_map     = locToGloMap->GetLocalToGlobalMap();
+        m_sign    = locToGloMap->GetLocalToGlobalSign();
+
+        m_velMask  = Array<OneD, NekDouble>(m_nGlobal, 0.0);
+        m_presMask = Array<OneD, NekDouble>(m_nGlobal, 0.0);
+        m_invDiagF = Array<OneD, NekDouble>(m_nGlobal, 0.0);
+
+        offset = 0;
+        for(n = 0; n < nel; ++n)
+        {
+            ASSERTL0(m_elmtMat[n], "Element matrix not set");
+            const DNekMat &E = *m_elmtMat[n];
+            int rows = E.GetRows();
+            maxrows = std::max(maxrows, rows);
+
+            for(i = 0; i < rows; ++i)
+            {
+                int gid = m_map[offset + i];
+                if(gid < m_nDir)
+                {
+                    continue;
+                }
+                if(i < m_nVelRows[n])
+                {
+                    m_velMask[gid]   = 1.0;
+                    m_invDiagF[gid] += E(i,i);
+                }
+                else
+                {
+                    m_presMask[gid] = 1.0;
+                }
+            }
+            offset += rows;
+        }
+
+        for(i = m_nDir; i < m_nGlobal; ++i)
+        {
+            if(m_velMask[i] > 0.0)
+            {
+                ASSERTL0(fabs(m_invDiagF[i]) > NekConstants::kNekZeroTol,
+                         "Zero diagonal entry in velocity block");
+                m_invDiagF[i] = 1.0/m_invDiagF[i];
+            }
+        }
+
+        m_locIn  = Array<OneD, NekDouble>(maxrows);
+        m_locOut = Array<OneD, NekDouble>(maxrows);
+        m_tmp1   = Array<OneD, NekDouble>(m_nGlobal);
+        m_tmp2   = Array<OneD, NekDouble>(m_nGlobal);
+        m_tmp3   = Array<OneD, NekDouble>(m_nGlobal);
+
+        if(m_lastSolution.num_elements() != m_nGlobal)
+        {
+            m_lastSolution = Array<OneD, NekDouble>(m_nGlobal, 0.0);
+        }
+    }
+
+    int CoupledKrylovSolver::Solve(
+        const Array<OneD, const NekDouble> &in,
+        Array<OneD, NekDouble> &out)
+    {
+        LibUtilities::Timer timer;
+        timer.Start();
+
+        // move the Dirichlet values to the right hand side
+        Array<OneD, NekDouble> rhs(m_nGlobal, 0.0);
+        Array<OneD, NekDouble> x  (m_nGlobal, 0.0);
+        Vmath::Vcopy(m_nDir, out, 1, x, 1);
+        GlobalMultiply(x, rhs);
+        Vmath::Vsub(m_nGlobal, in, 1, rhs, 1, rhs, 1);
+        Vmath::Zero(m_nDir, rhs, 1);
+
+        // the previous solution is a good start in a Picard sequence
+        Vmath::Zero(m_nDir, x, 1);
+        Vmath::Vcopy(m_nGlobal - m_nDir, &m_lastSolution[m_nDir], 1,
+                     &x[m_nDir], 1);
+
+        int innerStart = m_totalInnerIterations;
+        m_lastIterations = GMRES(eCoupled, rhs, x, m_tol, m_maxIt,
+                                 m_lastResidual);
+
+        Vmath::Vcopy(m_nGlobal - m_nDir, &x[m_nDir], 1, &out[m_nDir], 1);
+        Vmath::Vcopy(m_nGlobal, x, 1, m_lastSolution, 1);
+
+        timer.Stop();
+        m_lastTime         = timer.TimePerTest(1);
+        m_totalTime       += m_lastTime;
+        m_totalIterations += m_lastIterations;
+        ++m_numSolves;
+
+        if(m_verbose)
+        {
+            std::cout << "Krylov coupled solve: " << m_lastIterations
+                      << " iterations (" << m_totalInnerIterations - innerStart
+                      << " inner), relative residual " << m_lastResidual
+                      << ", time " << m_lastTime << " s (" << m_totalIterations
+                      << " iterations in " << m_numSolves << " solves, "
+                      << m_totalTime << " s)" << std::endl;
+        }
+
+        if(m_lastIterations >= m_maxIt &&
+           m_session->GetComm()->GetRank() == 0)
+        {
+            std::cout << "Krylov coupled solve did not reach krylov_tolerance "
+                      << m_tol << std::endl;
+        }
+
+        return m_lastIterations;
+    }
+
+    /**
+     * out = sum_e A_e^T E_e A_e in, including the Dirichlet dofs.
+     */
+    void CoupledKrylovSolver::GlobalMultiply(
+        const Array<OneD, const NekDouble> &in,
+        Array<OneD, NekDouble> &out)
+    {
+        int n, i, offset = 0;
+        int nel = m_elmtMat.num_elements();
+
+        Vmath::Zero(m_nGlobal, out, 1);
+
+        for(n = 0; n < nel; ++n)
+        {
+            const DNekMat &E = *m_elmtMat[n];
+            int rows = E.GetRows();
+
+            for(i = 0; i < rows; ++i)
+            {
+                m_locIn[i] = m_sign[offset+i]*in[m_map[offset+i]];
+            }
+
+            Blas::Dgemv('N', rows, rows, 1.0, E.GetRawPtr(), rows,
+                        &m_locIn[0], 1, 0.0, &m_locOut[0], 1);
+
+            for(i = 0; i < rows; ++i)
+            {
+                out[m_map[offset+i]] += m_sign[offset+i]*m_locOut[i];
+            }
+            offset += rows;
+        }
+    }
+
+    void CoupledKrylovSolver::ApplyOperator(
+        const OperatorType op,
+        const Array<OneD, const NekDouble> &in,
+        Array<OneD, NekDouble> &out)
+    {
+        switch(op)
+        {
+            case eCoupled:
+            {
+                GlobalMultiply(in, out);
+                Vmath::Zero(m_nDir, out, 1);
+                break;
+            }
+            case eCommutator:
+            {
+                // L p = B D^{-1} B^T p + C p
+                GlobalMultiply(in, m_tmp1);
+                Vmath::Vmul(m_nGlobal, m_invDiagF, 1, m_tmp1, 1, m_tmp2, 1);
+                Vmath::Vmul(m_nGlobal, m_velMask, 1, m_tmp2, 1, m_tmp2, 1);
+                GlobalMultiply(m_tmp2, m_tmp3);
+                Vmath::Vsub(m_nGlobal, m_tmp3, 1, m_tmp1, 1, out, 1);
+                Vmath::Vmul(m_nGlobal, m_presMask, 1, out, 1, out, 1);
+                break;
+            }
+        }
+    }
+
+    void CoupledKrylovSolver::Precondition(
+        const OperatorType op,
+        const Array<OneD, const NekDouble> &in,
+        Array<OneD, NekDouble> &out)
+    {
+        if(op == eCommutator || !m_useLSC)
+        {
+            Vmath::Vcopy(m_nGlobal, in, 1, out, 1);
+            return;
+        }
+
+        NekDouble resnorm;
+        Array<OneD, NekDouble> rp(m_nGlobal);
+        Array<OneD, NekDouble> p (m_nGlobal, 0.0);
+        Array<OneD, NekDouble> a (m_nGlobal);
+        Array<OneD, NekDouble> b (m_nGlobal);
+
+        // pressure: p = -L^{-1} (B D^{-1} F D^{-1} B^T + C) L^{-1} r_p
+        Vmath::Vmul(m_nGlobal, m_presMask, 1, in, 1, rp, 1);
+        m_totalInnerIterations +=
+            GMRES(eCommutator, rp, p, m_innerTol, m_innerMaxIt, resnorm);
+
+        GlobalMultiply(p, a);
+        Vmath::Vmul(m_nGlobal, m_invDiagF, 1, a, 1, b, 1);
+        Vmath::Vmul(m_nGlobal, m_velMask,  1, b, 1, b, 1);
+        GlobalMultiply(b, rp);
+        Vmath::Vmul(m_nGlobal, m_invDiagF, 1, rp, 1, b, 1);
+        Vmath::Vmul(m_nGlobal, m_velMask,  1, b, 1, b, 1);
+        GlobalMultiply(b, rp);
+        Vmath::Vsub(m_nGlobal, rp, 1, a, 1, rp, 1);
+        Vmath::Vmul(m_nGlobal, m_presMask, 1, rp, 1, rp, 1);
+
+        Vmath::Zero(m_nGlobal, p, 1);
+        m_totalInnerIterations +=
+            GMRES(eCommutator, rp, p, m_innerTol, m_innerMaxIt, resnorm);
+        Vmath::Neg(m_nGlobal, p, 1);
+
+        // velocity: u = D^{-1} (r_u - B^T p)
+        GlobalMultiply(p, a);
+        Vmath::Vsub(m_nGlobal, in, 1, a, 1, a, 1);
+        Vmath::Vmul(m_nGlobal, m_invDiagF, 1, a, 1, out, 1);
+        Vmath::Vmul(m_nGlobal, m_velMask,  1, out, 1, out, 1);
+
+        Vmath::Vadd(m_nGlobal, out, 1, p, 1, out, 1);
+    }
+
+    /**
+     * Restarted right preconditioned flexible GMRES. x holds the initial
+     * guess on entry, resnorm returns the final relative residual.
+     */
+    int CoupledKrylovSolver::GMRES(
+        const OperatorType op,
+        const Array<OneD, const NekDouble> &rhs,
+        Array<OneD, NekDouble> &x,
+        const NekDouble tol,
+        const int maxit,
+        NekDouble &resnorm)
+    {
+        int i, j, k;
+        int m = std::max(1, std::min(m_restart, maxit));
+        int iter = 0;
+
+        NekDouble bnorm = sqrt(Vmath::Dot(m_nGlobal, rhs, 1, rhs, 1));
+        if(bnorm == 0.0)
+        {
+            Vmath::Zero(m_nGlobal, x, 1);
+            resnorm = 0.0;
+            return 0;
+        }
+
+        std::vector<Array<OneD, NekDouble> > V(m+1);
+        std::vector<Array<OneD, NekDouble> > Z(m);
+        for(i = 0; i < m+1; ++i)
+        {
+            V[i] = Array<OneD, NekDouble>(m_nGlobal);
+        }
+        for(i = 0; i < m; ++i)
+        {
+            Z[i] = Array<OneD, NekDouble>(m_nGlobal);
+        }
+        std::vector<NekDouble> H((m+1)*m, 0.0);
+        std::vector<NekDouble> cs(m), sn(m), g(m+1), y(m);
+        Array<OneD, NekDouble> r(m_nGlobal);
+
+        ApplyOperator(op, x, r);
+        Vmath::Vsub(m_nGlobal, rhs, 1, r, 1, r, 1);
+        NekDouble beta = sqrt(Vmath::Dot(m_nGlobal, r, 1, r, 1));
+        resnorm = beta/bnorm;
+
+        while(resnorm > tol && iter < maxit)
+        {
+            Vmath::Smul(m_nGlobal, 1.0/beta, r, 1, V[0], 1);
+            std::fill(g.begin(), g.end(), 0.0);
+            g[0] = beta;
+
+            for(j = 0; j < m && iter < maxit; )
+            {
+                Precondition(op, V[j], Z[j]);
+                ApplyOperator(op, Z[j], V[j+1]);
+
+                // modified Gram-Schmidt
+                for(i = 0; i <= j; ++i)
+                {
+                    H[i + j*(m+1)] = Vmath::Dot(m_nGlobal, V[j+1], 1, V[i], 1);
+                    Vmath::Svtvp(m_nGlobal, -H[i + j*(m+1)], V[i], 1,
+                                 V[j+1], 1, V[j+1], 1);
+                }
+                NekDouble hnorm = sqrt(Vmath::Dot(m_nGlobal, V[j+1], 1,
+                                                  V[j+1], 1));
+                H[j+1 + j*(m+1)] = hnorm;
+                if(hnorm > 0.0)
+                {
+                    Vmath::Smul(m_nGlobal, 1.0/hnorm, V[j+1], 1, V[j+1], 1);
+                }
+
+                // apply previous rotations and compute the new one
+                for(i = 0; i < j; ++i)
+                {
+                    NekDouble h0 = H[i   + j*(m+1)];
+                    NekDouble h1 = H[i+1 + j*(m+1)];
+                    H[i   + j*(m+1)] =  cs[i]*h0 + sn[i]*h1;
+                    H[i+1 + j*(m+1)] = -sn[i]*h0 + cs[i]*h1;
+                }
+                NekDouble h0 = H[j   + j*(m+1)];
+                NekDouble h1 = H[j+1 + j*(m+1)];
+                NekDouble den = sqrt(h0*h0 + h1*h1);
+                cs[j] = (den > 0.0) ? h0/den : 1.0;
+                sn[j] = (den > 0.0) ? h1/den : 0.0;
+                H[j   + j*(m+1)] = den;
+                H[j+1 + j*(m+1)] = 0.0;
+                g[j+1] = -sn[j]*g[j];
+                g[j]   =  cs[j]*g[j];
+
+                ++j;
+                ++iter;
+                resnorm = fabs(g[j])/bnorm;
+                if(resnorm <= tol || hnorm == 0.0)
+                {
+                    break;
+                }
+            }
+
+            // back substitution and update with the preconditioned basis
+            for(i = j-1; i >= 0; --i)
+            {
+                y[i] = g[i];
+                for(k = i+1; k < j; ++k)
+                {
+                    y[i] -= H[i + k*(m+1)]*y[k];
+                }
+                y[i] /= H[i + i*(m+1)];
+            }
+            for(i = 0; i < j; ++i)
+            {
+                Vmath::Svtvp(m_nGlobal, y[i], Z[i], 1, x, 1, x, 1);
+            }
+
+            ApplyOperator(op, x, r);
+            Vmath::Vsub(m_nGlobal, rhs, 1, r, 1, r, 1);
+            beta    = sqrt(Vmath::Dot(m_nGlobal, r, 1, r, 1));
+            resnorm = beta/bnorm;
+        }
+
+        return iter;
+    }
+}
@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File CoupledKrylovSolver.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Matrix-free Krylov solver for the coupled Oseen system
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_COUPLEDKRYLOVSOLVER_H
+#define NEKTAR_SOLVERS_COUPLEDKRYLOVSOLVER_H
+
+#include "./CoupledLocalToGlobalC0ContMap.h"
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <LibUtilities/LinearAlgebra/NekTypeDefs.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+namespace Nektar
+{
+    class CoupledKrylovSolver;
+    typedef boost::shared_ptr<CoupledKrylovSolver> CoupledKrylovSolverSharedPtr;
+
+    /**
+     * Alternative to the direct multi-level static condensation solve of the
+     * coupled velocity boundary / pressure system.
+     *
+     * The element matrices after the first level of static condensation
+     * (interior velocity eliminated)
+     *
+     * \f$ E_e = \left[ \begin{array}{cc} F_e & B^T_e \\ B_e & -C_e
+     *     \end{array} \right] \f$
+     *
+     * are kept per element and the global operator is applied matrix-free
+     * through the local to global map. The system is solved by restarted
+     * flexible GMRES, right preconditioned by the block upper triangular
+     * matrix [F B^T; 0 S] where the Schur complement is approximated by the
+     * least-squares commutator
+     *
+     * \f$ S^{-1} \approx -L^{-1} (B D^{-1} F D^{-1} B^T + C) L^{-1}, \quad
+     *     L = B D^{-1} B^T + C, \f$
+     *
+     * D = diag(F), and F^{-1} is replaced by D^{-1}. The L solves are done by
+     * a loosely converged inner GMRES.
+     *
+     * Session parameters: krylov_tolerance, krylov_max_iterations,
+     * krylov_restart, krylov_inner_tolerance, krylov_inner_max_iterations,
+     * krylov_verbose (1: print every solve on rank 0);
+     * solver info KrylovPreconditioner = LSC (default) or None.
+     */
+    class CoupledKrylovSolver
+    {
+    public:
+        CoupledKrylovSolver(const LibUtilities::SessionReaderSharedPtr &session);
+
+        /// Element matrix of element n, the first nvelrows rows/columns
+        /// are velocity boundary dofs followed by the pressure dofs.
+        void SetElementMatrix(const int n, const int nel,
+                              const DNekMatSharedPtr &mat,
+                              const int nvelrows);
+
+        /// Element matrix of element n assembled from the blocks left after
+        /// eliminating the interior velocity: [Ah, BCinvDTint_m_DTbnd;
+        /// DintCinvBTtilde_m_Dbnd, -DintCinvDTint].
+        void SetCondensedElementMatrix(const int n, const int nel,
+                                       const int nvelrows,
+                                       const DNekMat &Ah,
+                                       const DNekMat &BCinvDTint_m_DTbnd,
+                                       const DNekMat &DintCinvBTtilde_m_Dbnd,
+                                       const DNekMat &DintCinvDTint);
+
+        /// Called once all element matrices are set.
+        void Initialise(const CoupledLocalToGlobalC0ContMapSharedPtr &locToGloMap);
+
+        /// Same interface as GlobalLinSys::Solve: Dirichlet values are
+        /// taken from out, returns the number of outer iterations.
+        int Solve(const Array<OneD, const NekDouble> &in,
+                  Array<OneD, NekDouble> &out);
+
+    protected:
+        enum OperatorType
+        {
+            eCoupled,
+            eCommutator
+        };
+
+        LibUtilities::SessionReaderSharedPtr m_session;
+
+        NekDouble   m_tol;
+        int         m_maxIt;
+        int         m_restart;
+        NekDouble   m_innerTol;
+        int         m_innerMaxIt;
+        bool        m_useLSC;
+        bool        m_verbose;
+
+        Array<OneD, DNekMatSharedPtr> m_elmtMat;
+        Array<OneD, int>              m_nVelRows;
+
+        int                            m_nGlobal;
+        int                            m_nDir;
+        Array<OneD, const int>         m_map;
+        Array<OneD, const NekDouble>   m_sign;
+        /// 1 on free velocity dofs, 0 elsewhere
+        Array<OneD, NekDouble>         m_velMask;
+        /// 1 on free pressure dofs, 0 elsewhere
+        Array<OneD, NekDouble>         m_presMask;
+        /// inverse diagonal of the velocity block
+        Array<OneD, NekDouble>         m_invDiagF;
+        /// previous solution used as initial guess
+        Array<OneD, NekDouble>         m_lastSolution;
+
+        // workspace
+        Array<OneD, NekDouble>         m_locIn;
+        Array<OneD, NekDouble>         m_locOut;
+        Array<OneD, NekDouble>         m_tmp1;
+        Array<OneD, NekDouble>         m_tmp2;
+        Array<OneD, NekDouble>         m_tmp3;
+
+        // statistics
+        int         m_numSolves;
+        int         m_lastIterations;
+        int         m_totalIterations;
+        int         m_totalInnerIterations;
+        NekDouble   m_lastResidual;
+        NekDouble   m_lastTime;
+        NekDouble   m_totalTime;
+
+        void GlobalMultiply(const Array<OneD, const NekDouble> &in,
+                            Array<OneD, NekDouble> &out);
+
+        void ApplyOperator(const OperatorType op,
+                           const Array<OneD, const NekDouble> &in,
+                           Array<OneD, NekDouble> &out);
+
+        void Precondition(const OperatorType op,
+                          const Array<OneD, const NekDouble> &in,
+                          Array<OneD, NekDouble> &out);
+
+        int GMRES(const OperatorType op,
+                  const Array<OneD, const NekDouble> &rhs,
+                  Array<OneD, NekDouble> &x,
+                  const NekDouble tol,
+                  const int maxit,
+                  NekDouble &resnorm);
+    };
+}
+
+#endif
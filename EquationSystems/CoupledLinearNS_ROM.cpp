@@ -678,6 +678,8 @@ namespace Nektar
         ::AllocateSharedPtr(nsize_p_m1,nsize_p_m1,blkmatStorage);
         
         
+        bool UseElementBlocks = m_elementBlocks.Enable(m_session, m_fields[m_velocity[0]], m_pressure, AddAdvectionTerms, lambda, lambda_imag, nz_loc, nvel);
+
         Timer timer;
         timer.Start();
         for(n = 0; n < nel; ++n)
@@ -892,6 +894,18 @@ namespace Nektar
                     }
                 }
             }
+            else if(UseElementBlocks)
+            {
+                m_elementBlocks.Assemble(n, m_kinvis, Advfield, IsLinearNSEquation, *Ah, *B, *C, *D, *Dbnd, *Dint);
+
+                D->Invert();
+                (*B) = (*B)*(*D);
+                Blas::Dgemm('N','T', B->GetRows(), C->GetRows(), 
+                            B->GetColumns(), -1.0, B->GetRawPtr(),
+                            B->GetRows(), C->GetRawPtr(), 
+                            C->GetRows(), 1.0, 
+                            Ah->GetRawPtr(), Ah->GetRows());
+            }
             else
             {
                 // construct velocity matrices and pressure systems at
@@ -37,6 +37,7 @@
 #include "./CoupledLocalToGlobalC0ContMap.h"
 #include "./IncNavierStokes.h"
 #include "./CoupledLinearNS.h"
+#include "./CoupledElementBlocks.h"
 #include <MultiRegions/GlobalLinSys.h>
 #include <MultiRegions/ExpList3DHomogeneous1D.h>
 #include <MultiRegions/ExpList2D.h>
@@ -102,6 +103,7 @@ namespace Nektar
         NekDouble m_KinvisPercentage;
 
         Array<OneD, CoupledSolverMatrices> m_mat;
+        CoupledElementBlocks m_elementBlocks;
 
         void SetUpCoupledMatrix(const NekDouble lambda, 
                                 const Array< OneD, Array<OneD, NekDouble> > &Advfield, 
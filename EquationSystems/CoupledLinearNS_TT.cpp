@@ -170,6 +170,13 @@ namespace Nektar
                 m_advObject);
         }
 
+        // matrix-free Krylov alternative to the direct coupled solve
+        if(m_session->DefinesParameter("use_krylov_solver") && m_session->GetParameter("use_krylov_solver"))
+        {
+            ASSERTL0((m_HomogeneousType == eNotHomogeneous) && !m_singleMode, "use_krylov_solver is only available for 2D coupled solves");
+            m_krylovSolver = MemoryManager<CoupledKrylovSolver>::AllocateSharedPtr(m_session);
+        }
+
 
         int nel  = m_fields[0]->GetNumElmts();
 //        int n_vel  = m_fields.num_elements();
@@ -714,6 +721,10 @@ namespace Nektar
         ::AllocateSharedPtr(nsize_p_m1,nsize_p_m1,blkmatStorage);
         
         
+        bool UseElementBlocks = m_elementBlocks.Enable(m_session, m_fields[m_velocity[0]], m_pressure, AddAdvectionTerms, lambda, lambda_imag, nz_loc, nvel);
+
+        bool UseKrylov = m_krylovSolver && (nz_loc == 1);
+
         Timer timer;
         timer.Start();
         for(n = 0; n < nel; ++n)
@@ -944,6 +955,18 @@ namespace Nektar
                     }
                 }
             }
+            else if(UseElementBlocks)
+            {
+                m_elementBlocks.Assemble(n, m_kinvis, Advfield, IsLinearNSEquation, *Ah, *B, *C, *D, *Dbnd, *Dint);
+
+                D->Invert();
+                (*B) = (*B)*(*D);
+                Blas::Dgemm('N','T', B->GetRows(), C->GetRows(), 
+                            B->GetColumns(), -1.0, B->GetRawPtr(),
+                            B->GetRows(), C->GetRawPtr(), 
+                            C->GetRows(), 1.0, 
+                            Ah->GetRawPtr(), Ah->GetRows());
+            }
             else
             {
                 // construct velocity matrices and pressure systems at
@@ -1782,6 +1805,14 @@ namespace Nektar
             
             // This could be transpose of BCinvDint in some cases
             DintCinvBTtilde_m_Dbnd = (*Dint)*(*Cinv)*Transpose(*Btilde) - (*Dbnd); 
+
+            if(UseKrylov)
+            {
+                // keep the element matrix after the first level of static
+                // condensation, the Krylov solver applies it matrix-free
+                m_krylovSolver->SetCondensedElementMatrix(n,nel,nsize_bndry[n],*Ah,BCinvDTint_m_DTbnd,DintCinvBTtilde_m_Dbnd,DintCinvDTint);
+                continue;
+            }
             
             // Set up final set of matrices. 
             DNekMatSharedPtr Bh = MemoryManager<DNekMat>::AllocateSharedPtr(nsize_bndry_p1[n],nsize_p_m1[n],zero);
@@ -1880,7 +1911,7 @@ namespace Nektar
             pDh->SetBlock(n,n,loc_mat = MemoryManager<DNekScalMat>::AllocateSharedPtr(one,Dh));    
         }
         timer.Stop();
-//        cout << "Matrix Setup Costs: " << timer.TimePerTest(1) << endl;
+        CoupledElementBlocks::ReportAssemblyTime(m_session, timer.TimePerTest(1));
         
 	// end of the loop over the spectral elements
             
@@ -1906,6 +1937,12 @@ namespace Nektar
 //        cout << RB_D_adv << endl;
 //        cout << RB_D_no_adv << endl;
         
+        if(UseKrylov)
+        {
+            m_krylovSolver->Initialise(locToGloMap);
+            return;
+        }
+
         timer.Start();
         // Set up global coupled boundary solver. 
         // This is a key to define the solution matrix type
@@ -2344,7 +2381,21 @@ namespace Nektar
 	{
 //		cout << "bnd[i] " << i << " " << bnd[i] << std::endl;   
 	}
-        m_mat[mode].m_CoupledBndSys->Solve(fh_bnd,bnd,m_locToGloMap[mode]);                 // actual multi-static-condensed solve here
+        if(m_krylovSolver && (nz_loc == 1))
+        {
+            m_krylovSolver->Solve(fh_bnd,bnd);
+        }
+        else
+        {
+            Timer solvetimer;
+            solvetimer.Start();
+            m_mat[mode].m_CoupledBndSys->Solve(fh_bnd,bnd,m_locToGloMap[mode]);                 // actual multi-static-condensed solve here
+            solvetimer.Stop();
+            if(m_session->DefinesParameter("report_solve_time") && m_session->GetParameter("report_solve_time"))
+            {
+                cout << "Direct coupled solve: " << solvetimer.TimePerTest(1) << " s" << endl;
+            }
+        }
 
 /*	for(i = 0; i <  fh_bnd.num_elements(); ++i)
 	{
@@ -4716,54 +4767,8 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 
 
 */
-	Eigen::Matrix2d T;
-	if (elemT == 0) 
-	{
-		T << 1, 0, 0, 1/w;
-	}
-	else if (elemT == 1) 
-	{
-		T << 1, 0, 0, 2/(3-w);
-	}
-	else if (elemT == 2) 
-	{
-		T << 1, 0, -(1-w)/2, 1;
-	}
-	else if (elemT == 3) 
-	{
-		T << 1, 0, -(w-1)/2, 1;
-	}
-	else if (elemT == 4) 
-	{
-		T << 1, 0, 0, 1;
-	}
-
-//	cout << T << endl;
-
-	if (index == 0) 
-	{
-		return 1/(T(0,0)*T(1,1) - T(0,1)*T(1,0)); // 1/det
-	}
-	else if (index == 1) 
-	{
-		return T(0,0);
-	}
-	else if (index == 2) 
-	{
-		return T(0,1);
-	}
-	else if (index == 3) 
-	{
-		return T(1,0);
-	}
-	else if (index == 4) 
-	{
-		return T(1,1);
-	}
-
-	return 0;
-
-
+	// shared with the reduced model library, which has no access to this class
+	return ChannelGeometryMap(w, elemT, index);
     }
 
 
@@ -4808,6 +4813,7 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 			return i;
 		}
 	}
+	return -1;
     }
 
     Array<OneD, Array<OneD, NekDouble> > CoupledLinearNS_TT::trafo_current_para(Array<OneD, NekDouble> snapshot_x, Array<OneD, NekDouble> snapshot_y, Array<OneD, NekDouble> parameter_of_interest, Eigen::VectorXd & ref_f_bnd, Eigen::VectorXd & ref_f_p, Eigen::VectorXd & ref_f_int)
@@ -6275,11 +6281,46 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	fieldcoeffs[i] = Array<OneD, NekDouble>(m_fields[0]->GetNcoeffs(), 0.0);  
         variables[i] = "p"; 
 
-	WriteFld(filename,m_fields[0],fieldcoeffs,variables);
+	write_ROM_fld(filename,fieldcoeffs,variables);
 
     }
 
 
+    void CoupledLinearNS_TT::write_ROM_fld(const std::string &outname, std::vector<Array<OneD, NekDouble> > &fieldcoeffs, std::vector<std::string> &variables)
+    {
+	if (!m_asyncFieldWriter)
+	{
+		WriteFld(outname,m_fields[0],fieldcoeffs,variables);
+		return;
+	}
+
+	// pack the data as EquationSystem::WriteFld does, the packed copy is handed over to the writer thread
+	std::vector<LibUtilities::FieldDefinitionsSharedPtr> FieldDef = m_fields[0]->GetFieldDefinitions();
+	std::vector<std::vector<NekDouble> > FieldData(FieldDef.size());
+	for (int j = 0; j < fieldcoeffs.size(); ++j)
+	{
+		for (int i = 0; i < FieldDef.size(); ++i)
+		{
+			FieldDef[i]->m_fields.push_back(variables[j]);
+			m_fields[0]->AppendFieldData(FieldDef[i], FieldData[i], fieldcoeffs[j]);
+		}
+	}
+	if (m_fieldMetaDataMap.find("Time") != m_fieldMetaDataMap.end())
+	{
+		m_fieldMetaDataMap["Time"] = boost::lexical_cast<std::string>(m_time);
+	}
+	m_asyncFieldWriter->Push(outname, FieldDef, FieldData, m_fieldMetaDataMap);
+    }
+
+    void CoupledLinearNS_TT::finish_ROM_field_output()
+    {
+	if (m_asyncFieldWriter)
+	{
+		m_asyncFieldWriter->Flush();
+		m_asyncFieldWriter->PrintStats(cout);
+	}
+    }
+
     void CoupledLinearNS_TT::compute_snapshots_geometry_params()
     {
 	// generate matrices for affine form 
@@ -6818,13 +6859,22 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
     }
 
     int CoupledLinearNS_TT::find_closest_snapshot_location(Array<OneD, NekDouble> VV_point, Array<OneD, Array<OneD, NekDouble> > general_param_vector)
+    {
+	// elementary euclidean distances
+	return ParameterSampling::Closest(VV_point, general_param_vector);
+    }
+
+    int CoupledLinearNS_TT::find_closest_snapshot_location_l1(Array<OneD, NekDouble> VV_point, Array<OneD, Array<OneD, NekDouble> > general_param_vector)
     {
 	double min_distance;
-	double min_distance_index;
+	int min_distance_index;
 	for (int i = 0; i < general_param_vector.num_elements(); ++i)
 	{
-		// elementary euclidean distances
-		double distance = sqrt( (VV_point[0] - general_param_vector[i][0])*(VV_point[0] - general_param_vector[i][0]) + (VV_point[1] - general_param_vector[i][1])*(VV_point[1] - general_param_vector[i][1]) );
+		double distance = 0.0;
+		for (int k = 0; k < VV_point.num_elements(); ++k)
+		{
+			distance += fabs(VV_point[k] - general_param_vector[i][k]);
+		}
 		if (i == 0)
 		{
 			min_distance = distance;
@@ -6839,13 +6889,17 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	return min_distance_index;
     }
 
-    int CoupledLinearNS_TT::find_closest_snapshot_location_l1(Array<OneD, NekDouble> VV_point, Array<OneD, Array<OneD, NekDouble> > general_param_vector)
+    int CoupledLinearNS_TT::find_closest_snapshot_location_linf(Array<OneD, NekDouble> VV_point, Array<OneD, Array<OneD, NekDouble> > general_param_vector)
     {
 	double min_distance;
-	double min_distance_index;
+	int min_distance_index;
 	for (int i = 0; i < general_param_vector.num_elements(); ++i)
 	{
-		double distance = abs(VV_point[0] - general_param_vector[i][0]) + abs(VV_point[1] - general_param_vector[i][1]);
+		double distance = 0.0;
+		for (int k = 0; k < VV_point.num_elements(); ++k)
+		{
+			distance = max( distance, fabs(VV_point[k] - general_param_vector[i][k]) );
+		}
 		if (i == 0)
 		{
 			min_distance = distance;
@@ -6860,33 +6914,109 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	return min_distance_index;
     }
 
-    int CoupledLinearNS_TT::find_closest_snapshot_location_linf(Array<OneD, NekDouble> VV_point, Array<OneD, Array<OneD, NekDouble> > general_param_vector)
+    /**
+     * Fills general_param_vector from the sampler selected by
+     * parameter_sampling in the box given by param_min_dir<k> and
+     * param_max_dir<k>, k < parameter_space_dimension. The tensor grid uses
+     * number_of_snapshots_dir<k> points per direction, the Smolyak grid the
+     * level smolyak_level and the Latin hypercube number_of_snapshots points.
+     */
+    void CoupledLinearNS_TT::generate_parameter_samples()
     {
-	double min_distance;
-	double min_distance_index;
-	for (int i = 0; i < general_param_vector.num_elements(); ++i)
+	int dim = parameter_space_dimension;
+	Array<OneD, NekDouble> lower(dim), upper(dim);
+	for (int k = 0; k < dim; ++k)
 	{
-		std::vector<double> dist_vector = std::vector<double> (2);
-		dist_vector[0] = (VV_point[0] - general_param_vector[i][0]);
-		dist_vector[1] = (VV_point[1] - general_param_vector[i][1]);
-		double distance = max( dist_vector[0], dist_vector[1] );
-		if (i == 0)
+		std::stringstream sstm_min, sstm_max;
+		sstm_min << "param_min_dir" << k;
+		sstm_max << "param_max_dir" << k;
+		ASSERTL0(m_session->DefinesParameter(sstm_min.str()) && m_session->DefinesParameter(sstm_max.str()), "need " + sstm_min.str() + " and " + sstm_max.str() + " for the parameter sampling");
+		lower[k] = m_session->GetParameter(sstm_min.str());
+		upper[k] = m_session->GetParameter(sstm_max.str());
+	}
+
+	Array<OneD, Array<OneD, NekDouble> > samples;
+	switch (parameter_sampling)
+	{
+		case ParameterSampling::eTensor:
 		{
-			min_distance = distance;
-			min_distance_index = 0;
+			Array<OneD, int> npoints(dim);
+			for (int k = 0; k < dim; ++k)
+			{
+				std::stringstream sstm;
+				sstm << "number_of_snapshots_dir" << k;
+				npoints[k] = m_session->GetParameter(sstm.str());
+			}
+			samples = ParameterSampling::TensorGrid(lower, upper, npoints);
+			break;
 		}
-		else if (distance < min_distance)
+		case ParameterSampling::eSmolyak:
 		{
-			min_distance = distance;
-			min_distance_index = i;
+			int smolyak_level = m_session->GetParameter("smolyak_level");
+			samples = ParameterSampling::SmolyakGrid(lower, upper, smolyak_level);
+			break;
+		}
+		case ParameterSampling::eLatinHypercube:
+		{
+			int lhs_seed = 0;
+			if (m_session->DefinesParameter("lhs_seed"))
+			{
+				lhs_seed = m_session->GetParameter("lhs_seed");
+			}
+			int nsamples = use_non_unique_up_to_two ? Nmax/2 : Nmax;
+			samples = ParameterSampling::LatinHypercube(lower, upper, nsamples, lhs_seed);
+			break;
 		}
+		default:
+			ASSERTL0(false, "unknown parameter_sampling, use 0 (tensor), 1 (Smolyak) or 2 (Latin hypercube)");
 	}
-	return min_distance_index;
+
+	int nsamples = samples.num_elements();
+	// if there is set use_non_unique_up_to_two then double the param vector
+	Nmax = use_non_unique_up_to_two ? 2*nsamples : nsamples;
+	general_param_vector = Array<OneD, Array<OneD, NekDouble> > (Nmax);
+	for (int i = 0; i < Nmax; ++i)
+	{
+		general_param_vector[i] = Array<OneD, NekDouble> (dim);
+		Vmath::Vcopy(dim, samples[i % nsamples], 1, general_param_vector[i], 1);
+	}
+
+	param_lower = lower;
+	param_upper = upper;
+	// the (w, nu) bounds used by the 2D VV output
+	start_param_dir0 = lower[0];
+	end_param_dir0 = upper[0];
+	if (dim > 1)
+	{
+		start_param_dir1 = lower[1];
+		end_param_dir1 = upper[1];
+	}
+
+	// output sample grid as *.txt
+	ParameterSampling::Write("sample_grid.txt", samples);
+	cout << "parameter_sampling " << parameter_sampling << " generated " << nsamples << " samples in " << dim << " dimensions" << endl;
     }
 
     void CoupledLinearNS_TT::online_phase()
     {
+	if (sample_parameters_only)
+	{
+		return;
+	}
 	Eigen::MatrixXd mat_compare = Eigen::MatrixXd::Zero(f_bnd_dbc_full_size.rows(), 3);  // is of size M_truth_size
+	// the velocity of the RB modes costs RBsize backward transforms, only build it if it is used
+	bool qoi_requested = (qoi_dof >= 0) || (qoi_boundary_region >= 0) || qoi_use_region;
+	if (qoi_requested || write_reduced_model || reduced_only_VV_sweep())
+	{
+		gen_reduced_modes();
+	}
+	gen_reduced_qoi_functionals();
+	if (write_reduced_model && (parameter_space_dimension == 2))
+	{
+		// read by the session-free evaluation library in ROMLibrary
+		gen_reduced_model(Eigen::MatrixXd::Zero(RBsize, 2))->Save("ROM_reduced_model.txt");
+	}
+	Eigen::MatrixXd collected_reduced_qoi = Eigen::MatrixXd::Zero(Nmax, reduced_qoi.GetNumQoI());
 	// start sweeping 
 	for (int iter_index = 0; iter_index < Nmax; ++iter_index)
 	{
@@ -6937,6 +7067,15 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 
 		Eigen::VectorXd solve_affine = affine_mat_proj.colPivHouseholderQr().solve(affine_vec_proj);
 //		cout << "solve_affine " << solve_affine << endl;
+		collected_reduced_qoi.row(iter_index) = eval_reduced_qoi(solve_affine, (parameter_space_dimension == 2) ? w : 1.0).transpose();
+		if (skip_ROM_reconstruction)
+		{
+			if (qoi_dof >= 0)
+			{
+				cout << "reduced qoi " << collected_reduced_qoi(iter_index, qoi_dof_row) << " truth qoi " << snapshot_y_collection[current_index][qoi_dof] << " of snapshot number " << iter_index << endl;
+			}
+			continue;
+		}
 		Eigen::VectorXd repro_solve_affine = RB * solve_affine;
 		Eigen::VectorXd reconstruct_solution = reconstruct_solution_w_dbc(repro_solve_affine);
 		if (globally_connected == 1)
@@ -7098,6 +7237,29 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 
 	}
 
+	if (reduced_qoi.GetNumQoI() > 0)
+	{
+		ofstream myfile_qoi ("ROM_qoi_functionals.txt");
+		if (myfile_qoi.is_open())
+		{
+			for (int k = 0; k < reduced_qoi.GetNumQoI(); ++k)
+			{
+				myfile_qoi << reduced_qoi.m_names[k] << "\t";
+			}
+			myfile_qoi << "\n";
+			for (int i0 = 0; i0 < Nmax; i0++)
+			{
+				for (int k = 0; k < collected_reduced_qoi.cols(); ++k)
+				{
+					myfile_qoi << std::setprecision(17) << collected_reduced_qoi(i0,k) << "\t";
+				}
+				myfile_qoi << "\n";
+			}
+			myfile_qoi.close();
+		}
+		else cout << "Unable to open file"; 
+	}
+
 	if (compute_smaller_model_errs)
 	{
 		// repeat the parameter sweep with decreasing RB sizes up to 1, but in a separate function for readability
@@ -7135,6 +7297,26 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 		int fine_grid_dir0_index = 0;
 		int fine_grid_dir1_index = 0;
 		double locROM_qoi;
+		// the Oseen iteration and the qoi stay in the reduced space unless full fields are needed
+		bool reduced_only = reduced_only_VV_sweep();
+		Eigen::MatrixXd collected_reduced_qoi_VV = Eigen::MatrixXd::Zero(fine_grid_dir0*fine_grid_dir1, reduced_qoi.GetNumQoI());
+		Eigen::MatrixXd cluster_mean_proj = project_onto_basis(cluster_mean_x, cluster_mean_y);
+		if (reduced_only)
+		{
+			m_reducedModel = gen_reduced_model(cluster_mean_proj);
+			m_oseenKernel = m_reducedModel->CreateKernel();
+		}
+		Timer query_timer;
+		double query_time = 0.0;
+		// converged reduced solutions of earlier queries, returned on repeats and used as warm start nearby
+		if (online_cache_size > 0)
+		{
+			m_onlineCache = MemoryManager<OnlineQueryCache>::AllocateSharedPtr(online_cache_size, 1e-12, online_cache_warm_start_radius);
+			if (online_cache_persist)
+			{
+				m_onlineCache->Load("ROM_online_cache.txt", OnlineQueryCache::Signature(RB, param_lower, param_upper));
+			}
+		}
 		for (int iter_index = 0; iter_index < fine_grid_dir0*fine_grid_dir1; ++iter_index)
 		{
 //			cout << "fine_grid_iter_index " << iter_index << " of max " << fine_grid_dir0*fine_grid_dir1 << endl;
@@ -7150,56 +7332,123 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 //				cout << " VV online phase current w " << w << endl;
 			}
 			Set_m_kinvis( current_nu );
-			if (use_Newton)
+			query_timer.Start();
+			Eigen::VectorXd solve_affine;
+			OnlineQueryCache::LookupResult cache_result = OnlineQueryCache::eMiss;
+			if (m_onlineCache)
 			{
-				DoInitialiseAdv(cluster_mean_x, cluster_mean_y);
+				cache_result = m_onlineCache->Find(current_param, solve_affine);
 			}
-			Eigen::MatrixXd curr_xy_proj = project_onto_basis(cluster_mean_x, cluster_mean_y);
-			Eigen::MatrixXd affine_mat_proj;
-			Eigen::VectorXd affine_vec_proj;
-			affine_mat_proj = gen_affine_mat_proj_2d(current_nu, w);
-			affine_vec_proj = gen_affine_vec_proj_2d(current_nu, w, current_index);
-			Eigen::VectorXd solve_affine = affine_mat_proj.colPivHouseholderQr().solve(affine_vec_proj);
-			double relative_change_error;
-			int no_iter=0;
 			Array<OneD, double> field_x;
 			Array<OneD, double> field_y;
-			// now start looping
-			do
+			if (cache_result == OnlineQueryCache::eHit)
 			{
-				// for now only Oseen // otherwise need to do the DoInitialiseAdv(cluster_mean_x, cluster_mean_y);
-				Eigen::VectorXd prev_solve_affine = solve_affine;
-				Eigen::VectorXd repro_solve_affine = RB * solve_affine;
-				Eigen::VectorXd reconstruct_solution = reconstruct_solution_w_dbc(repro_solve_affine);
-
-				recover_snapshot_loop(reconstruct_solution, field_x, field_y);
-				if (use_Newton)
+				// the converged reduced solution is known, skip the iteration
+				if (!reduced_only)
 				{
-					DoInitialiseAdv(field_x, field_y);
+					Eigen::VectorXd repro_solve_affine = RB * solve_affine;
+					recover_snapshot_loop(reconstruct_solution_w_dbc(repro_solve_affine), field_x, field_y);
 				}
-				curr_xy_proj = project_onto_basis(field_x, field_y);
-				if (parameter_space_dimension == 1)
+			}
+			else
+			{
+				Eigen::MatrixXd curr_xy_proj;
+				if (cache_result == OnlineQueryCache::eWarmStart)
 				{
-					affine_mat_proj = gen_affine_mat_proj(current_nu);
-					affine_vec_proj = gen_affine_vec_proj(current_nu, current_index);
+					// linearise around the closest cached solution instead of the cluster mean
+					if (reduced_only)
+					{
+						curr_xy_proj = project_onto_basis_reduced(solve_affine);
+					}
+					else
+					{
+						Eigen::VectorXd repro_solve_affine = RB * solve_affine;
+						recover_snapshot_loop(reconstruct_solution_w_dbc(repro_solve_affine), field_x, field_y);
+						if (use_Newton)
+						{
+							DoInitialiseAdv(field_x, field_y);
+						}
+						curr_xy_proj = project_onto_basis(field_x, field_y);
+					}
 				}
-				else if (parameter_space_dimension == 2)
+				else
+				{
+					if (use_Newton)
+					{
+						DoInitialiseAdv(cluster_mean_x, cluster_mean_y);
+					}
+					curr_xy_projected = cluster_mean_proj;
+					curr_xy_proj = cluster_mean_proj;
+				}
+				int no_iter=0;
+				if (reduced_only)
+				{
+					// the geometry terms are summed once per query into the kernel, the iteration itself runs on the reduced operators only
+					solve_affine = m_reducedModel->Evaluate(current_param, curr_xy_proj, *m_oseenKernel, no_iter);
+				}
+				else
 				{
+					Eigen::MatrixXd affine_mat_proj;
+					Eigen::VectorXd affine_vec_proj;
 					affine_mat_proj = gen_affine_mat_proj_2d(current_nu, w);
 					affine_vec_proj = gen_affine_vec_proj_2d(current_nu, w, current_index);
+					solve_affine = affine_mat_proj.colPivHouseholderQr().solve(affine_vec_proj);
+					double relative_change_error;
+					// now start looping
+					do
+					{
+						// for now only Oseen // otherwise need to do the DoInitialiseAdv(cluster_mean_x, cluster_mean_y);
+						Eigen::VectorXd prev_solve_affine = solve_affine;
+						Eigen::VectorXd repro_solve_affine = RB * solve_affine;
+						Eigen::VectorXd reconstruct_solution = reconstruct_solution_w_dbc(repro_solve_affine);
+
+						recover_snapshot_loop(reconstruct_solution, field_x, field_y);
+						if (use_Newton)
+						{
+							DoInitialiseAdv(field_x, field_y);
+						}
+						curr_xy_proj = project_onto_basis(field_x, field_y);
+						if (parameter_space_dimension == 1)
+						{
+							affine_mat_proj = gen_affine_mat_proj(current_nu);
+							affine_vec_proj = gen_affine_vec_proj(current_nu, current_index);
+						}
+						else if (parameter_space_dimension == 2)
+						{
+							affine_mat_proj = gen_affine_mat_proj_2d(current_nu, w);
+							affine_vec_proj = gen_affine_vec_proj_2d(current_nu, w, current_index);
+						}
+						solve_affine = affine_mat_proj.colPivHouseholderQr().solve(affine_vec_proj);
+						relative_change_error = (solve_affine - prev_solve_affine).norm() / prev_solve_affine.norm();
+//						cout << "relative_change_error " << relative_change_error << endl;
+						no_iter++;
+					} 
+					while( ((relative_change_error > 1e-5) && (no_iter < 100)) );
+//					cout << "ROM solve no iters used " << no_iter << endl;
 				}
-				solve_affine = affine_mat_proj.colPivHouseholderQr().solve(affine_vec_proj);
-				relative_change_error = (solve_affine - prev_solve_affine).norm() / prev_solve_affine.norm();
-//				cout << "relative_change_error " << relative_change_error << endl;
-				no_iter++;
-			} 
-			while( ((relative_change_error > 1e-5) && (no_iter < 100)) );
-//			cout << "ROM solve no iters used " << no_iter << endl;
-			Eigen::VectorXd repro_solve_affine = RB * solve_affine;
-			Eigen::VectorXd reconstruct_solution = reconstruct_solution_w_dbc(repro_solve_affine);
-			if (write_ROM_field || (qoi_dof >= 0))
+				if (m_onlineCache)
+				{
+					m_onlineCache->Insert(current_param, solve_affine);
+				}
+			} // if (cache_result == OnlineQueryCache::eHit)
+			query_timer.Stop();
+			query_time += query_timer.TimePerTest(1);
+			collected_reduced_qoi_VV.row(iter_index) = eval_reduced_qoi(solve_affine, w).transpose();
+			if (reduced_only)
 			{
-				locROM_qoi = recover_snapshot_data(reconstruct_solution, 0);
+				if (qoi_dof >= 0)
+				{
+					locROM_qoi = collected_reduced_qoi_VV(iter_index, qoi_dof_row);
+				}
+			}
+			else
+			{
+				Eigen::VectorXd repro_solve_affine = RB * solve_affine;
+				Eigen::VectorXd reconstruct_solution = reconstruct_solution_w_dbc(repro_solve_affine);
+				if (write_ROM_field || (qoi_dof >= 0))
+				{
+					locROM_qoi = recover_snapshot_data(reconstruct_solution, 0);
+				}
 			}
 			collected_qoi(fine_grid_dir0_index, fine_grid_dir1_index) = locROM_qoi;
 			if (use_fine_grid_VV_and_load_ref)
@@ -7219,6 +7468,48 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 				fine_grid_dir0_index++;
 			}			
 		} // for (int iter_index = 0; iter_index < fine_grid_dir0*fine_grid_dir1; ++iter_index)
+		cout << "VV online phase: mean reduced solve time per query " << query_time / (fine_grid_dir0*fine_grid_dir1) << " s";
+		if (m_reducedModel)
+		{
+			cout << (m_reducedModel->IsFixedSize() ? " (fixed-size" : " (dynamic-size") << " reduced kernel, RBsize " << RBsize << ")";
+		}
+		cout << endl;
+		if (m_reducedModel && (reduced_model_threads > 0))
+		{
+			reduced_model_thread_check(reduced_model_threads);
+		}
+		if (m_onlineCache)
+		{
+			m_onlineCache->PrintStats(cout);
+			if (online_cache_persist)
+			{
+				m_onlineCache->Save("ROM_online_cache.txt", OnlineQueryCache::Signature(RB, param_lower, param_upper));
+			}
+		}
+		if (reduced_qoi.GetNumQoI() > 0)
+		{
+			ofstream myfile_qoi ("VV_ROM_qoi_functionals.txt");
+			if (myfile_qoi.is_open())
+			{
+				myfile_qoi << "w\tnu\t";
+				for (int k = 0; k < reduced_qoi.GetNumQoI(); ++k)
+				{
+					myfile_qoi << reduced_qoi.m_names[k] << "\t";
+				}
+				myfile_qoi << "\n";
+				for (int i0 = 0; i0 < fine_grid_dir0*fine_grid_dir1; i0++)
+				{
+					myfile_qoi << std::setprecision(17) << fine_general_param_vector[i0][0] << "\t" << fine_general_param_vector[i0][1] << "\t";
+					for (int k = 0; k < collected_reduced_qoi_VV.cols(); ++k)
+					{
+						myfile_qoi << std::setprecision(17) << collected_reduced_qoi_VV(i0,k) << "\t";
+					}
+					myfile_qoi << "\n";
+				}
+				myfile_qoi.close();
+			}
+			else cout << "Unable to open file"; 
+		}
 		std::stringstream sstm;
 		sstm << "VV_ROM_cluster.txt";
 		std::string LocROM_txt = sstm.str();
@@ -7816,9 +8107,11 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	}
 	else cout << "Unable to open file"; 
 
+	finish_ROM_field_output();
+
 	}
 
-    void CoupledLinearNS_TT::recover_snapshot_loop(Eigen::VectorXd reconstruct_solution, Array<OneD, double> & field_x, Array<OneD, double> & field_y)
+    void CoupledLinearNS_TT::recover_snapshot_loop(Eigen::VectorXd reconstruct_solution, Array<OneD, double> & field_x, Array<OneD, double> & field_y, bool write_field)
     {
 	Eigen::VectorXd f_bnd = reconstruct_solution.head(curr_f_bnd.size());
 	Eigen::VectorXd f_int = reconstruct_solution.tail(curr_f_int.size());
@@ -7966,9 +8259,12 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	fieldcoeffs[i] = Array<OneD, NekDouble>(m_fields[0]->GetNcoeffs(), 0.0);  
         variables[i] = "p"; 
 
-	if (write_ROM_field)
+	if (write_ROM_field && write_field)
 	{
-		WriteFld("Test.fld",m_fields[0],fieldcoeffs,variables);
+		// one file per reconstruction, queued jobs must not share a name
+		std::stringstream sstm;
+		sstm << "ROM_field_" << ROM_field_count++ << ".fld";
+		write_ROM_fld(sstm.str(),fieldcoeffs,variables);
 	}
 
 	if (qoi_dof >= 0)
@@ -8030,6 +8326,14 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	{
 		parameter_space_dimension = 1;
 	}
+	if (m_session->DefinesParameter("parameter_sampling")) // 0: tensor grid, 1: Smolyak sparse grid, 2: Latin hypercube
+	{
+		parameter_sampling = m_session->GetParameter("parameter_sampling");	
+	}
+	else
+	{
+		parameter_sampling = ParameterSampling::eTensor;
+	}
 	if (m_session->DefinesParameter("load_cO_snapshot_data_from_files")) 
 	{
 		load_cO_snapshot_data_from_files = m_session->GetParameter("load_cO_snapshot_data_from_files");	
@@ -8062,6 +8366,30 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	{
 		qoi_dof = -1;
 	}
+	if (m_session->DefinesParameter("skip_ROM_reconstruction")) // evaluate the qoi on the reduced coefficients only
+	{
+		skip_ROM_reconstruction = m_session->GetParameter("skip_ROM_reconstruction");	
+	}
+	else
+	{
+		skip_ROM_reconstruction = 0;
+	}
+	if (m_session->DefinesParameter("qoi_boundary_region")) // integrals of u and v over this boundary region
+	{
+		qoi_boundary_region = m_session->GetParameter("qoi_boundary_region");	
+	}
+	else
+	{
+		qoi_boundary_region = -1;
+	}
+	qoi_use_region = m_session->DefinesParameter("qoi_region_xmin"); // averages of u and v over a box
+	if (qoi_use_region)
+	{
+		qoi_region_xmin = m_session->GetParameter("qoi_region_xmin");
+		qoi_region_xmax = m_session->GetParameter("qoi_region_xmax");
+		qoi_region_ymin = m_session->GetParameter("qoi_region_ymin");
+		qoi_region_ymax = m_session->GetParameter("qoi_region_ymax");
+	}
 	POD_tolerance = m_session->GetParameter("POD_tolerance");
 	ref_param_index = m_session->GetParameter("ref_param_index");
 	ref_param_nu = m_session->GetParameter("ref_param_nu");
@@ -8106,6 +8434,76 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	{
 		write_ROM_field = 0;
 	} 
+	if (m_session->DefinesParameter("async_ROM_field_output")) // write ROM fld files on a background thread
+	{
+		async_ROM_field_output = m_session->GetParameter("async_ROM_field_output");
+	}
+	else
+	{
+		async_ROM_field_output = 0;
+	} 
+	if (m_session->DefinesParameter("async_ROM_field_queue_size")) 
+	{
+		async_ROM_field_queue_size = m_session->GetParameter("async_ROM_field_queue_size");
+	}
+	else
+	{
+		async_ROM_field_queue_size = 8;
+	} 
+	ROM_field_count = 0;
+	// FieldIO::Write is collective and a mapping writes its own coordinate files, keep those cases synchronous
+	if (async_ROM_field_output && write_ROM_field && (m_comm->GetSize() == 1) && !m_session->DefinesElement("Nektar/Mapping"))
+	{
+		m_asyncFieldWriter = MemoryManager<AsyncFieldWriter>::AllocateSharedPtr(m_fld, async_ROM_field_queue_size);
+	}
+	if (m_session->DefinesParameter("online_cache_size")) // number of converged online queries kept, 0 disables the cache
+	{
+		online_cache_size = m_session->GetParameter("online_cache_size");
+	}
+	else
+	{
+		online_cache_size = 0;
+	} 
+	if (m_session->DefinesParameter("online_cache_warm_start_radius")) // relative parameter distance up to which a cached solution is used as initial guess
+	{
+		online_cache_warm_start_radius = m_session->GetParameter("online_cache_warm_start_radius");
+	}
+	else
+	{
+		online_cache_warm_start_radius = 0.1;
+	} 
+	if (m_session->DefinesParameter("online_cache_persist")) // keep the cache in ROM_online_cache.txt between runs
+	{
+		online_cache_persist = m_session->GetParameter("online_cache_persist");
+	}
+	else
+	{
+		online_cache_persist = 0;
+	} 
+	if (m_session->DefinesParameter("write_reduced_model")) // store the reduced operators in ROM_reduced_model.txt
+	{
+		write_reduced_model = m_session->GetParameter("write_reduced_model");
+	}
+	else
+	{
+		write_reduced_model = 0;
+	} 
+	if (m_session->DefinesParameter("reduced_model_threads")) // > 0: check concurrent ReducedModel evaluations against the serial ones
+	{
+		reduced_model_threads = m_session->GetParameter("reduced_model_threads");
+	}
+	else
+	{
+		reduced_model_threads = 0;
+	} 
+	if (m_session->DefinesParameter("fixed_size_online_kernel")) // 0: dynamic-size Eigen types in the reduced-only online iteration
+	{
+		fixed_size_online_kernel = m_session->GetParameter("fixed_size_online_kernel");
+	}
+	else
+	{
+		fixed_size_online_kernel = 1;
+	} 
 	if (m_session->DefinesParameter("snapshot_computation_plot_rel_errors")) 
 	{
 		snapshot_computation_plot_rel_errors = m_session->GetParameter("snapshot_computation_plot_rel_errors");
@@ -8114,6 +8512,32 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	{
 		snapshot_computation_plot_rel_errors = 0;
 	} 
+	if (m_session->DefinesParameter("warm_start_truth_solve")) // 0: zero initial guess, 1: nearest snapshot, 2: interpolated prediction
+	{
+		warm_start_truth_solve = m_session->GetParameter("warm_start_truth_solve");
+	}
+	else
+	{
+		warm_start_truth_solve = 0;
+	} 
+	if (m_session->DefinesParameter("warm_start_record_cold_iterations")) // additionally solve from zero to measure the savings
+	{
+		warm_start_record_cold_iterations = m_session->GetParameter("warm_start_record_cold_iterations");
+	}
+	else
+	{
+		warm_start_record_cold_iterations = 0;
+	} 
+	if (m_session->DefinesParameter("sample_parameters_only")) // only write sample_grid.txt and fine_sample_grid.txt, no snapshots and no ROM
+	{
+		sample_parameters_only = m_session->GetParameter("sample_parameters_only");
+	}
+	else
+	{
+		sample_parameters_only = 0;
+	} 
+	// the truth and reduced solves take the parameter as (w, nu) of the affine channel geometry
+	ASSERTL0(parameter_space_dimension <= 2 || sample_parameters_only, "parameter_space_dimension > 2 is only supported for sampling, set sample_parameters_only = 1");
 	Nmax = number_of_snapshots;
 	if (parameter_space_dimension == 1)
 	{
@@ -8128,11 +8552,8 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 		        param_vector[i] = m_session->GetParameter(result);
 	        }
 	}
-	else if (parameter_space_dimension == 2)
+	else if (parameter_space_dimension >= 2)
 	{
-		general_param_vector = Array<OneD, Array<OneD, NekDouble> > (Nmax);
-		number_of_snapshots_dir0 = m_session->GetParameter("number_of_snapshots_dir0");
-		number_of_snapshots_dir1 = m_session->GetParameter("number_of_snapshots_dir1");
 		if (m_session->DefinesParameter("use_fine_grid_VV")) 
 		{
 			use_fine_grid_VV = m_session->GetParameter("use_fine_grid_VV");
@@ -8165,149 +8586,151 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 		{
 			fine_grid_dir1 = 0;
 		} 
-		Array<OneD, NekDouble> index_vector(parameter_space_dimension, 0.0);
+		Array<OneD, NekDouble> parameter_point(parameter_space_dimension, 0.0);
+		int i_all = 0;
+		if ((parameter_sampling == ParameterSampling::eTensor) && (parameter_space_dimension == 2) && !m_session->DefinesParameter("param_min_dir0"))
+		{
+			general_param_vector = Array<OneD, Array<OneD, NekDouble> > (Nmax);
+			number_of_snapshots_dir0 = m_session->GetParameter("number_of_snapshots_dir0");
+			number_of_snapshots_dir1 = m_session->GetParameter("number_of_snapshots_dir1");
+			Array<OneD, NekDouble> index_vector(parameter_space_dimension, 0.0);
 
 //		for(int i = 0; i < parameter_space_dimension; ++i)
 //		{
 //			cout << "psdiv " << index_vector[i] << endl;
 //		}
-		int i_all = 0;
 //		general_param_vector[i_all] = Array<OneD, NekDouble> (parameter_space_dimension);
-		Array<OneD, NekDouble> parameter_point(parameter_space_dimension, 0.0);
-		for(int i = 0; i < Nmax; ++i)
-		{
-			parameter_point = Array<OneD, NekDouble> (parameter_space_dimension, 0.0);
-			general_param_vector[i] = parameter_point;
-		}
-		for(int i0 = 0; i0 < number_of_snapshots_dir0; ++i0)
-		{
-			// generate the correct string
-			std::stringstream sstm;
-			sstm << "param" << i0 << "_dir0";
-			std::string result = sstm.str();
-		        if (i0 == 0)
-				start_param_dir0 = m_session->GetParameter(result);
-		        if (i0 == number_of_snapshots_dir0-1)
-				end_param_dir0 = m_session->GetParameter(result);
-			for(int i1 = 0; i1 < number_of_snapshots_dir1; ++i1)
+			for(int i = 0; i < Nmax; ++i)
+			{
+				parameter_point = Array<OneD, NekDouble> (parameter_space_dimension, 0.0);
+				general_param_vector[i] = parameter_point;
+			}
+			for(int i0 = 0; i0 < number_of_snapshots_dir0; ++i0)
 			{
 				// generate the correct string
-				std::stringstream sstm1;
-				sstm1 << "param" << i1 << "_dir1";
-				std::string result1 = sstm1.str();
-			    if (i1 == 0)
-					start_param_dir1 = m_session->GetParameter(result1);
-			    if (i1 == number_of_snapshots_dir1-1)
-					end_param_dir1 = m_session->GetParameter(result1);
-				general_param_vector[i_all][0] = m_session->GetParameter(result);
-			    general_param_vector[i_all][1] = m_session->GetParameter(result1);
-				i_all = i_all + 1;
+				std::stringstream sstm;
+				sstm << "param" << i0 << "_dir0";
+				std::string result = sstm.str();
+			        if (i0 == 0)
+					start_param_dir0 = m_session->GetParameter(result);
+			        if (i0 == number_of_snapshots_dir0-1)
+					end_param_dir0 = m_session->GetParameter(result);
+				for(int i1 = 0; i1 < number_of_snapshots_dir1; ++i1)
+				{
+					// generate the correct string
+					std::stringstream sstm1;
+					sstm1 << "param" << i1 << "_dir1";
+					std::string result1 = sstm1.str();
+				    if (i1 == 0)
+						start_param_dir1 = m_session->GetParameter(result1);
+				    if (i1 == number_of_snapshots_dir1-1)
+						end_param_dir1 = m_session->GetParameter(result1);
+					general_param_vector[i_all][0] = m_session->GetParameter(result);
+				    general_param_vector[i_all][1] = m_session->GetParameter(result1);
+					i_all = i_all + 1;
 //				general_param_vector[i_all] = Array<OneD, NekDouble> (parameter_space_dimension);
+				}
 			}
-		}
-		// if there is set use_non_unique_up_to_two then double the param vector
-		if (use_non_unique_up_to_two)
-		{
-			// Nmax should already be correct
-			// cout << "Nmax " << Nmax << endl;
-			for (int i = 0; i < Nmax/2; ++i)
+			param_lower = Array<OneD, NekDouble> (2);
+			param_upper = Array<OneD, NekDouble> (2);
+			param_lower[0] = start_param_dir0;
+			param_lower[1] = start_param_dir1;
+			param_upper[0] = end_param_dir0;
+			param_upper[1] = end_param_dir1;
+			// if there is set use_non_unique_up_to_two then double the param vector
+			if (use_non_unique_up_to_two)
 			{
-				general_param_vector[i + Nmax/2][0] = general_param_vector[i][0];
-				general_param_vector[i + Nmax/2][1] = general_param_vector[i][1];
-			}
+				// Nmax should already be correct
+				// cout << "Nmax " << Nmax << endl;
+				for (int i = 0; i < Nmax/2; ++i)
+				{
+					general_param_vector[i + Nmax/2][0] = general_param_vector[i][0];
+					general_param_vector[i + Nmax/2][1] = general_param_vector[i][1];
+				}
 
-		}
+			}
 
-		// output sample grid as *.txt
-	        std::string sample_grid_txt = "sample_grid.txt";
-		const char* outname_sample_grid_txt = sample_grid_txt.c_str();
-		ofstream myfile_sample_grid_txt (outname_sample_grid_txt);
-		i_all = 0;
-		if (myfile_sample_grid_txt.is_open())
-		{
-			for(int i0 = 0; i0 < number_of_snapshots_dir0; ++i0)
+			// output sample grid as *.txt
+		        std::string sample_grid_txt = "sample_grid.txt";
+			const char* outname_sample_grid_txt = sample_grid_txt.c_str();
+			ofstream myfile_sample_grid_txt (outname_sample_grid_txt);
+			i_all = 0;
+			if (myfile_sample_grid_txt.is_open())
 			{
-				for(int i1 = 0; i1 < number_of_snapshots_dir1; ++i1)
+				for(int i0 = 0; i0 < number_of_snapshots_dir0; ++i0)
 				{
-					myfile_sample_grid_txt << std::setprecision(17) << general_param_vector[i_all][0] << "\t" << general_param_vector[i_all][1] << endl;
-					i_all++;
+					for(int i1 = 0; i1 < number_of_snapshots_dir1; ++i1)
+					{
+						myfile_sample_grid_txt << std::setprecision(17) << general_param_vector[i_all][0] << "\t" << general_param_vector[i_all][1] << endl;
+						i_all++;
+					}
 				}
+				myfile_sample_grid_txt.close();
 			}
-			myfile_sample_grid_txt.close();
-		}
-		else cout << "Unable to open file"; 
+			else cout << "Unable to open file"; 
 
-		// output sample grids as *.txt
-	        std::string sample_grid_d1_txt = "sample_grid_d1.txt";
-		const char* outname_sample_grid_d1_txt = sample_grid_d1_txt.c_str();
-		ofstream myfile_sample_grid_d1_txt (outname_sample_grid_d1_txt);
-		if (myfile_sample_grid_d1_txt.is_open())
-		{
-			for(int i0 = 0; i0 < number_of_snapshots_dir0; ++i0)
+			// output sample grids as *.txt
+		        std::string sample_grid_d1_txt = "sample_grid_d1.txt";
+			const char* outname_sample_grid_d1_txt = sample_grid_d1_txt.c_str();
+			ofstream myfile_sample_grid_d1_txt (outname_sample_grid_d1_txt);
+			if (myfile_sample_grid_d1_txt.is_open())
 			{
-				myfile_sample_grid_d1_txt << std::setprecision(17) << general_param_vector[i0*number_of_snapshots_dir1][0] << endl;
+				for(int i0 = 0; i0 < number_of_snapshots_dir0; ++i0)
+				{
+					myfile_sample_grid_d1_txt << std::setprecision(17) << general_param_vector[i0*number_of_snapshots_dir1][0] << endl;
+				}
+				myfile_sample_grid_d1_txt.close();
 			}
-			myfile_sample_grid_d1_txt.close();
-		}
-		else cout << "Unable to open file"; 
+			else cout << "Unable to open file"; 
 
-	        std::string sample_grid_d2_txt = "sample_grid_d2.txt";
-		const char* outname_sample_grid_d2_txt = sample_grid_d2_txt.c_str();
-		ofstream myfile_sample_grid_d2_txt (outname_sample_grid_d2_txt);
-		if (myfile_sample_grid_d2_txt.is_open())
-		{
-			for(int i1 = 0; i1 < number_of_snapshots_dir1; ++i1)
+		        std::string sample_grid_d2_txt = "sample_grid_d2.txt";
+			const char* outname_sample_grid_d2_txt = sample_grid_d2_txt.c_str();
+			ofstream myfile_sample_grid_d2_txt (outname_sample_grid_d2_txt);
+			if (myfile_sample_grid_d2_txt.is_open())
 			{
-				myfile_sample_grid_d2_txt << std::setprecision(17) << general_param_vector[i1][1] << endl;
+				for(int i1 = 0; i1 < number_of_snapshots_dir1; ++i1)
+				{
+					myfile_sample_grid_d2_txt << std::setprecision(17) << general_param_vector[i1][1] << endl;
+				}
+				myfile_sample_grid_d2_txt.close();
 			}
-			myfile_sample_grid_d2_txt.close();
-		}
-		else cout << "Unable to open file"; 
+			else cout << "Unable to open file"; 
 
+		}
+		else
+		{
+			generate_parameter_samples();
+			number_of_snapshots = Nmax;
+		}
 		if (use_fine_grid_VV)
 		{
 		//	cout << "start_param_dir0 " << start_param_dir0 << endl;
 		//	cout << "end_param_dir0 " << end_param_dir0 << endl;
 		//	cout << "start_param_dir1 " << start_param_dir1 << endl;
 		//	cout << "end_param_dir1 " << end_param_dir1 << endl;
-			fine_general_param_vector = Array<OneD, Array<OneD, NekDouble> >(fine_grid_dir0*fine_grid_dir1);
-			for(int i = 0; i < fine_grid_dir0*fine_grid_dir1; ++i)
-			{
-				parameter_point = Array<OneD, NekDouble> (parameter_space_dimension, 0.0);
-				fine_general_param_vector[i] = parameter_point;
-			}
-			int current_index = 0;
-			for (int i1 = 0; i1 < fine_grid_dir0; i1++)
+			// fine_grid_dir<k> points in every direction of the sampled box
+			Array<OneD, int> fine_npoints(parameter_space_dimension);
+			fine_npoints[0] = fine_grid_dir0;
+			fine_npoints[1] = fine_grid_dir1;
+			for (int k = 2; k < parameter_space_dimension; ++k)
 			{
-				for (int i2 = 0; i2 < fine_grid_dir1; i2++)
-				{
-					double p0 = start_param_dir0 + double(i1)/(fine_grid_dir0-1) * (end_param_dir0 - start_param_dir0);
-					double p1 = start_param_dir1 + double(i2)/(fine_grid_dir1-1) * (end_param_dir1 - start_param_dir1);
-					fine_general_param_vector[current_index][0] = p0;
-					fine_general_param_vector[current_index][1] = p1;
-					current_index++;
-//					cout << "p0 " << p0 << " p1 " << p1 << endl;
-				}
+				std::stringstream sstm;
+				sstm << "fine_grid_dir" << k;
+				fine_npoints[k] = m_session->GetParameter(sstm.str());
 			}
+			fine_general_param_vector = ParameterSampling::TensorGrid(param_lower, param_upper, fine_npoints);
 
 			// output fine sample grid as *.txt
-		        std::string fine_sample_grid_txt = "fine_sample_grid.txt";
-			const char* outname_fine_sample_grid_txt = fine_sample_grid_txt.c_str();
-			ofstream myfile_fine_sample_grid_txt (outname_fine_sample_grid_txt);
-			i_all = 0;
-			if (myfile_fine_sample_grid_txt.is_open())
-			{
-				for(int i0 = 0; i0 < fine_grid_dir0; ++i0)
-				{
-					for(int i1 = 0; i1 < fine_grid_dir1; ++i1)
-					{
-						myfile_fine_sample_grid_txt << std::setprecision(17) << fine_general_param_vector[i_all][0] << "\t" << fine_general_param_vector[i_all][1] << endl;
-						i_all++;
-					}
-				}
-				myfile_fine_sample_grid_txt.close();
-			}
-			else cout << "Unable to open file"; 
+			ParameterSampling::Write("fine_sample_grid.txt", fine_general_param_vector);
+		}
+		if (sample_parameters_only)
+		{
+			cout << "sample_parameters_only: sample grids written, no snapshots computed" << endl;
+			return;
+		}
+
+		if (use_fine_grid_VV)
+		{
 
 			// write to file the VV grid
 //				        std::string outname_txt = m_sessionName + ".txt";
@@ -9811,6 +10234,91 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
     }
 
 
+    /**
+     * Copies the reduced operators of the geometry-parametrised problem into
+     * an immutable ReducedModel. The model does not refer back to this
+     * object, so it stays valid and reentrant while the solver keeps
+     * changing m_kinvis, curr_xy_projected and the advection terms.
+     */
+    ReducedModelSharedPtr CoupledLinearNS_TT::gen_reduced_model(Eigen::MatrixXd initial_proj)
+    {
+	ReducedOperators ops;
+	ops.m_geometry = &ChannelGeometryMap;
+	ops.m_size = RBsize;
+	ops.m_numElem = number_elem_trafo;
+	ops.m_constMat.resize(number_elem_trafo);
+	ops.m_abcdMat.resize(number_elem_trafo);
+	ops.m_constVec.resize(number_elem_trafo);
+	ops.m_abcdVec.resize(number_elem_trafo);
+	for (int index_elem = 0; index_elem < number_elem_trafo; ++index_elem)
+	{
+		for (int k = 0; k < 4; ++k)
+		{
+			ops.m_constMat[index_elem].push_back(the_const_one_proj_2d[index_elem][k]);
+			ops.m_abcdMat[index_elem].push_back(the_ABCD_one_proj_2d[index_elem][k]);
+			ops.m_constVec[index_elem].push_back(the_const_one_rhs_proj_2d[index_elem][k]);
+			ops.m_abcdVec[index_elem].push_back(the_ABCD_one_rhs_proj_2d[index_elem][k]);
+		}
+	}
+	ops.m_advMatX.resize(RBsize);
+	ops.m_advMatY.resize(RBsize);
+	ops.m_advVecX.resize(RBsize);
+	ops.m_advVecY.resize(RBsize);
+	for (int i = 0; i < RBsize; ++i)
+	{
+		ops.m_advMatX[i].resize(number_elem_trafo);
+		ops.m_advMatY[i].resize(number_elem_trafo);
+		ops.m_advVecX[i].resize(number_elem_trafo);
+		ops.m_advVecY[i].resize(number_elem_trafo);
+		for (int index_elem = 0; index_elem < number_elem_trafo; ++index_elem)
+		{
+			for (int k = 0; k < 2; ++k)
+			{
+				ops.m_advMatX[i][index_elem].push_back(adv_mats_proj_x_2d[i][index_elem][k]);
+				ops.m_advMatY[i][index_elem].push_back(adv_mats_proj_y_2d[i][index_elem][k]);
+				ops.m_advVecX[i][index_elem].push_back(adv_vec_proj_x_2d[i][index_elem][k]);
+				ops.m_advVecY[i][index_elem].push_back(adv_vec_proj_y_2d[i][index_elem][k]);
+			}
+		}
+	}
+	ops.m_projX = reduced_proj_x;
+	ops.m_projY = reduced_proj_y;
+	ops.m_liftX = reduced_proj_lift_x;
+	ops.m_liftY = reduced_proj_lift_y;
+	ops.m_initialProj = initial_proj;
+	ops.m_qoi = reduced_qoi;
+	ops.m_modeX = reduced_mode_x;
+	ops.m_modeY = reduced_mode_y;
+	ops.m_fieldLiftX = reduced_lift_x;
+	ops.m_fieldLiftY = reduced_lift_y;
+	int nphys = GetNpoints();
+	Array<OneD, NekDouble> coord_x(nphys), coord_y(nphys), coord_z(nphys);
+	m_fields[0]->GetCoords(coord_x, coord_y, coord_z);
+	ops.m_coordX = Eigen::VectorXd::Zero(nphys);
+	ops.m_coordY = Eigen::VectorXd::Zero(nphys);
+	for (int i = 0; i < nphys; ++i)
+	{
+		ops.m_coordX(i) = coord_x[i];
+		ops.m_coordY(i) = coord_y[i];
+	}
+	return ReducedModelSharedPtr(new ReducedModel(ops, 1e-5, 100, fixed_size_online_kernel));
+    }
+
+    void CoupledLinearNS_TT::gen_affine_operators_2d(double current_nu, double w, Eigen::MatrixXd &mat_const, std::vector<Eigen::MatrixXd> &mat_x, std::vector<Eigen::MatrixXd> &mat_y, Eigen::VectorXd &vec_const, Eigen::MatrixXd &vec_x, Eigen::MatrixXd &vec_y)
+    {
+	// the reduced model holds the operator pieces, the sums over the transformed elements live in ReducedOperators::Assemble
+	ASSERTL0(m_reducedModel, "gen_affine_operators_2d needs the reduced model of the online phase");
+	m_reducedModel->AssembleOperators(w, current_nu, mat_const, mat_x, mat_y, vec_const, vec_x, vec_y);
+    }
+
+    void CoupledLinearNS_TT::reduced_model_thread_check(int nthreads)
+    {
+	// stress test of the reentrant evaluator, the concurrent results have to match the serial ones bit for bit
+	double max_deviation = CheckConcurrentEvaluation(m_reducedModel, fine_general_param_vector, nthreads);
+	cout << "ReducedModel thread check: " << nthreads << " threads x " << fine_general_param_vector.num_elements() << " parameters, max deviation from the serial results " << max_deviation << endl;
+	ASSERTL0(max_deviation == 0.0, "concurrent ReducedModel evaluations differ from the serial ones");
+    }
+
     Eigen::VectorXd CoupledLinearNS_TT::reconstruct_solution_w_dbc(Eigen::VectorXd reprojected_solve)
     {
 	Eigen::VectorXd reconstruct_solution = Eigen::VectorXd::Zero(f_bnd_dbc_full_size.rows());  // is of size M_truth_size
@@ -9830,6 +10338,242 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	return reconstruct_solution;
     }
 
+    /**
+     * The velocity reconstruction u(a) = BwdTrans(reconstruct_solution_w_dbc(RB a))
+     * is affine in the reduced coefficients a, u(a) = u(0) + sum_j a_j u_j,
+     * where u_j is the velocity of the j-th RB column with homogeneous
+     * Dirichlet data. This stores u(0) and the u_j at the quadrature points
+     * of the reference geometry, at the cost of RBsize backward transforms,
+     * together with the reduced form of project_onto_basis used by the
+     * Oseen iteration.
+     */
+    void CoupledLinearNS_TT::gen_reduced_modes()
+    {
+	int nphys = GetNpoints();
+	Array<OneD, double> lift_x, lift_y;
+	Eigen::VectorXd lift_solution = reconstruct_solution_w_dbc(Eigen::VectorXd::Zero(RB.rows()));
+	recover_snapshot_loop(lift_solution, lift_x, lift_y, false);
+
+	reduced_mode_x = Eigen::MatrixXd::Zero(nphys, RBsize);
+	reduced_mode_y = Eigen::MatrixXd::Zero(nphys, RBsize);
+	reduced_lift_x = Eigen::VectorXd::Zero(nphys);
+	reduced_lift_y = Eigen::VectorXd::Zero(nphys);
+	for (int i = 0; i < nphys; ++i)
+	{
+		reduced_lift_x(i) = lift_x[i];
+		reduced_lift_y(i) = lift_y[i];
+	}
+	for (int j = 0; j < RBsize; ++j)
+	{
+		// homogeneous Dirichlet data, the lift is accounted for separately
+		Array<OneD, double> mode_x, mode_y;
+		Eigen::VectorXd mode_solution = reconstruct_solution_w_dbc(RB.col(j)) - lift_solution;
+		recover_snapshot_loop(mode_solution, mode_x, mode_y, false);
+		for (int i = 0; i < nphys; ++i)
+		{
+			reduced_mode_x(i,j) = mode_x[i];
+			reduced_mode_y(i,j) = mode_y[i];
+		}
+	}
+
+	reduced_proj_x = eigen_phys_basis_x.transpose() * reduced_mode_x;
+	reduced_proj_y = eigen_phys_basis_y.transpose() * reduced_mode_y;
+	reduced_proj_lift_x = eigen_phys_basis_x.transpose() * reduced_lift_x;
+	reduced_proj_lift_y = eigen_phys_basis_y.transpose() * reduced_lift_y;
+    }
+
+    /// Integrals of phys over the elements of each transformation group, the last entry collects the untransformed elements.
+    Eigen::VectorXd CoupledLinearNS_TT::integrate_per_trafo_group(Array<OneD, NekDouble> phys)
+    {
+	int no_groups = elements_trafo.num_elements();
+	Eigen::VectorXd group_integrals = Eigen::VectorXd::Zero(no_groups + 1);
+	for (int elmt = 0; elmt < m_fields[0]->GetExpSize(); ++elmt)
+	{
+		int group = get_curr_elem_pos(elmt);
+		if (group < 0)
+		{
+			group = no_groups;
+		}
+		group_integrals(group) += m_fields[0]->GetExp(elmt)->Integral(phys + m_fields[0]->GetPhys_Offset(elmt));
+	}
+	return group_integrals;
+    }
+
+    /**
+     * Linear functionals l of the velocity reduce to l(u(a)) = l(u(0)) + sum_j a_j l(u_j)
+     * with the modes of gen_reduced_modes. The modes live on the reference
+     * geometry, so integrals are split into one piece per transformation
+     * group and rescaled with the element maps of w in eval_reduced_qoi:
+     *   - the y-velocity at qoi_dof (the legacy quantity of interest),
+     *   - the integrals of u and v over the boundary region qoi_boundary_region,
+     *     one piece per boundary edge, scaled with its length,
+     *   - the averages of u and v over the box qoi_region_[xy]{min,max}, given
+     *     in reference coordinates and moving with the geometry, scaled with
+     *     the element volume.
+     */
+    void CoupledLinearNS_TT::gen_reduced_qoi_functionals()
+    {
+	reduced_qoi = ReducedQoI();
+	qoi_dof_row = -1;
+	if ((qoi_dof < 0) && (qoi_boundary_region < 0) && !qoi_use_region)
+	{
+		return;
+	}
+	int nphys = GetNpoints();
+	int no_groups = elements_trafo.num_elements();
+	if (qoi_dof >= 0)
+	{
+		ASSERTL0(qoi_dof < nphys, "qoi_dof exceeds the number of quadrature points");
+		qoi_dof_row = reduced_qoi.AddQoI("v_dof", false);
+		reduced_qoi.AddPiece(qoi_dof_row, ReducedQoI::ePoint, -1, 0.0, 0.0, 0.0, reduced_lift_y(qoi_dof), reduced_mode_y.row(qoi_dof));
+	}
+	if (qoi_boundary_region >= 0)
+	{
+		Array<OneD, MultiRegions::ExpListSharedPtr> bndCondExp = m_fields[0]->GetBndCondExpansions();
+		ASSERTL0(qoi_boundary_region < bndCondExp.num_elements(), "qoi_boundary_region does not exist");
+		MultiRegions::ExpListSharedPtr bndExp = bndCondExp[qoi_boundary_region];
+		int u_index = reduced_qoi.AddQoI("u_bnd_integral", false);
+		int v_index = reduced_qoi.AddQoI("v_bnd_integral", false);
+
+		// the parent element of every boundary edge decides about its element map
+		Array<OneD, int> bnd_elmt_id, bnd_edge_id;
+		m_fields[0]->GetBoundaryToElmtMap(bnd_elmt_id, bnd_edge_id);
+		int bnd_offset = 0;
+		for (int region = 0; region < qoi_boundary_region; ++region)
+		{
+			bnd_offset += bndCondExp[region]->GetExpSize();
+		}
+
+		int nbnd = bndExp->GetTotPoints();
+		Array<OneD, NekDouble> phys(nphys);
+		Eigen::MatrixXd bnd_u = Eigen::MatrixXd::Zero(nbnd, RBsize + 1);  // lift in the last column
+		Eigen::MatrixXd bnd_v = Eigen::MatrixXd::Zero(nbnd, RBsize + 1);
+		for (int j = 0; j <= RBsize; ++j)
+		{
+			Array<OneD, NekDouble> bnd_phys(nbnd);
+			Eigen::VectorXd field_x = (j < RBsize) ? Eigen::VectorXd(reduced_mode_x.col(j)) : reduced_lift_x;
+			Eigen::VectorXd field_y = (j < RBsize) ? Eigen::VectorXd(reduced_mode_y.col(j)) : reduced_lift_y;
+			Vmath::Vcopy(nphys, field_x.data(), 1, &phys[0], 1);
+			m_fields[0]->ExtractPhysToBnd(qoi_boundary_region, phys, bnd_phys);
+			bnd_u.col(j) = Eigen::Map<Eigen::VectorXd>(&bnd_phys[0], nbnd);
+			Vmath::Vcopy(nphys, field_y.data(), 1, &phys[0], 1);
+			m_fields[0]->ExtractPhysToBnd(qoi_boundary_region, phys, bnd_phys);
+			bnd_v.col(j) = Eigen::Map<Eigen::VectorXd>(&bnd_phys[0], nbnd);
+		}
+
+		for (int edge = 0; edge < bndExp->GetExpSize(); ++edge)
+		{
+			LocalRegions::ExpansionSharedPtr edgeExp = bndExp->GetExp(edge);
+			int npts = edgeExp->GetTotPoints();
+			int edge_offset = bndExp->GetPhys_Offset(edge);
+			int group = get_curr_elem_pos(bnd_elmt_id[bnd_offset + edge]);
+
+			// the edges are straight, the end points give the reference tangent
+			Array<OneD, NekDouble> edge_x(npts), edge_y(npts), edge_z(npts);
+			edgeExp->GetCoords(edge_x, edge_y, edge_z);
+			double tx = edge_x[npts-1] - edge_x[0];
+			double ty = edge_y[npts-1] - edge_y[0];
+			double length = sqrt(tx*tx + ty*ty);
+			ASSERTL0(length > 0.0, "degenerate boundary edge in qoi_boundary_region");
+
+			Eigen::RowVectorXd row_u(RBsize), row_v(RBsize);
+			double lift_u = 0.0, lift_v = 0.0;
+			Array<OneD, NekDouble> edge_phys(npts);
+			for (int j = 0; j <= RBsize; ++j)
+			{
+				for (int i = 0; i < npts; ++i)
+				{
+					edge_phys[i] = bnd_u(edge_offset + i, j);
+				}
+				double integral_u = edgeExp->Integral(edge_phys);
+				for (int i = 0; i < npts; ++i)
+				{
+					edge_phys[i] = bnd_v(edge_offset + i, j);
+				}
+				double integral_v = edgeExp->Integral(edge_phys);
+				if (j < RBsize)
+				{
+					row_u(j) = integral_u;
+					row_v(j) = integral_v;
+				}
+				else
+				{
+					lift_u = integral_u;
+					lift_v = integral_v;
+				}
+			}
+			// the reference integral already carries the reference length, the map only rescales it
+			reduced_qoi.AddPiece(u_index, ReducedQoI::eBoundary, group, tx / length, ty / length, 0.0, lift_u, row_u);
+			reduced_qoi.AddPiece(v_index, ReducedQoI::eBoundary, group, tx / length, ty / length, 0.0, lift_v, row_v);
+		}
+	}
+	if (qoi_use_region)
+	{
+		// the indicator of the box turns the average into a weighted integral
+		Array<OneD, NekDouble> coord_x(nphys), coord_y(nphys), coord_z(nphys);
+		m_fields[0]->GetCoords(coord_x, coord_y, coord_z);
+		Array<OneD, NekDouble> indicator(nphys, 0.0);
+		for (int i = 0; i < nphys; ++i)
+		{
+			if ((coord_x[i] >= qoi_region_xmin) && (coord_x[i] <= qoi_region_xmax) && (coord_y[i] >= qoi_region_ymin) && (coord_y[i] <= qoi_region_ymax))
+			{
+				indicator[i] = 1.0;
+			}
+		}
+		Eigen::VectorXd group_area = integrate_per_trafo_group(indicator);
+		ASSERTL0(group_area.sum() > 0.0, "the qoi region contains no quadrature points");
+		int u_index = reduced_qoi.AddQoI("u_region_average", true);
+		int v_index = reduced_qoi.AddQoI("v_region_average", true);
+
+		Eigen::MatrixXd group_u = Eigen::MatrixXd::Zero(no_groups + 1, RBsize + 1);  // lift in the last column
+		Eigen::MatrixXd group_v = Eigen::MatrixXd::Zero(no_groups + 1, RBsize + 1);
+		Array<OneD, NekDouble> weighted(nphys);
+		for (int j = 0; j <= RBsize; ++j)
+		{
+			Eigen::VectorXd field_x = (j < RBsize) ? Eigen::VectorXd(reduced_mode_x.col(j)) : reduced_lift_x;
+			Eigen::VectorXd field_y = (j < RBsize) ? Eigen::VectorXd(reduced_mode_y.col(j)) : reduced_lift_y;
+			Vmath::Vmul(nphys, &indicator[0], 1, field_x.data(), 1, &weighted[0], 1);
+			group_u.col(j) = integrate_per_trafo_group(weighted);
+			Vmath::Vmul(nphys, &indicator[0], 1, field_y.data(), 1, &weighted[0], 1);
+			group_v.col(j) = integrate_per_trafo_group(weighted);
+		}
+		for (int group = 0; group <= no_groups; ++group)
+		{
+			if (group_area(group) <= 0.0)
+			{
+				continue;
+			}
+			int map_index = (group < no_groups) ? group : -1;
+			reduced_qoi.AddPiece(u_index, ReducedQoI::eVolume, map_index, 0.0, 0.0, group_area(group), group_u(group, RBsize), group_u.row(group).head(RBsize));
+			reduced_qoi.AddPiece(v_index, ReducedQoI::eVolume, map_index, 0.0, 0.0, group_area(group), group_v(group, RBsize), group_v.row(group).head(RBsize));
+		}
+	}
+	if (debug_mode)
+	{
+		cout << "number of reduced qoi functionals " << reduced_qoi.GetNumQoI() << " in " << reduced_qoi.GetNumPieces() << " pieces" << endl;
+	}
+    }
+
+    Eigen::VectorXd CoupledLinearNS_TT::eval_reduced_qoi(Eigen::VectorXd reduced_solve, double w)
+    {
+	return reduced_qoi.Evaluate(&ChannelGeometryMap, w, reduced_solve);
+    }
+
+    /// The VV sweep stays in the reduced space unless full fields are needed.
+    bool CoupledLinearNS_TT::reduced_only_VV_sweep()
+    {
+	return use_fine_grid_VV && skip_ROM_reconstruction && !use_Newton && !use_fine_grid_VV_and_load_ref && !write_ROM_field;
+    }
+
+    /// Same result as project_onto_basis of the reconstructed velocity, without leaving the reduced space.
+    Eigen::MatrixXd CoupledLinearNS_TT::project_onto_basis_reduced(Eigen::VectorXd reduced_solve)
+    {
+	curr_xy_projected = Eigen::MatrixXd::Zero(reduced_proj_x.rows(), 2);
+	curr_xy_projected.col(0) = reduced_proj_lift_x + reduced_proj_x * reduced_solve;
+	curr_xy_projected.col(1) = reduced_proj_lift_y + reduced_proj_y * reduced_solve;
+	return curr_xy_projected;
+    }
+
     void CoupledLinearNS_TT::gen_reference_matrices()
     {
 	double current_nu = ref_param_nu;
@@ -10770,10 +11514,25 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 	Array<OneD, NekDouble> zero_phys_init(GetNpoints(), 0.0);
 	snapshot_x_collection = Array<OneD, Array<OneD, NekDouble> > (number_of_snapshots);
 	snapshot_y_collection = Array<OneD, Array<OneD, NekDouble> > (number_of_snapshots);
+	int total_iterations = 0;
+	int total_cold_iterations = 0;
+	std::ofstream iter_file;
+	if (warm_start_truth_solve)
+	{
+		iter_file.open("truth_solve_iterations.txt");
+		iter_file << "# param warm_start_iterations cold_start_iterations" << endl;
+	}
         for(int i = 0; i < number_of_snapshots; ++i)
 	{
-
-		Array<OneD, Array<OneD, NekDouble> > converged_solution = babyCLNS_trafo.DoSolve_at_param(zero_phys_init, zero_phys_init, param_vector[i]);
+		Array<OneD, NekDouble> init_x = zero_phys_init;
+		Array<OneD, NekDouble> init_y = zero_phys_init;
+		if (warm_start_truth_solve)
+		{
+			warm_start_guess(i, init_x, init_y);
+		}
+		Array<OneD, Array<OneD, NekDouble> > converged_solution = babyCLNS_trafo.DoSolve_at_param(init_x, init_y, param_vector[i]);
+		int iterations = babyCLNS_trafo.last_solve_iterations;
+		total_iterations += iterations;
 		snapshot_x_collection[i] = Array<OneD, NekDouble> (GetNpoints(), 0.0);
 		snapshot_y_collection[i] = Array<OneD, NekDouble> (GetNpoints(), 0.0);
 		for (int j=0; j < GetNpoints(); ++j)
@@ -10781,9 +11540,83 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
 			snapshot_x_collection[i][j] = converged_solution[0][j];
 			snapshot_y_collection[i][j] = converged_solution[1][j];
 		}
+		if (warm_start_truth_solve)
+		{
+			int cold_iterations = -1;
+			if (warm_start_record_cold_iterations && i > 0)
+			{
+				babyCLNS_trafo.DoSolve_at_param(zero_phys_init, zero_phys_init, param_vector[i]);
+				cold_iterations = babyCLNS_trafo.last_solve_iterations;
+				total_cold_iterations += cold_iterations;
+			}
+			else if (i == 0)
+			{
+				cold_iterations = iterations;
+				total_cold_iterations += cold_iterations;
+			}
+			cout << "snapshot " << i << " at param " << param_vector[i] << " took " << iterations << " iterations";
+			if (cold_iterations >= 0)
+			{
+				cout << " (zero initial guess: " << cold_iterations << ")";
+			}
+			cout << endl;
+			iter_file << param_vector[i] << " " << iterations << " " << cold_iterations << endl;
+		}
+	}
+	if (warm_start_truth_solve)
+	{
+		iter_file.close();
+		cout << "total truth solve iterations with warm start " << total_iterations;
+		if (warm_start_record_cold_iterations)
+		{
+			cout << ", with zero initial guess " << total_cold_iterations;
+		}
+		cout << endl;
 	}
 
+    }
 
+    /**
+     * Initial guess for the truth solve at param_vector[curr_index], built
+     * from the snapshots 0..curr_index-1 which are already converged.
+     * warm_start_truth_solve == 1 takes the snapshot at the closest parameter,
+     * warm_start_truth_solve == 2 interpolates (or extrapolates) linearly in
+     * the parameter between the two closest snapshots.
+     */
+    void CoupledLinearNS_TT::warm_start_guess(int curr_index, Array<OneD, NekDouble> &init_x, Array<OneD, NekDouble> &init_y)
+    {
+	if (curr_index == 0)
+	{
+		return;
+	}
+	NekDouble curr_param = param_vector[curr_index];
+	int closest = 0;
+	int second_closest = -1;
+	for (int i = 1; i < curr_index; ++i)
+	{
+		NekDouble dist = fabs(param_vector[i] - curr_param);
+		if (dist < fabs(param_vector[closest] - curr_param))
+		{
+			second_closest = closest;
+			closest = i;
+		}
+		else if ((second_closest < 0) || (dist < fabs(param_vector[second_closest] - curr_param)))
+		{
+			second_closest = i;
+		}
+	}
+	if ((warm_start_truth_solve == 1) || (second_closest < 0) || (param_vector[closest] == param_vector[second_closest]))
+	{
+		init_x = snapshot_x_collection[closest];
+		init_y = snapshot_y_collection[closest];
+		return;
+	}
+	NekDouble weight = (curr_param - param_vector[closest]) / (param_vector[second_closest] - param_vector[closest]);
+	int npoints = GetNpoints();
+	init_x = Array<OneD, NekDouble> (npoints);
+	init_y = Array<OneD, NekDouble> (npoints);
+	Vmath::Svtsvtp(npoints, 1.0 - weight, snapshot_x_collection[closest], 1, weight, snapshot_x_collection[second_closest], 1, init_x, 1);
+	Vmath::Svtsvtp(npoints, 1.0 - weight, snapshot_y_collection[closest], 1, weight, snapshot_y_collection[second_closest], 1, init_y, 1);
     }
 
     void CoupledLinearNS_TT::load_snapshots_geometry_params(int number_of_snapshots)
@@ -11055,7 +11888,7 @@ def Geo_T(w, elemT, index): # index 0: det, index 1,2,3,4: mat_entries
         
         std::string outname = m_sessionName + ".fld";
         
-        WriteFld(outname,m_fields[0],fieldcoeffs,variables);
+        write_ROM_fld(outname,fieldcoeffs,variables);
 
 /*
 //        Array<OneD, NekDouble> glo_fieldcoeffs(m_fields[0]->GetNcoeffs(), 1234.5678);
@@ -37,6 +37,12 @@
 #include "./CoupledLocalToGlobalC0ContMap.h"
 #include "./IncNavierStokes.h"
 #include "./CoupledLinearNS.h"
+#include "./CoupledElementBlocks.h"
+#include "./CoupledKrylovSolver.h"
+#include "./AsyncFieldWriter.h"
+#include "./ParameterSampling.h"
+#include "./OnlineQueryCache.h"
+#include "./ReducedModel.h"
 #include <MultiRegions/GlobalLinSys.h>
 #include <MultiRegions/ExpList3DHomogeneous1D.h>
 #include <MultiRegions/ExpList2D.h>
@@ -84,7 +90,7 @@ namespace Nektar
 
 	Eigen::VectorXd trafoSnapshot(Eigen::VectorXd RB_via_POD, double kInvis);
 
-	double Geo_T(double w, int elemT, int index); // array of matrices not suitable since there is no way to be symbolic
+	static double Geo_T(double w, int elemT, int index); // array of matrices not suitable since there is no way to be symbolic
 
 	void trafoSnapshot_simple(Eigen::MatrixXd RB_via_POD);
 
@@ -94,11 +100,15 @@ namespace Nektar
 	void load_snapshots_geometry_params(int );
 	void load_snapshots_geometry_params_conv_Oseen(int );
 	void compute_snapshots(int number_of_snapshots);
+	void warm_start_guess(int curr_index, Array<OneD, NekDouble> &init_x, Array<OneD, NekDouble> &init_y);
 	void compute_snapshots_geometry_params();
 	void do_geo_trafo();
 	void write_curr_field(std::string filename);
+	void write_ROM_fld(const std::string &outname, std::vector<Array<OneD, NekDouble> > &fieldcoeffs, std::vector<std::string> &variables);
+	void finish_ROM_field_output();
         
 	int parameter_space_dimension;
+	int parameter_sampling;
 	int load_cO_snapshot_data_from_files;
 	int do_trafo_check;
 	double POD_tolerance;
@@ -106,6 +116,9 @@ namespace Nektar
 	double end_param_dir0;
 	double start_param_dir1;
 	double end_param_dir1;
+	Array<OneD, NekDouble> param_lower; // box of the sampled parameters, any dimension
+	Array<OneD, NekDouble> param_upper;
+	int sample_parameters_only;
 	int use_fine_grid_VV;
 	int use_fine_grid_VV_and_load_ref;
 
@@ -180,13 +193,49 @@ namespace Nektar
 	Array<OneD, Array<OneD, Eigen::MatrixXd > > gen_adv_mats_proj_y_2d(Array<OneD, double>, Array<OneD, Array<OneD, Eigen::VectorXd > > &adv_vec_proj_y_2d);
 
 	double recover_snapshot_data(Eigen::VectorXd, int);
-	void recover_snapshot_loop(Eigen::VectorXd, Array<OneD, double> &, Array<OneD, double> &);
+	void recover_snapshot_loop(Eigen::VectorXd, Array<OneD, double> &, Array<OneD, double> &, bool write_field = true);
+
+	// linear quantities of interest evaluated directly on the reduced coefficients
+	void gen_reduced_modes();
+	void gen_reduced_qoi_functionals();
+	Eigen::VectorXd integrate_per_trafo_group(Array<OneD, NekDouble> phys);
+	Eigen::VectorXd eval_reduced_qoi(Eigen::VectorXd reduced_solve, double w);
+	bool reduced_only_VV_sweep();
+	Eigen::MatrixXd project_onto_basis_reduced(Eigen::VectorXd reduced_solve);
+	// immutable copy of the reduced operators, safe to evaluate concurrently
+	ReducedModelSharedPtr gen_reduced_model(Eigen::MatrixXd initial_proj);
+	void gen_affine_operators_2d(double current_nu, double w, Eigen::MatrixXd &mat_const, std::vector<Eigen::MatrixXd> &mat_x, std::vector<Eigen::MatrixXd> &mat_y, Eigen::VectorXd &vec_const, Eigen::MatrixXd &vec_x, Eigen::MatrixXd &vec_y);
+	void reduced_model_thread_check(int nthreads);
+	int fixed_size_online_kernel;
+	int reduced_model_threads;
+	int write_reduced_model;
+	ReducedModelSharedPtr m_reducedModel;
+	// workspace of the reduced-only sweep, reused for every query
+	ReducedOseenKernelSharedPtr m_oseenKernel;
+	int skip_ROM_reconstruction;
+	int qoi_boundary_region;
+	int qoi_use_region;
+	double qoi_region_xmin;
+	double qoi_region_xmax;
+	double qoi_region_ymin;
+	double qoi_region_ymax;
+	int qoi_dof_row;
+	ReducedQoI reduced_qoi;                // qoi functionals, scaled with the element maps of w
+	Eigen::MatrixXd reduced_proj_x;        // eigen_phys_basis_x^T applied to the RB velocity modes
+	Eigen::MatrixXd reduced_proj_y;
+	Eigen::VectorXd reduced_proj_lift_x;
+	Eigen::VectorXd reduced_proj_lift_y;
+	Eigen::MatrixXd reduced_mode_x;        // velocity of the RB modes at the quadrature points
+	Eigen::MatrixXd reduced_mode_y;
+	Eigen::VectorXd reduced_lift_x;        // velocity of the Dirichlet lift
+	Eigen::VectorXd reduced_lift_y;
 
 	void offline_phase();
 	void online_phase();
 	Array<OneD, NekDouble> param_point;
 	Array<OneD, Array<OneD, NekDouble> > general_param_vector;
 	Array<OneD, Array<OneD, NekDouble> > fine_general_param_vector;
+	void generate_parameter_samples();
 	int find_closest_snapshot_location(Array<OneD, NekDouble>, Array<OneD, Array<OneD, NekDouble> >);
 	int find_closest_snapshot_location_linf(Array<OneD, NekDouble>, Array<OneD, Array<OneD, NekDouble> >);
 	int find_closest_snapshot_location_l1(Array<OneD, NekDouble>, Array<OneD, Array<OneD, NekDouble> >);
@@ -201,7 +250,17 @@ namespace Nektar
 	int debug_mode;
 	int use_overlap_p_space;
 	int write_ROM_field;
+	int async_ROM_field_output;
+	int async_ROM_field_queue_size;
+	int ROM_field_count;
+	AsyncFieldWriterSharedPtr m_asyncFieldWriter;
+	int online_cache_size;
+	double online_cache_warm_start_radius;
+	int online_cache_persist;
+	OnlineQueryCacheSharedPtr m_onlineCache;
 	int snapshot_computation_plot_rel_errors;
+	int warm_start_truth_solve;
+	int warm_start_record_cold_iterations;
 	int compute_smaller_model_errs;
 
         Eigen::MatrixXd MtM;
@@ -320,6 +379,8 @@ namespace Nektar
         NekDouble m_KinvisPercentage;
 
         Array<OneD, CoupledSolverMatrices> m_mat;
+        CoupledElementBlocks m_elementBlocks;
+        CoupledKrylovSolverSharedPtr m_krylovSolver;
 
         void SetUpCoupledMatrix(const NekDouble lambda, 
                                 const Array< OneD, Array<OneD, NekDouble> > &Advfield, 
@@ -3476,6 +3476,9 @@ namespace Nektar
 			
 			Eigen::VectorXd reconstruct_solution, temp_solve_affine, repro_solve_affine;
 			Eigen::VectorXd last_sol = Eigen::VectorXd::Zero(RBsize); 
+			// an empty Gram matrix keeps the Euclidean norm of the coefficients
+			Eigen::MatrixXd gram = (deflation_norm > 0) ? gen_reduced_gram_matrix(deflation_norm) : Eigen::MatrixXd();
+			m_deflation = ReducedDeflation(gram, deflation_power, deflation_shift, deflation_distance_scale);
 			Eigen::MatrixXd curr_xy_proj = project_onto_basis(snapshot_x_collection[0], snapshot_y_collection[0]);
 			Eigen::VectorXd affine_vec_proj = gen_affine_vec_proj(first_param, 0);
 			
@@ -3612,63 +3615,7 @@ namespace Nektar
 							
 							if(j > 0) //if the step is too large some continuation could find a solution on a different branch, so I use deflation also in the continuation step
 							{
-								//computation of tau
-								double norm_i;
-								int closest_sol;
-								for(int k = 0; k < local_indices_to_be_continued.size(); k++)
-								{
-									/*std::vector< Array<OneD, double> > reprojection_other_sol = reproject_back(reconstruct_solution_w_dbc(RB*solve_affine[local_indices_to_be_continued[k]]));
-									for(int i = 0; i < GetNpoints(); i++)
-									{
-										m_fields[0]->UpdatePhys()[i] = reprojection[0][i] - reprojection_other_sol[0][i];;
-										m_fields[1]->UpdatePhys()[i] = reprojection[1][i] - reprojection_other_sol[1][i];
-									}
-									double norm_ix = m_fields[0]->L2(m_fields[0]->UpdatePhys());
-									double norm_iy = m_fields[1]->L2(m_fields[1]->UpdatePhys());
-									double norm_i = sqrt(norm_ix*norm_ix + norm_iy*norm_iy);
-									
-									if(norm_i < norm_min)
-									{
-										norm_min = norm_i;
-										closest_sol = k;
-									}*/
-									if((temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).norm() < norm_min)
-									//if((temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).transpose() * massMatrix * (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]) < norm_min)
-									{
-										norm_min = (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).norm();
-										//norm_min = (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).transpose() * massMatrix * (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]);
-										closest_sol = local_indices_to_be_continued[k];
-									}
-								}
-								
-								/*std::vector< Array<OneD, double> > reprojection_other_sol = reproject_back(reconstruct_solution_w_dbc(RB*solve_affine[local_indices_to_be_continued[closest_sol]]));
-								for(int i = 0; i < GetNpoints(); i++)
-								{
-									m_fields[0]->UpdatePhys()[i] = (reprojection[0][i] - reprojection_other_sol[0][i]) * (reprojection[0][i] - old_reprojection_x[i]);
-									m_fields[1]->UpdatePhys()[i] = (reprojection[1][i] - reprojection_other_sol[1][i]) * (reprojection[0][i] - old_reprojection_y[i]);
-								}						
-								double scalar_product = -(m_fields[0]->Integral(m_fields[0]->GetPhys()) + m_fields[1]->Integral(m_fields[1]->GetPhys()));*/
-								
-								
-								
-								//norm_min /= solve_affine[closest_sol].transpose() * massMatrix * solve_affine[closest_sol];
-								double scalar_product = -(temp_solve_affine - solve_affine[closest_sol]).dot(temp_solve_affine - last_sol);
-								//double scalar_product = -(temp_solve_affine - solve_affine[closest_sol]).transpose() * massMatrix * (temp_solve_affine - last_sol);
-								double tau;
-								int power = 2;
-								if(power == 1)
-									tau = 1 / (1 - 1/(1+1/norm_min) * scalar_product / (norm_min * norm_min * norm_min));	
-								if(power == 2)
-									tau = 2 / (1 - 1/(1+1/norm_min/norm_min) * scalar_product / (norm_min * norm_min * norm_min * norm_min));	
-								if(norm_min < 5e-2)
-									tau = -5;							
-									
-								if(tau < 0 && tau > -0.1)
-									tau = -0.1;
-								if(tau > 0 && tau < 0.5)
-									tau = 0.5;		
-								if(tau > 1)
-									tau = 1;		
+								double tau = m_deflation.ContinuationStep(temp_solve_affine, last_sol, solve_affine, local_indices_to_be_continued, 5e-2, -5, -0.1, norm_min);
 								temp_solve_affine = tau * temp_solve_affine + (1-tau) * last_sol;
 							}
 							
@@ -3683,7 +3630,7 @@ namespace Nektar
 							std::vector< Array<OneD, double> > reprojection = reproject_back(reconstruct_solution);
 							curr_xy_proj = project_onto_basis(reprojection[0], reprojection[1]);
 					
-							if(rel_err <= tol && norm_min > 1e-2)
+							if(rel_err <= tol && norm_min > m_deflation.Threshold(1e-2))
 							{
 								cout<<"Converged in "<<iterations<<" steps"<<endl;
 								solve_affine.push_back(temp_solve_affine);
@@ -3749,63 +3696,7 @@ namespace Nektar
 							//Eigen::VectorXd affine_vec_proj = gen_affine_vec(current_nu, last_sol);
 							temp_solve_affine = affine_mat_proj.colPivHouseholderQr().solve(affine_vec_proj);
 							
-							//computation of tau
-							double norm_i;
-							norm_min = 1e20;
-							int closest_sol;
-							for(int k = 0; k < local_indices_to_be_continued.size(); k++)
-							{
-								/*std::vector< Array<OneD, double> > reprojection_other_sol = reproject_back(reconstruct_solution_w_dbc(RB*solve_affine[local_indices_to_be_continued[k]]));
-								for(int i = 0; i < GetNpoints(); i++)
-								{
-									m_fields[0]->UpdatePhys()[i] = reprojection[0][i] - reprojection_other_sol[0][i];;
-									m_fields[1]->UpdatePhys()[i] = reprojection[1][i] - reprojection_other_sol[1][i];
-								}
-								double norm_ix = m_fields[0]->L2(m_fields[0]->UpdatePhys());
-								double norm_iy = m_fields[1]->L2(m_fields[1]->UpdatePhys());
-								double norm_i = sqrt(norm_ix*norm_ix + norm_iy*norm_iy);
-								
-								if(norm_i < norm_min)
-								{
-									norm_min = norm_i;
-									closest_sol = k;
-								}*/
-								if((temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).norm() < norm_min)
-								//if((temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).transpose() * massMatrix * (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]) < norm_min)
-								{
-									norm_min = (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).norm();
-									//norm_min = (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).transpose() * massMatrix * (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]);
-									closest_sol = local_indices_to_be_continued[k];
-								}
-							}
-							
-							/*std::vector< Array<OneD, double> > reprojection_other_sol = reproject_back(reconstruct_solution_w_dbc(RB*solve_affine[local_indices_to_be_continued[closest_sol]]));
-							for(int i = 0; i < GetNpoints(); i++)
-							{
-								m_fields[0]->UpdatePhys()[i] = (reprojection[0][i] - reprojection_other_sol[0][i]) * (reprojection[0][i] - old_reprojection_x[i]);
-								m_fields[1]->UpdatePhys()[i] = (reprojection[1][i] - reprojection_other_sol[1][i]) * (reprojection[0][i] - old_reprojection_y[i]);
-							}						
-							double scalar_product = -(m_fields[0]->Integral(m_fields[0]->GetPhys()) + m_fields[1]->Integral(m_fields[1]->GetPhys()));*/
-							
-							
-							
-							//norm_min /= solve_affine[closest_sol].transpose() * massMatrix * solve_affine[closest_sol];
-							double scalar_product = -(temp_solve_affine - solve_affine[closest_sol]).dot(temp_solve_affine - last_sol);
-							//double scalar_product = -(temp_solve_affine - solve_affine[closest_sol]).transpose() * massMatrix * (temp_solve_affine - last_sol);
-							int power = 2;
-							if(power == 1)
-								tau = 1 / (1 - 1/(1+1/norm_min) * scalar_product / (norm_min * norm_min * norm_min));	
-							if(power == 2)
-								tau = 2 / (1 - 1/(1+1/norm_min/norm_min) * scalar_product / (norm_min * norm_min * norm_min * norm_min));	
-														
-							if(norm_min < 5e-2)   //simple heuristic
-								tau = -3;
-							if(tau < 0 && tau > -0.2)  
-								tau = -0.2;
-							if(tau > 0 && tau < 0.5)
-								tau = 0.5;		
-							if(tau > 1)
-								tau = 1;	
+							tau = m_deflation.ContinuationStep(temp_solve_affine, last_sol, solve_affine, local_indices_to_be_continued, 5e-2, -3, -0.2, norm_min);
 								
 							/*if(norm_i < 5e-2) 
 								danger = true;
@@ -3865,7 +3756,7 @@ namespace Nektar
 							curr_xy_proj = project_onto_basis(reprojection[0], reprojection[1]);
 							
 							
-							if(rel_err <= tol && norm_min > 1 && norm_min < 5e5)
+							if(rel_err <= tol && norm_min > m_deflation.Threshold(1) && norm_min < m_deflation.Threshold(5e5))
 							{
 								cout<<"Converged in "<<iterations<<" steps with norm_min = "<<norm_min<<endl;
 								solve_affine.push_back(temp_solve_affine);
@@ -3939,38 +3830,7 @@ namespace Nektar
 									else
 										curr_xy_projected(i,1) = temp_solve_affine(i);
 								}
-								norm_min = 1e20;
-								
-								//computation of tau
-								double norm_i;
-								int closest_sol;
-								for(int k = 0; k < local_indices_to_be_continued.size(); k++)
-								{
-									if((temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).norm() < norm_min)
-									{
-										norm_min = (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).norm();
-										//norm_min = (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]).transpose() * massMatrix * (temp_solve_affine - solve_affine[local_indices_to_be_continued[k]]);
-										closest_sol = local_indices_to_be_continued[k];
-									}
-								}
-								double scalar_product = -(temp_solve_affine - solve_affine[closest_sol]).dot(temp_solve_affine - last_sol);
-								double tau;
-								int power = 2;
-								if(power == 1)
-									tau = 1 / (1 - 1/(1+1/norm_min) * scalar_product / (norm_min * norm_min * norm_min));	
-								if(power == 2)
-									tau = 2 / (1 - 1/(1+1/norm_min/norm_min) * scalar_product / (norm_min * norm_min * norm_min * norm_min));	
-								if(norm_min < 0.1)
-								{
-									tau = -3;
-								}						
-									
-								if(tau < 0 && tau > -0.1)
-									tau = -0.1;
-								if(tau > 0 && tau < 0.5)
-									tau = 0.5;		
-								if(tau > 1)
-									tau = 1;		
+								double tau = m_deflation.ContinuationStep(temp_solve_affine, last_sol, solve_affine, local_indices_to_be_continued, 0.1, -3, -0.1, norm_min);
 								temp_solve_affine = tau * temp_solve_affine + (1-tau) * last_sol;
 								
 								rel_err = (temp_solve_affine-last_sol).norm()/last_sol.norm();
@@ -3982,7 +3842,7 @@ namespace Nektar
 								std::vector< Array<OneD, double> > reprojection = reproject_back(reconstruct_solution);
 								curr_xy_proj = project_onto_basis(reprojection[0], reprojection[1]);
 						
-								if(rel_err <= tol && norm_min > 1 && iterations < 9999)
+								if(rel_err <= tol && norm_min > m_deflation.Threshold(1) && iterations < 9999)
 								{
 									cout<<"Converged in "<<iterations<<" steps with norm_min = "<<norm_min<<endl;
 									solve_affine.push_back(temp_solve_affine);
@@ -4203,6 +4063,38 @@ namespace Nektar
 	{
 		create_error_file = 0;
 	}
+	if (m_session->DefinesParameter("deflation_norm")) 
+	{
+		deflation_norm = m_session->GetParameter("deflation_norm");
+	}
+	else
+	{
+		deflation_norm = 0;
+	}
+	if (m_session->DefinesParameter("deflation_power")) 
+	{
+		deflation_power = m_session->GetParameter("deflation_power");
+	}
+	else
+	{
+		deflation_power = 2.0;
+	}
+	if (m_session->DefinesParameter("deflation_shift")) 
+	{
+		deflation_shift = m_session->GetParameter("deflation_shift");
+	}
+	else
+	{
+		deflation_shift = 1.0;
+	}
+	if (m_session->DefinesParameter("deflation_distance_scale")) // Gram norm of a unit coefficient vector, scales the distance thresholds
+	{
+		deflation_distance_scale = m_session->GetParameter("deflation_distance_scale");
+	}
+	else
+	{
+		deflation_distance_scale = 0.0; // derived from the Gram matrix
+	}
 	if (m_session->DefinesParameter("compare_accuracy_mode")) 
 	{
 		compare_accuracy_mode = m_session->GetParameter("compare_accuracy_mode");
@@ -5131,6 +5023,59 @@ RBsize--;
 
     }
     
+    /**
+     * Gram matrix of the reduced basis, G_ij = (u_i, u_j) for norm_type 1 and
+     * G_ij = (u_i, u_j) + (grad u_i, grad u_j) for norm_type 2, where u_j is
+     * the velocity of the j-th RB column with homogeneous Dirichlet data.
+     * Pressure components do not enter, so G is a semi-norm on the pressure
+     * part of the basis.
+     */
+    Eigen::MatrixXd CoupledLinearNS_TT::gen_reduced_gram_matrix(int norm_type)
+    {
+	int nphys = GetNpoints();
+	int nvel = 2;
+	int nterms = (norm_type == 2) ? 3*nvel : nvel;
+	// per mode: u, v and for H1 also du/dx, du/dy, dv/dx, dv/dy
+	std::vector<std::vector<Array<OneD, NekDouble> > > mode_terms(RBsize);
+	for (int j = 0; j < RBsize; ++j)
+	{
+		Eigen::VectorXd unit = Eigen::VectorXd::Zero(RBsize);
+		unit(j) = 1.0;
+		// zero scaling of the Dirichlet data gives the homogeneous mode
+		std::vector< Array<OneD, double> > mode = reproject_back(reconstruct_solution_w_different_dbc(RB * unit, 0.0));
+		mode_terms[j].push_back(mode[0]);
+		mode_terms[j].push_back(mode[1]);
+		if (norm_type == 2)
+		{
+			for (int k = 0; k < nvel; ++k)
+			{
+				Array<OneD, NekDouble> deriv_x(nphys), deriv_y(nphys);
+				m_fields[0]->PhysDeriv(mode[k], deriv_x, deriv_y);
+				mode_terms[j].push_back(deriv_x);
+				mode_terms[j].push_back(deriv_y);
+			}
+		}
+	}
+
+	Eigen::MatrixXd gram = Eigen::MatrixXd::Zero(RBsize, RBsize);
+	Array<OneD, NekDouble> product(nphys);
+	for (int i = 0; i < RBsize; ++i)
+	{
+		for (int j = i; j < RBsize; ++j)
+		{
+			double entry = 0.0;
+			for (int t = 0; t < nterms; ++t)
+			{
+				Vmath::Vmul(nphys, mode_terms[i][t], 1, mode_terms[j][t], 1, product, 1);
+				entry += m_fields[0]->PhysIntegral(product);
+			}
+			gram(i,j) = entry;
+			gram(j,i) = entry;
+		}
+	}
+	return gram;
+    }
+
     std::vector< Array<OneD, double> > CoupledLinearNS_TT::reproject_back(Eigen::VectorXd reconstruct_solution)
     {
     	Eigen::VectorXd f_bnd = reconstruct_solution.head(curr_f_bnd.size());
@@ -37,6 +37,7 @@
 #include "./CoupledLocalToGlobalC0ContMap.h"
 #include "./IncNavierStokes.h"
 #include "./CoupledLinearNS.h"
+#include "./ReducedDeflation.h"
 #include <MultiRegions/GlobalLinSys.h>
 #include <MultiRegions/ExpList3DHomogeneous1D.h>
 #include <MultiRegions/ExpList2D.h>
@@ -233,6 +234,12 @@ namespace Nektar
 	unsigned int online_no_solves;
 	std::vector<Eigen::VectorXd> solve_affine;
 	bool create_error_file;
+	int deflation_norm;          // 0: Euclidean norm of the coefficients, 1: L2, 2: H1 Gram matrix
+	double deflation_power;      // also the power of the Euclidean heuristic, 1 or 2
+	double deflation_shift;
+	double deflation_distance_scale;
+	ReducedDeflation m_deflation;
+	Eigen::MatrixXd gen_reduced_gram_matrix(int);
 	
 	
 
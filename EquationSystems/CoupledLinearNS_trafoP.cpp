@@ -59,6 +59,7 @@ namespace Nektar
     CoupledLinearNS_trafoP::CoupledLinearNS_trafoP(const LibUtilities::SessionReaderSharedPtr &pSession):
         UnsteadySystem(pSession),
         CoupledLinearNS(pSession),
+        last_solve_iterations(0),
         m_zeroMode(false)
     {
     }
@@ -169,6 +170,13 @@ namespace Nektar
                 m_advObject);
         }
 
+        // matrix-free Krylov alternative to the direct coupled solve
+        if(m_session->DefinesParameter("use_krylov_solver") && m_session->GetParameter("use_krylov_solver"))
+        {
+            ASSERTL0((m_HomogeneousType == eNotHomogeneous) && !m_singleMode, "use_krylov_solver is only available for 2D coupled solves");
+            m_krylovSolver = MemoryManager<CoupledKrylovSolver>::AllocateSharedPtr(m_session);
+        }
+
     }
     
     /**
@@ -461,6 +469,10 @@ namespace Nektar
         ::AllocateSharedPtr(nsize_p_m1,nsize_p_m1,blkmatStorage);
         
         
+        bool UseElementBlocks = m_elementBlocks.Enable(m_session, m_fields[m_velocity[0]], m_pressure, AddAdvectionTerms, lambda, lambda_imag, nz_loc, nvel);
+
+        bool UseKrylov = m_krylovSolver && (nz_loc == 1);
+
         Timer timer;
         timer.Start();
         for(n = 0; n < nel; ++n)
@@ -656,6 +668,18 @@ namespace Nektar
                     }
                 }
             }
+            else if(UseElementBlocks)
+            {
+                m_elementBlocks.Assemble(n, m_kinvis, Advfield, IsLinearNSEquation, *Ah, *B, *C, *D, *Dbnd, *Dint);
+
+                D->Invert();
+                (*B) = (*B)*(*D);
+                Blas::Dgemm('N','T', B->GetRows(), C->GetRows(), 
+                            B->GetColumns(), -1.0, B->GetRawPtr(),
+                            B->GetRows(), C->GetRawPtr(), 
+                            C->GetRows(), 1.0, 
+                            Ah->GetRawPtr(), Ah->GetRows());
+            }
             else
             {
                 // construct velocity matrices and pressure systems at
@@ -1106,6 +1130,14 @@ namespace Nektar
             
             // This could be transpose of BCinvDint in some cases
             DintCinvBTtilde_m_Dbnd = (*Dint)*(*Cinv)*Transpose(*Btilde) - (*Dbnd); 
+
+            if(UseKrylov)
+            {
+                // keep the element matrix after the first level of static
+                // condensation, the Krylov solver applies it matrix-free
+                m_krylovSolver->SetCondensedElementMatrix(n,nel,nsize_bndry[n],*Ah,BCinvDTint_m_DTbnd,DintCinvBTtilde_m_Dbnd,DintCinvDTint);
+                continue;
+            }
             
             // Set up final set of matrices. 
             DNekMatSharedPtr Bh = MemoryManager<DNekMat>::AllocateSharedPtr(nsize_bndry_p1[n],nsize_p_m1[n],zero);
@@ -1199,9 +1231,15 @@ namespace Nektar
 
         }
         timer.Stop();
-//        cout << "Matrix Setup Costs: " << timer.TimePerTest(1) << endl;
+        CoupledElementBlocks::ReportAssemblyTime(m_session, timer.TimePerTest(1));
         
         
+        if(UseKrylov)
+        {
+            m_krylovSolver->Initialise(locToGloMap);
+            return;
+        }
+
         timer.Start();
         // Set up global coupled boundary solver. 
         // This is a key to define the solution matrix type
@@ -1457,8 +1495,10 @@ namespace Nektar
 //	DoInitialise();
 //	DoSolve();
 	double rel_err = 1.0;
+	last_solve_iterations = 0;
 	while (rel_err > 1e-11)
 	{
+		++last_solve_iterations;
 		Set_m_kinvis( parameter );
 		DoInitialiseAdv(init_snapshot_x, init_snapshot_y); // replaces .DoInitialise();
 		DoSolve();
@@ -2341,7 +2381,21 @@ namespace Nektar
 	///////////////////////////
 
 
-        m_mat[mode].m_CoupledBndSys->Solve(fh_bnd,bnd,m_locToGloMap[mode]);
+        if(m_krylovSolver && (nz_loc == 1))
+        {
+            m_krylovSolver->Solve(fh_bnd,bnd);
+        }
+        else
+        {
+            Timer solvetimer;
+            solvetimer.Start();
+            m_mat[mode].m_CoupledBndSys->Solve(fh_bnd,bnd,m_locToGloMap[mode]);
+            solvetimer.Stop();
+            if(m_session->DefinesParameter("report_solve_time") && m_session->GetParameter("report_solve_time"))
+            {
+                cout << "Direct coupled solve: " << solvetimer.TimePerTest(1) << " s" << endl;
+            }
+        }
         
 	////////////////////////////
 	// temporary debugging
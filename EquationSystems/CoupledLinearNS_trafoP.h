@@ -37,6 +37,8 @@
 #include "./CoupledLocalToGlobalC0ContMap.h"
 #include "./IncNavierStokes.h"
 #include "./CoupledLinearNS.h"
+#include "./CoupledElementBlocks.h"
+#include "./CoupledKrylovSolver.h"
 #include <MultiRegions/GlobalLinSys.h>
 #include <MultiRegions/ExpList3DHomogeneous1D.h>
 #include <MultiRegions/ExpList2D.h>
@@ -137,6 +139,7 @@ namespace Nektar
 	void Set_m_kinvis(NekDouble);
 	int use_Newton;
 	int snapshot_computation_plot_rel_errors;
+	int last_solve_iterations; // Oseen/Newton iterations taken by the last DoSolve_at_param
 	int debug_mode;
 	Array<OneD, Array<OneD, NekDouble> > myAdvField;
 
@@ -163,6 +166,8 @@ namespace Nektar
         
         
         Array<OneD, CoupledSolverMatrices> m_mat;
+        CoupledElementBlocks m_elementBlocks;
+        CoupledKrylovSolverSharedPtr m_krylovSolver;
         
         
         /**
@@ -42,6 +42,7 @@
 #include <MultiRegions/GlobalLinSysDirectStaticCond.h>
 
 #include <vector>
+#include <complex>
 
 
 using namespace std;
@@ -3014,6 +3015,11 @@ namespace Nektar
         m_session->LoadParameter("Restart", m_Restart);
         m_session->LoadParameter("KinvisStep", step);
         m_session->LoadParameter("UseDeflation", use_deflation);
+        m_session->LoadParameter("BifurcationDetection", bifurcation_detection, 0);
+        m_session->LoadParameter("BifurcationKrylovDim", bifurcation_krylov_dim, 4);
+        m_session->LoadParameter("BifurcationTolerance", bifurcation_tolerance, 0.05);
+        m_session->LoadParameter("BifurcationDeflationSteps", bifurcation_deflation_steps, 2);
+        ASSERTL0(bifurcation_krylov_dim > 0, "BifurcationKrylovDim has to be positive");
         
         arclength_step = step;
         max_step = step;
@@ -3042,22 +3048,19 @@ namespace Nektar
 		
 		
 		int index = 43; // random number
-		WritePhysCoordIndicesMapping();
-			std::ifstream infile;
-			infile.open("mf1.txt", std::ios::in);
+		int nPoints = m_fields[1]->GetTotPoints();
+		Array<OneD, NekDouble> coords0(nPoints), coords1(nPoints), coords2(nPoints);
+		m_fields[1]->GetCoords(coords0, coords1, coords2);
 			
-			double x1,y1,z1;
 			bool finished = false;
 			//std::vector<int> flipperMap;
-			std::vector<double> x, y;
-			while(infile >> x1 >>y1 >> z1)
+			std::vector<double> x(coords0.begin(), coords0.end()), y(coords1.begin(), coords1.end());
+			for(int i = 0; i < nPoints; i++)
 			{
-				if((x1 == 2 && y1 == 0.5) || finished)
+				if((x[i] == 2 && y[i] == 0.5) || finished)
 					finished = true;
 				else
 					index++;
-				x.push_back(x1);
-				y.push_back(y1);
 			}
 			flipperMap = GetFlipperMap(x,y); 
 			
@@ -3093,9 +3096,24 @@ namespace Nektar
 			FarrelOutput(flipperMap, outfile, FarrelOutputSign(x,y));
 			total_solutions_found = 1;
 			
+			// the leading Ritz value mu of the linearised Oseen map is tracked along the first branch,
+			// the Navier-Stokes Jacobian is singular where mu crosses 1
+			std::ofstream bif_indicator_file, bif_points_file;
+			int continuation_step = 0, bif_window = 0, bif_prev_det_sign = 0;
+			double bif_prev_param = 0, bif_prev_lead = 0;
+			bifurcation_start_vector = Eigen::VectorXd();
+			if(bifurcation_detection)
+			{
+				bif_indicator_file.open("bifurcation_indicator.txt", std::ios::out);
+				bif_indicator_file<<"# step kinvis second_param re(mu) im(mu) |1-mu| sign(det(I-H))"<<endl;
+				bif_points_file.open("bifurcation_points.txt", std::ios::out);
+				bif_points_file<<"# step kinvis second_param estimated_kinvis re(mu) im(mu) |1-mu| type"<<endl;
+			}
+			
 			while(m_kinvis > m_kinvisMin && total_solutions_found < m_maxIt)
 			{
 				local_indices_to_be_continued.resize(0);
+				continuation_step++;
 				
 				//continuation
 				cout<<"\nBegin continuation"<<endl;			
@@ -3180,6 +3198,48 @@ namespace Nektar
 				}
 				
 				
+				if(bifurcation_detection && local_indices_to_be_continued.size() > 0)
+				{
+					int tracked = local_indices_to_be_continued[0];
+					double current_param = m_kinvis;
+					double tracked_param = param_vector[tracked];
+					Eigen::VectorXcd ritz = ReducedJacobianRitzValues(sol_x_cont_defl[tracked], sol_y_cont_defl[tracked], tracked_param);
+					Set_m_kinvis(current_param);
+					
+					int lead = 0;
+					std::complex<double> det(1.0, 0.0);
+					for(int k = 0; k < ritz.size(); k++)
+					{
+						det *= 1.0 - ritz(k);
+						if(std::abs(1.0 - ritz(k)) < std::abs(1.0 - ritz(lead)))
+							lead = k;
+					}
+					int det_sign = (det.real() >= 0) ? 1 : -1;
+					double distance = std::abs(1.0 - ritz(lead));
+					bif_indicator_file<<continuation_step<<" "<<tracked_param<<" "<<second_param<<" "<<ritz(lead).real()<<" "<<ritz(lead).imag()<<" "<<distance<<" "<<det_sign<<endl;
+					
+					bool sign_change = (bif_prev_det_sign != 0) && (det_sign != bif_prev_det_sign);
+					if(sign_change || distance < bifurcation_tolerance)
+					{
+						double estimate = tracked_param;
+						if(sign_change && ritz(lead).real() != bif_prev_lead) // linear interpolation of 1 - re(mu) between the last two steps
+							estimate = bif_prev_param + (tracked_param - bif_prev_param) * (1.0 - bif_prev_lead) / (ritz(lead).real() - bif_prev_lead);
+						bif_points_file<<continuation_step<<" "<<tracked_param<<" "<<second_param<<" "<<estimate<<" "<<ritz(lead).real()<<" "<<ritz(lead).imag()<<" "<<distance<<" "<<(sign_change ? "det_sign_change" : "near_singular")<<endl;
+						cout<<"Bifurcation detected near kinvis = "<<estimate<<", refining the step"<<endl;
+						bif_window = bifurcation_deflation_steps;
+						step = max(0.5 * step, max_step / 16.0);
+					}
+					else
+					{
+						if(bif_window > 0)
+							bif_window--;
+						step = min(2.0 * step, max_step);
+					}
+					bif_prev_det_sign = det_sign;
+					bif_prev_param = tracked_param;
+					bif_prev_lead = ritz(lead).real();
+				}
+				
 				if(use_arclength)  // Change of arclength_step to improve the continuation and activate or deactivate deflation when I need it
 				{
 					//if(arclength_step * step_multiplier < max_step)
@@ -3208,7 +3268,7 @@ namespace Nektar
 				int prev_solutions = local_indices_to_be_continued.size();
 				
 				//use_deflation_now = true;
-				use_deflation_now = ((local_indices_to_be_continued.size()<3 && m_kinvis<0.97*second_param)|| (m_kinvis<0.405*second_param && local_indices_to_be_continued.size()<5));
+				use_deflation_now = DeflationWanted(bif_window > 0);
 				for(int i = 0; i < prev_solutions && use_deflation && use_deflation_now && total_solutions_found < m_maxIt; i++)
 				{
 					curr_i = local_indices_to_be_continued[i];
@@ -3249,9 +3309,9 @@ namespace Nektar
 								guess_y = possible_solutions[1];
 							}
 						}
-						use_deflation_now = ((local_indices_to_be_continued.size()<3 && m_kinvis<0.97*second_param)|| (m_kinvis<0.405*second_param && local_indices_to_be_continued.size()<5));
+						use_deflation_now = DeflationWanted(bif_window > 0);
 					}
-					use_deflation_now = ((local_indices_to_be_continued.size()<3 && m_kinvis<0.97*second_param)|| (m_kinvis<0.405*second_param && local_indices_to_be_continued.size()<5));
+					use_deflation_now = DeflationWanted(bif_window > 0);
 				}
 				
 				//here I want to flip the solutions and check if they are different from the previous ones, if so I use them as initial guess trying to converge to new solutions
@@ -3303,6 +3363,11 @@ namespace Nektar
 			}
 			outfile.close();
 			outfile2.close();
+			if(bifurcation_detection)
+			{
+				bif_indicator_file.close();
+				bif_points_file.close();
+			}
 			
 			
 		Array<OneD, Array<OneD, Array<OneD, NekDouble> > > result = Array<OneD, Array<OneD, Array<OneD, NekDouble> > > (2);
@@ -3326,22 +3391,29 @@ namespace Nektar
    
 	std::vector<int> CoupledLinearNS_trafoP::GetFlipperMap(std::vector<double> &x, std::vector<double> &y)
 	{
-		std::vector<int> flipperMap;
-		bool found;
-		double tol = 1e-7, center = 3.75;
-		
-		for(int i = 0; i < x.size(); i++)
+		// the spatial hash is built once per mesh, the maps are cached per reflection axis
+		if(!m_symmetryMap)
 		{
-			found = false;
-			for(int j = 0; j < x.size() && !found; j++)
+			Array<OneD, NekDouble> ax(x.size()), ay(y.size());
+			for(int i = 0; i < x.size(); i++)
 			{
-				if(fabs(x[i]-x[j]) < tol && fabs((y[i]+y[j])/2.-center) < tol)
-				{
-					flipperMap.push_back(j);
-					found = true;
-				}
+				ax[i] = x[i];
+				ay[i] = y[i];
 			}
+			m_symmetryMap = MemoryManager<SymmetryMap>::AllocateSharedPtr(ax, ay);
 		}
+		
+		// default: the horizontal symmetry line y = 3.75 of the sudden expansion channel
+		NekDouble centre_x, centre_y, normal_x, normal_y, tol;
+		m_session->LoadParameter("SymmetryCentreX", centre_x, 0.0);
+		m_session->LoadParameter("SymmetryCentreY", centre_y, 3.75);
+		m_session->LoadParameter("SymmetryNormalX", normal_x, 0.0);
+		m_session->LoadParameter("SymmetryNormalY", normal_y, 1.0);
+		m_session->LoadParameter("SymmetryTolerance", tol, 1e-7);
+		
+		std::vector<int> flipperMap = m_symmetryMap->GetReflection(centre_x, centre_y, normal_x, normal_y, tol);
+		if(m_symmetryMap->GetNumUnmatched() > 0)
+			cout<<"GetFlipperMap: "<<m_symmetryMap->GetNumUnmatched()<<" points without a mirror partner are mapped onto themselves"<<endl;
 		return flipperMap;
 	}
 	
@@ -3712,6 +3784,108 @@ namespace Nektar
 	}
 
 	
+	/// One Oseen step: velocity of the problem linearised around (in_x, in_y).
+	void CoupledLinearNS_trafoP::OseenMap(Array<OneD, NekDouble> in_x, Array<OneD, NekDouble> in_y, Array<OneD, NekDouble> &out_x, Array<OneD, NekDouble> &out_y)
+	{
+		DoInitialiseAdv(in_x, in_y);
+		DoSolve();
+		Array<OneD, MultiRegions::ExpListSharedPtr> m_fields_t = UpdateFields();
+		m_fields_t[0]->BwdTrans(m_fields_t[0]->GetCoeffs(), m_fields_t[0]->UpdatePhys());
+		m_fields_t[1]->BwdTrans(m_fields_t[1]->GetCoeffs(), m_fields_t[1]->UpdatePhys());
+		out_x = Array<OneD, NekDouble> (GetNpoints(), 0.0);
+		out_y = Array<OneD, NekDouble> (GetNpoints(), 0.0);
+		CopyFromPhysField(0, out_x); 
+		CopyFromPhysField(1, out_y);
+	}
+	
+	/**
+	 * Ritz values of the derivative of the Oseen map Phi at the solution u.
+	 * At a fixed point u = Phi(u) one has I - DPhi(u) = Oseen(u)^{-1} J(u), so
+	 * the Navier-Stokes Jacobian J is singular exactly where an eigenvalue of
+	 * DPhi crosses 1. The derivative is applied matrix-free by finite
+	 * differences inside bifurcation_krylov_dim Arnoldi steps, each costing
+	 * one Oseen solve, and the Hessenberg matrix is the reduced Jacobian.
+	 * The Ritz vector closest to 1 seeds the Arnoldi process of the next step.
+	 */
+	Eigen::VectorXcd CoupledLinearNS_trafoP::ReducedJacobianRitzValues(Array<OneD, NekDouble> u_x, Array<OneD, NekDouble> u_y, NekDouble parameter)
+	{
+		int npts = GetNpoints();
+		int m = bifurcation_krylov_dim;
+		int real_Newton = use_Newton;
+		use_Newton = 0; // the Newton map has a vanishing derivative at the solution
+		Set_m_kinvis(parameter);
+		
+		Array<OneD, NekDouble> base_x, base_y, out_x, out_y;
+		Array<OneD, NekDouble> pert_x(npts, 0.0), pert_y(npts, 0.0);
+		OseenMap(u_x, u_y, base_x, base_y);
+		double u_norm = sqrt(Vmath::Dot(npts, u_x, 1, u_x, 1) + Vmath::Dot(npts, u_y, 1, u_y, 1));
+		double eps = 1e-6 * (1.0 + u_norm);
+		
+		Eigen::MatrixXd V = Eigen::MatrixXd::Zero(2*npts, m+1);
+		Eigen::MatrixXd H = Eigen::MatrixXd::Zero(m+1, m);
+		if(bifurcation_start_vector.size() == 2*npts && bifurcation_start_vector.norm() > 0)
+			V.col(0) = bifurcation_start_vector / bifurcation_start_vector.norm();
+		else
+		{
+			Eigen::VectorXd start = Eigen::VectorXd::Random(2*npts);
+			V.col(0) = start / start.norm();
+		}
+		
+		int k_used = m;
+		for(int k = 0; k < m; k++)
+		{
+			for(int i = 0; i < npts; i++)
+			{
+				pert_x[i] = u_x[i] + eps * V(i,k);
+				pert_y[i] = u_y[i] + eps * V(npts+i,k);
+			}
+			OseenMap(pert_x, pert_y, out_x, out_y);
+			Eigen::VectorXd w(2*npts);
+			for(int i = 0; i < npts; i++)
+			{
+				w(i) = (out_x[i] - base_x[i]) / eps;
+				w(npts+i) = (out_y[i] - base_y[i]) / eps;
+			}
+			for(int pass = 0; pass < 2; pass++) // classical Gram-Schmidt with reorthogonalisation
+			{
+				for(int j = 0; j <= k; j++)
+				{
+					double h = V.col(j).dot(w);
+					H(j,k) += h;
+					w -= h * V.col(j);
+				}
+			}
+			H(k+1,k) = w.norm();
+			if(H(k+1,k) < 1e-12) // invariant subspace found
+			{
+				k_used = k+1;
+				break;
+			}
+			V.col(k+1) = w / H(k+1,k);
+		}
+		
+		Eigen::EigenSolver<Eigen::MatrixXd> es(H.topLeftCorner(k_used, k_used));
+		Eigen::VectorXcd ritz = es.eigenvalues();
+		int lead = 0;
+		for(int k = 1; k < ritz.size(); k++)
+		{
+			if(std::abs(1.0 - ritz(k)) < std::abs(1.0 - ritz(lead)))
+				lead = k;
+		}
+		bifurcation_start_vector = (V.leftCols(k_used) * es.eigenvectors().col(lead)).real();
+		
+		use_Newton = real_Newton;
+		return ritz;
+	}
+	
+	/// Switch on deflation close to a detected bifurcation, or with the fixed thresholds of the sudden expansion test case.
+	bool CoupledLinearNS_trafoP::DeflationWanted(bool near_bifurcation)
+	{
+		if(bifurcation_detection)
+			return near_bifurcation;
+		return ((local_indices_to_be_continued.size()<3 && m_kinvis<0.97*second_param)|| (m_kinvis<0.405*second_param && local_indices_to_be_continued.size()<5));
+	}
+	
 	double CoupledLinearNS_trafoP::L2_norm(Array<OneD, NekDouble> u, Array<OneD, NekDouble> v)
 	{
 		double normx = m_fields[0]->L2(u);
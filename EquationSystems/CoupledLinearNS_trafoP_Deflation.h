@@ -37,6 +37,7 @@
 #include "./CoupledLocalToGlobalC0ContMap.h"
 #include "./IncNavierStokes.h"
 #include "./CoupledLinearNS.h"
+#include "./SymmetryMap.h"
 #include <MultiRegions/GlobalLinSys.h>
 #include <MultiRegions/ExpList3DHomogeneous1D.h>
 #include <MultiRegions/ExpList2D.h>
@@ -149,6 +150,7 @@ namespace Nektar
 	Array<OneD, Array<OneD, Array<OneD, NekDouble> > > Continuation_method(Eigen::VectorXd *params);
 	//get a vector with, in position i, the index of its mirrored phys point
 	std::vector<int> GetFlipperMap(std::vector<double> &x, std::vector<double> &y);
+	SymmetryMapSharedPtr m_symmetryMap;
 	//flip each solutions and try to obtain new solutions but different from the previous ones
 	Array<OneD, Array<OneD, NekDouble> > FlipAndCheck(std::vector<int> &flipperMap, int *flipCounter);
 	// write output on a file
@@ -175,6 +177,16 @@ namespace Nektar
 	unsigned int no_total_solve;
 	
 	double L2_norm(Array<OneD, NekDouble> u, Array<OneD, NekDouble> v);
+	
+	// bifurcation detection from the Ritz values of the linearised Oseen map
+	int bifurcation_detection;
+	int bifurcation_krylov_dim;
+	double bifurcation_tolerance;
+	int bifurcation_deflation_steps;
+	Eigen::VectorXd bifurcation_start_vector;
+	void OseenMap(Array<OneD, NekDouble> in_x, Array<OneD, NekDouble> in_y, Array<OneD, NekDouble> &out_x, Array<OneD, NekDouble> &out_y);
+	Eigen::VectorXcd ReducedJacobianRitzValues(Array<OneD, NekDouble> u_x, Array<OneD, NekDouble> u_y, NekDouble parameter);
+	bool DeflationWanted(bool near_bifurcation);
 
     protected:
 
@@ -66,10 +66,17 @@ namespace Nektar
           m_fields(pFields),
           m_pressure(pPressure),
           m_velocity(pVel),
-          m_advObject(advObject)
+          m_advObject(advObject),
+          m_stdMetricNvel(0)
     {      
         m_session->LoadParameter("TimeStep", m_timestep,   0.01);
         m_comm = m_session->GetComm();
+
+        for (int i = 0; i < 3; ++i)
+        {
+            m_stepHistory[i] = m_timestep;
+        }
+        UpdateStepCoeffs();
     }
     
     Extrapolate::~Extrapolate()
@@ -117,7 +124,7 @@ namespace Nektar
             
             // Subtract acceleration term off m_pressureHBCs[nlevels-1]
             Vmath::Svtvp(m_numHBCDof,
-                         -1.0*StifflyStable_Gamma0_Coeffs[order-1]/m_timestep,
+                         -1.0*m_gamma0[order-1]/m_timestep,
                          m_iprodnormvel[0],  1,
                          m_pressureHBCs[m_intSteps-1], 1,
                          m_pressureHBCs[m_intSteps-1], 1);
@@ -880,96 +887,261 @@ namespace Nektar
         // Checking if the problem is 2D
         ASSERTL0(m_curl_dim >= 2, "Method not implemented for 1D");
 
-        int n_points_0      = m_fields[0]->GetExp(0)->GetTotPoints();
         int n_element       = m_fields[0]->GetExpSize();
         int nvel            = inarray.num_elements();
         int cnt;
 
-        NekDouble pntVelocity;
-
-        // Getting the standard velocity vector
-        Array<OneD, Array<OneD, NekDouble> > stdVelocity(nvel);
-        Array<OneD, NekDouble> tmp;
-        Array<OneD, NekDouble> maxV(n_element, 0.0);
-        LibUtilities::PointsKeyVector ptsKeys;
-
-        for (int i = 0; i < nvel; ++i)
+        // The metrics do not change between steps
+        if (nvel != m_stdMetricNvel)
         {
-            stdVelocity[i] = Array<OneD, NekDouble>(n_points_0);
+            BuildStdVelocityMetrics(nvel);
         }
 
-        cnt = 0.0;
+        Array<OneD, NekDouble> maxV(n_element, 0.0);
+        NekDouble *stdVel = m_stdVelWork.get();
+
+        cnt = 0;
         for (int el = 0; el < n_element; ++el)
         {
             int n_points = m_fields[0]->GetExp(el)->GetTotPoints();
-            ptsKeys = m_fields[0]->GetExp(el)->GetPointsKeys();
 
-            // reset local space
-            if(n_points != n_points_0)
+            const NekDouble *u0 = inarray[0].get() + cnt;
+            const NekDouble *u1 = inarray[1].get() + cnt;
+            const NekDouble *u2 = nvel == 3 ? inarray[2].get() + cnt : 0;
+            const NekDouble *g  = m_stdMetrics.get() + m_stdMetricOffset[el];
+
+            // Squared magnitude of the standard velocity
+            // V_j = sum_k g_jk u_k, accumulated component by component
+            for (int q = 0; q < n_points; ++q)
+            {
+                stdVel[q] = 0.0;
+            }
+
+            if (m_stdMetricDeformed[el])
             {
                 for (int j = 0; j < nvel; ++j)
                 {
-                    stdVelocity[j] = Array<OneD, NekDouble>(n_points, 0.0);
+                    const NekDouble *g0 = g + (j*nvel  )*n_points;
+                    const NekDouble *g1 = g + (j*nvel+1)*n_points;
+                    if (nvel == 2)
+                    {
+                        for (int q = 0; q < n_points; ++q)
+                        {
+                            NekDouble v = g0[q]*u0[q] + g1[q]*u1[q];
+                            stdVel[q] += v*v;
+                        }
+                    }
+                    else
+                    {
+                        const NekDouble *g2 = g + (j*nvel+2)*n_points;
+                        for (int q = 0; q < n_points; ++q)
+                        {
+                            NekDouble v = g0[q]*u0[q] + g1[q]*u1[q]
+                                        + g2[q]*u2[q];
+                            stdVel[q] += v*v;
+                        }
+                    }
                 }
-                n_points_0 = n_points;
             }
             else
             {
                 for (int j = 0; j < nvel; ++j)
                 {
-                    Vmath::Zero( n_points, stdVelocity[j], 1);
+                    NekDouble g0 = g[j*nvel];
+                    NekDouble g1 = g[j*nvel+1];
+                    if (nvel == 2)
+                    {
+                        for (int q = 0; q < n_points; ++q)
+                        {
+                            NekDouble v = g0*u0[q] + g1*u1[q];
+                            stdVel[q] += v*v;
+                        }
+                    }
+                    else
+                    {
+                        NekDouble g2 = g[j*nvel+2];
+                        for (int q = 0; q < n_points; ++q)
+                        {
+                            NekDouble v = g0*u0[q] + g1*u1[q] + g2*u2[q];
+                            stdVel[q] += v*v;
+                        }
+                    }
                 }
             }
+            cnt += n_points;
+
+            NekDouble pntVelocity = stdVel[0];
+            for (int q = 1; q < n_points; ++q)
+            {
+                pntVelocity = max(pntVelocity, stdVel[q]);
+            }
+            maxV[el] = sqrt(pntVelocity);
+        }
+
+        return maxV;
+    }
+
+    /**
+     * Stores the derivative factors of every element, as used by
+     * GetMaxStdVelocity, so that the geometric factors are only looked up
+     * once. Deformed elements keep one value per quadrature point,
+     * regular elements a single value per factor.
+     */
+    void Extrapolate::BuildStdVelocityMetrics(const int nvel)
+    {
+        ASSERTL0(nvel == 2 || nvel == 3,
+                 "GetMaxStdVelocity needs two or three velocities");
+
+        int n_element = m_fields[0]->GetExpSize();
+        int nfac      = nvel*nvel;
+        int maxpts    = 0;
+
+        m_stdMetricOffset   = Array<OneD, int>(n_element + 1, 0);
+        m_stdMetricDeformed = Array<OneD, int>(n_element, 0);
+
+        for (int el = 0; el < n_element; ++el)
+        {
+            LocalRegions::ExpansionSharedPtr exp = m_fields[0]->GetExp(el);
+            int n_points = exp->GetTotPoints();
+            maxpts = max(maxpts, n_points);
+
+            m_stdMetricDeformed[el] =
+                exp->GetGeom()->GetMetricInfo()->GetGtype()
+                    == SpatialDomains::eDeformed;
+            m_stdMetricOffset[el+1] = m_stdMetricOffset[el] +
+                nfac * (m_stdMetricDeformed[el] ? n_points : 1);
+        }
+
+        m_stdMetrics = Array<OneD, NekDouble>(m_stdMetricOffset[n_element]);
+        m_stdVelWork = Array<OneD, NekDouble>(maxpts, 0.0);
+
+        for (int el = 0; el < n_element; ++el)
+        {
+            LocalRegions::ExpansionSharedPtr exp = m_fields[0]->GetExp(el);
+            int n_points = exp->GetTotPoints();
 
             Array<TwoD, const NekDouble> gmat =
-                m_fields[0]->GetExp(el)->GetGeom()->GetMetricInfo()->GetDerivFactors(ptsKeys);
+                exp->GetGeom()->GetMetricInfo()->GetDerivFactors(
+                    exp->GetPointsKeys());
 
-            if (m_fields[0]->GetExp(el)->GetGeom()->GetMetricInfo()->GetGtype()
-                == SpatialDomains::eDeformed)
+            NekDouble *g = m_stdMetrics.get() + m_stdMetricOffset[el];
+            for (int j = 0; j < nvel; ++j)
             {
-                for(int j = 0; j < nvel; ++j)
+                for (int k = 0; k < nvel; ++k)
                 {
-                    for(int k = 0; k < nvel; ++k)
+                    if (m_stdMetricDeformed[el])
                     {
-                        Vmath::Vvtvp( n_points,  gmat[k*nvel + j], 1,
-                                                 tmp = inarray[k] + cnt, 1,
-                                                 stdVelocity[j], 1,
-                                                 stdVelocity[j], 1);
+                        Vmath::Vcopy(n_points, &gmat[k*nvel + j][0], 1,
+                                     g + (j*nvel + k)*n_points, 1);
+                    }
+                    else
+                    {
+                        g[j*nvel + k] = gmat[k*nvel + j][0];
                     }
                 }
             }
-            else
+        }
+
+        m_stdMetricNvel = nvel;
+    }
+
+
+    /**
+     * Sets the time step of the coming step. Must be called once per step
+     * when the time step is not constant, so that the extrapolation and
+     * BDF coefficients account for the previous steps.
+     */
+    void Extrapolate::SetTimeStep(const NekDouble timestep)
+    {
+        m_stepHistory[2] = m_stepHistory[1];
+        m_stepHistory[1] = m_stepHistory[0];
+        m_stepHistory[0] = timestep;
+        m_timestep       = timestep;
+
+        UpdateStepCoeffs();
+    }
+
+    /**
+     * Computes the coefficients of order 1 to 3 for the time levels
+     * \f$ t^{n+1}, t^n, t^{n-1}, t^{n-2} \f$ spaced by m_stepHistory:
+     * m_betaq extrapolates from \f$ t^{n-j} \f$ to \f$ t^{n+1} \f$ and
+     * \f$ (m\_gamma0\, u^{n+1} - \sum_j m\_alpha_j u^{n-j})/\Delta t \f$
+     * is the BDF derivative at \f$ t^{n+1} \f$. For equal steps the
+     * StifflyStable tables are used as they are.
+     */
+    void Extrapolate::UpdateStepCoeffs(void)
+    {
+        int  i, j, k, m;
+        bool uniform = m_stepHistory[1] == m_stepHistory[0] &&
+                       m_stepHistory[2] == m_stepHistory[0];
+
+        if (uniform)
+        {
+            for (k = 0; k < 3; ++k)
             {
-                for(int j = 0; j < nvel; ++j)
+                for (j = 0; j < 3; ++j)
                 {
-                    for(int k = 0; k < nvel; ++k)
-                    {
-                        Vmath::Svtvp( n_points,  gmat[k*nvel + j][0],
-                                                 tmp = inarray[k] + cnt, 1,
-                                                 stdVelocity[j], 1,
-                                                 stdVelocity[j], 1);
-                    }
+                    m_betaq[k][j] = StifflyStable_Betaq_Coeffs[k][j];
+                    m_alpha[k][j] = StifflyStable_Alpha_Coeffs[k][j];
                 }
+                m_gamma0[k] = StifflyStable_Gamma0_Coeffs[k];
             }
-            cnt += n_points;
+            return;
+        }
+
+        // Time levels relative to t^{n+1}
+        NekDouble x[4];
+        x[0] = 0.0;
+        for (i = 1; i < 4; ++i)
+        {
+            x[i] = x[i-1] - m_stepHistory[i-1];
+        }
+        NekDouble h = m_stepHistory[0];
 
-            // Calculate total velocity in stdVelocity[0]
-            Vmath::Vmul( n_points, stdVelocity[0], 1, stdVelocity[0], 1,
-                                                      stdVelocity[0], 1);
-            for(int k = 1; k < nvel; ++k)
+        for (k = 0; k < 3; ++k)
+        {
+            int order = k + 1;
+
+            m_gamma0[k] = 0.0;
+            for (m = 1; m <= order; ++m)
             {
-                Vmath::Vvtvp( n_points,  stdVelocity[k], 1,
-                                         stdVelocity[k], 1,
-                                         stdVelocity[0], 1,
-                                         stdVelocity[0], 1);
+                m_gamma0[k] += h / (x[0] - x[m]);
             }
-            pntVelocity = Vmath::Vmax( n_points, stdVelocity[0], 1);
-            maxV[el] = sqrt(pntVelocity);
-        }
 
-        return maxV;
-    }
+            for (j = 0; j < 3; ++j)
+            {
+                m_betaq[k][j] = 0.0;
+                m_alpha[k][j] = 0.0;
+                if (j >= order)
+                {
+                    continue;
+                }
 
+                // Lagrange polynomial of x[j+1] on x[1..order] at x[0]
+                NekDouble beta = 1.0;
+                for (m = 1; m <= order; ++m)
+                {
+                    if (m != j+1)
+                    {
+                        beta *= (x[0] - x[m]) / (x[j+1] - x[m]);
+                    }
+                }
+                m_betaq[k][j] = beta;
+
+                // Derivative at x[0] of the Lagrange polynomial of x[j+1]
+                // on x[0..order]
+                NekDouble deriv = 1.0 / (x[j+1] - x[0]);
+                for (m = 1; m <= order; ++m)
+                {
+                    if (m != j+1)
+                    {
+                        deriv *= (x[0] - x[m]) / (x[j+1] - x[m]);
+                    }
+                }
+                m_alpha[k][j] = -h * deriv;
+            }
+        }
+    }
 
     LibUtilities::TimeIntegrationMethod Extrapolate::v_GetSubStepIntegrationMethod(void)
     {
@@ -993,13 +1165,13 @@ namespace Nektar
         RollOver(array);
 
         // Extrapolate to outarray
-        Vmath::Smul(nPts, StifflyStable_Betaq_Coeffs[nint-1][nint-1],
+        Vmath::Smul(nPts, m_betaq[nint-1][nint-1],
                          array[nint-1],    1,
                          array[nlevels-1], 1);
 
         for(int n = 0; n < nint-1; ++n)
         {
-            Vmath::Svtvp(nPts, StifflyStable_Betaq_Coeffs[nint-1][n],
+            Vmath::Svtvp(nPts, m_betaq[nint-1][n],
                          array[n],1, array[nlevels-1],1,
                          array[nlevels-1],1);
         }
@@ -1023,13 +1195,13 @@ namespace Nektar
         RollOver(array);
 
         // Extrapolate to outarray
-        Vmath::Smul(nPts, StifflyStable_Alpha_Coeffs[nint-1][nint-1],
+        Vmath::Smul(nPts, m_alpha[nint-1][nint-1],
                          array[nint-1],    1,
                          array[nlevels-1], 1);
 
         for(int n = 0; n < nint-1; ++n)
         {
-            Vmath::Svtvp(nPts, StifflyStable_Alpha_Coeffs[nint-1][n],
+            Vmath::Svtvp(nPts, m_alpha[nint-1][n],
                          array[n],1, array[nlevels-1],1,
                          array[nlevels-1],1);
         }
@@ -1059,14 +1231,14 @@ namespace Nektar
             {
                 int acc_order = min(m_pressureCalls-2,m_intSteps);
                 Vmath::Smul(nPts,
-                            StifflyStable_Gamma0_Coeffs[acc_order-1],
+                            m_gamma0[acc_order-1],
                             array[0], 1,
                              accelerationTerm,  1);
                 
                 for(int i = 0; i < acc_order; i++)
                 {
                     Vmath::Svtvp(nPts,
-                                 -1*StifflyStable_Alpha_Coeffs[acc_order-1][i],
+                                 -1*m_alpha[acc_order-1][i],
                                  array[i+1], 1,
                                  accelerationTerm,    1,
                                  accelerationTerm,    1);
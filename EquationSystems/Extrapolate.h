@@ -126,6 +126,8 @@ namespace Nektar
 
         Array<OneD,NekDouble> GetMaxStdVelocity(
             const Array<OneD, Array<OneD,NekDouble> > inarray);
+
+        void SetTimeStep(const NekDouble timestep);
         
 
         void CorrectPressureBCs( const Array<OneD, NekDouble>  &pressure);
@@ -208,6 +210,10 @@ namespace Nektar
 
         void RollOver(Array<OneD, Array<OneD, NekDouble> > &input);
 
+        void BuildStdVelocityMetrics(const int nvel);
+
+        void UpdateStepCoeffs(void);
+
         LibUtilities::SessionReaderSharedPtr m_session;
 
         LibUtilities::CommSharedPtr m_comm;
@@ -268,8 +274,28 @@ namespace Nektar
         static NekDouble StifflyStable_Alpha_Coeffs[3][3];
         static NekDouble StifflyStable_Gamma0_Coeffs[3];
 
+        /// Extrapolation and BDF coefficients of the current step, equal to
+        /// the StifflyStable tables unless the time step has changed
+        /// within the last m_intSteps steps
+        NekDouble m_betaq[3][3];
+        NekDouble m_alpha[3][3];
+        NekDouble m_gamma0[3];
+        /// Last time steps, [0] is the current one
+        NekDouble m_stepHistory[3];
+
         // data related to high order outflow. 
         HighOrderOutflowSharedPtr m_houtflow; 
+
+        /// Number of velocities the GetMaxStdVelocity metrics are built for
+        int m_stdMetricNvel;
+        /// Derivative factors of all elements in standard-element form:
+        /// factor (j,k) of element el starts at m_stdMetricOffset[el] +
+        /// (j*nvel+k)*npoints, with npoints = 1 for regular elements
+        Array<OneD, NekDouble> m_stdMetrics;
+        Array<OneD, int>       m_stdMetricOffset;
+        Array<OneD, int>       m_stdMetricDeformed;
+        /// Work space of GetMaxStdVelocity, size of the largest element
+        Array<OneD, NekDouble> m_stdVelWork;
         
     private:
         static std::string def;
@@ -0,0 +1,280 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File OnlineQueryCache.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: LRU cache of converged reduced solutions of online queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./OnlineQueryCache.h"
+#include <LibUtilities/BasicUtils/ErrorUtil.hpp>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <boost/cstdint.hpp>
+
+namespace Nektar
+{
+    OnlineQueryCache::OnlineQueryCache(const int capacity,
+                                       const NekDouble exactTol,
+                                       const NekDouble warmStartRadius)
+        : m_capacity(capacity > 0 ? capacity : 1),
+          m_exactTol(exactTol),
+          m_warmStartRadius(warmStartRadius),
+          m_numQueries(0),
+          m_numHits(0),
+          m_numWarmStarts(0),
+          m_numEvictions(0)
+    {
+    }
+
+    NekDouble OnlineQueryCache::Distance(const Key &a, const Key &b) const
+    {
+        if (a.size() != b.size())
+        {
+            return std::numeric_limits<NekDouble>::max();
+        }
+        NekDouble dist = 0.0;
+        for (int i = 0; i < a.size(); ++i)
+        {
+            NekDouble scale = std::max(std::fabs(a[i]), 1e-14);
+            dist = std::max(dist, std::fabs(a[i] - b[i]) / scale);
+        }
+        return dist;
+    }
+
+    void OnlineQueryCache::Touch(EntryIter it)
+    {
+        m_lru.splice(m_lru.begin(), m_lru, it);
+    }
+
+    OnlineQueryCache::LookupResult OnlineQueryCache::Find(
+        const Array<OneD, const NekDouble> &param,
+        Eigen::VectorXd &solution)
+    {
+        ++m_numQueries;
+        Key key(param.begin(), param.end());
+
+        std::map<Key, EntryIter>::iterator found = m_index.find(key);
+        if (found != m_index.end())
+        {
+            Touch(found->second);
+            solution = found->second->second;
+            ++m_numHits;
+            return eHit;
+        }
+
+        // the cache holds a few hundred entries at most, a linear scan is
+        // cheaper than a single reduced solve
+        EntryIter closest = m_lru.end();
+        NekDouble minDist = std::numeric_limits<NekDouble>::max();
+        for (EntryIter it = m_lru.begin(); it != m_lru.end(); ++it)
+        {
+            NekDouble dist = Distance(key, it->first);
+            if (dist < minDist)
+            {
+                minDist = dist;
+                closest = it;
+            }
+        }
+        if (closest == m_lru.end() || minDist > m_warmStartRadius)
+        {
+            return eMiss;
+        }
+
+        Touch(closest);
+        solution = closest->second;
+        if (minDist <= m_exactTol)
+        {
+            ++m_numHits;
+            return eHit;
+        }
+        ++m_numWarmStarts;
+        return eWarmStart;
+    }
+
+    void OnlineQueryCache::Insert(const Array<OneD, const NekDouble> &param,
+                                  const Eigen::VectorXd &solution)
+    {
+        Key key(param.begin(), param.end());
+
+        std::map<Key, EntryIter>::iterator found = m_index.find(key);
+        if (found != m_index.end())
+        {
+            found->second->second = solution;
+            Touch(found->second);
+            return;
+        }
+
+        m_lru.push_front(Entry(key, solution));
+        m_index[key] = m_lru.begin();
+
+        if (int(m_lru.size()) > m_capacity)
+        {
+            m_index.erase(m_lru.back().first);
+            m_lru.pop_back();
+            ++m_numEvictions;
+        }
+    }
+
+    namespace
+    {
+        const boost::uint64_t FnvOffset = 14695981039346656037ULL;
+        const boost::uint64_t FnvPrime  = 1099511628211ULL;
+
+        void HashValue(boost::uint64_t &hash, NekDouble value)
+        {
+            // -0.0 and 0.0 hash alike
+            if (value == 0.0)
+            {
+                value = 0.0;
+            }
+            const unsigned char *bytes =
+                reinterpret_cast<const unsigned char *>(&value);
+            for (int i = 0; i < sizeof(NekDouble); ++i)
+            {
+                hash ^= bytes[i];
+                hash *= FnvPrime;
+            }
+        }
+    }
+
+    std::string OnlineQueryCache::Signature(
+        const Eigen::MatrixXd &basis,
+        const Array<OneD, const NekDouble> &lower,
+        const Array<OneD, const NekDouble> &upper)
+    {
+        boost::uint64_t hash = FnvOffset;
+        for (int j = 0; j < basis.cols(); ++j)
+        {
+            for (int i = 0; i < basis.rows(); ++i)
+            {
+                HashValue(hash, basis(i,j));
+            }
+        }
+        for (int i = 0; i < lower.num_elements(); ++i)
+        {
+            HashValue(hash, lower[i]);
+        }
+        for (int i = 0; i < upper.num_elements(); ++i)
+        {
+            HashValue(hash, upper[i]);
+        }
+        std::ostringstream signature;
+        signature << basis.rows() << "x" << basis.cols() << "x"
+                  << lower.num_elements() << ":" << std::hex
+                  << std::setw(16) << std::setfill('0') << hash;
+        return signature.str();
+    }
+
+    void OnlineQueryCache::Save(const std::string &filename,
+                                const std::string &signature) const
+    {
+        std::ofstream outfile(filename.c_str());
+        if (!outfile.is_open())
+        {
+            std::cout << "Unable to open file " << filename << std::endl;
+            return;
+        }
+        int nparam = m_lru.empty() ? 0 : m_lru.front().first.size();
+        int nsol   = m_lru.empty() ? 0 : m_lru.front().second.size();
+        outfile << std::setprecision(17) << signature << "\t" << m_lru.size()
+                << "\t" << nparam << "\t" << nsol << "\n";
+        // least recently used first, so that Load restores the order
+        for (std::list<Entry>::const_reverse_iterator it = m_lru.rbegin();
+             it != m_lru.rend(); ++it)
+        {
+            for (int i = 0; i < nparam; ++i)
+            {
+                outfile << it->first[i] << "\t";
+            }
+            for (int i = 0; i < nsol; ++i)
+            {
+                outfile << it->second(i) << "\t";
+            }
+            outfile << "\n";
+        }
+    }
+
+    bool OnlineQueryCache::Load(const std::string &filename,
+                                const std::string &signature)
+    {
+        std::ifstream infile(filename.c_str());
+        if (!infile.is_open())
+        {
+            return false;
+        }
+        std::string stored;
+        int nentries, nparam, nsol;
+        if (!(infile >> stored >> nentries >> nparam >> nsol))
+        {
+            return false;
+        }
+        if (stored != signature)
+        {
+            std::cout << "OnlineQueryCache: " << filename
+                      << " was written for a different reduced basis or"
+                      << " parameter range, ignored" << std::endl;
+            return false;
+        }
+
+        Array<OneD, NekDouble> param(nparam);
+        Eigen::VectorXd solution(nsol);
+        for (int n = 0; n < nentries; ++n)
+        {
+            for (int i = 0; i < nparam; ++i)
+            {
+                infile >> param[i];
+            }
+            for (int i = 0; i < nsol; ++i)
+            {
+                infile >> solution(i);
+            }
+            if (!infile)
+            {
+                return false;
+            }
+            Insert(param, solution);
+        }
+        return true;
+    }
+
+    void OnlineQueryCache::PrintStats(std::ostream &out) const
+    {
+        out << "OnlineQueryCache: " << m_numQueries << " queries, "
+            << m_numHits << " hits, " << m_numWarmStarts << " warm starts, "
+            << m_numQueries - m_numHits - m_numWarmStarts << " misses, hit rate "
+            << (m_numQueries > 0 ? NekDouble(m_numHits) / m_numQueries : 0.0)
+            << ", " << m_lru.size() << " of " << m_capacity
+            << " entries, " << m_numEvictions << " evictions" << std::endl;
+    }
+}
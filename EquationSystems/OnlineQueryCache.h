@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File OnlineQueryCache.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: LRU cache of converged reduced solutions of online queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_ONLINEQUERYCACHE_H
+#define NEKTAR_SOLVERS_ONLINEQUERYCACHE_H
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <boost/shared_ptr.hpp>
+#include "../Eigen/Dense"
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Nektar
+{
+    class OnlineQueryCache;
+    typedef boost::shared_ptr<OnlineQueryCache> OnlineQueryCacheSharedPtr;
+
+    /**
+     * Bounded cache of converged reduced coefficient vectors, keyed on the
+     * parameter vector of the online query. Find() returns a stored solution
+     * when the query matches a cached parameter up to the exact tolerance,
+     * otherwise the closest cached solution within the warm start radius,
+     * which the caller uses as initial guess of the reduced Picard/Newton
+     * iteration. Distances are measured component-wise relative to the
+     * query, in the max-norm.
+     *
+     * Entries are evicted in least recently used order once the capacity is
+     * reached. Save()/Load() persist the cache in a text file together with
+     * the Signature() of the reduced basis and the parameter box, so that a
+     * file written for another basis or box is rejected.
+     */
+    class OnlineQueryCache
+    {
+    public:
+        enum LookupResult
+        {
+            eMiss,
+            eWarmStart,
+            eHit
+        };
+
+        OnlineQueryCache(const int capacity,
+                         const NekDouble exactTol = 1e-12,
+                         const NekDouble warmStartRadius = 0.1);
+
+        /// Look up a parameter, solution is set on a hit or a warm start.
+        LookupResult Find(const Array<OneD, const NekDouble> &param,
+                          Eigen::VectorXd &solution);
+
+        /// Store the converged solution of a parameter.
+        void Insert(const Array<OneD, const NekDouble> &param,
+                    const Eigen::VectorXd &solution);
+
+        bool Load(const std::string &filename, const std::string &signature);
+        void Save(const std::string &filename,
+                  const std::string &signature) const;
+
+        /// Dimensions of the basis and a 64 bit FNV-1a hash of its entries
+        /// and of the parameter bounds, as a single whitespace-free token.
+        static std::string Signature(const Eigen::MatrixXd &basis,
+                                     const Array<OneD, const NekDouble> &lower,
+                                     const Array<OneD, const NekDouble> &upper);
+
+        int GetSize() const
+        {
+            return m_lru.size();
+        }
+
+        void PrintStats(std::ostream &out) const;
+
+    protected:
+        typedef std::vector<NekDouble>                      Key;
+        typedef std::pair<Key, Eigen::VectorXd>             Entry;
+        typedef std::list<Entry>::iterator                  EntryIter;
+
+        NekDouble Distance(const Key &a, const Key &b) const;
+        void      Touch(EntryIter it);
+
+        int                                 m_capacity;
+        NekDouble                           m_exactTol;
+        NekDouble                           m_warmStartRadius;
+        /// most recently used first
+        std::list<Entry>                    m_lru;
+        std::map<Key, EntryIter>            m_index;
+
+        // statistics
+        int                                 m_numQueries;
+        int                                 m_numHits;
+        int                                 m_numWarmStarts;
+        int                                 m_numEvictions;
+    };
+}
+
+#endif
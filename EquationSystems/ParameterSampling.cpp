@@ -0,0 +1,289 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File ParameterSampling.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Sample sets for N-dimensional parameter spaces
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./ParameterSampling.h"
+#include <LibUtilities/BasicUtils/ErrorUtil.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <cmath>
+
+namespace Nektar
+{
+    namespace
+    {
+        // all multi-indices with entries >= 0 and sum <= budget
+        void SmolyakLevels(const int dim, const int budget,
+                           std::vector<int> &current,
+                           std::vector<std::vector<int> > &levels)
+        {
+            if (int(current.size()) == dim)
+            {
+                levels.push_back(current);
+                return;
+            }
+            for (int l = 0; l <= budget; ++l)
+            {
+                current.push_back(l);
+                SmolyakLevels(dim, budget - l, current, levels);
+                current.pop_back();
+            }
+        }
+
+        // tensor product of the 1D point sets of the given levels, stored as
+        // indices into the finest 1D grid of 2^maxlevel + 1 points
+        void SmolyakTensor(const std::vector<int> &levels,
+                           const int maxlevel,
+                           std::vector<int> &current,
+                           std::set<std::vector<int> > &indices)
+        {
+            int k = current.size();
+            if (k == int(levels.size()))
+            {
+                indices.insert(current);
+                return;
+            }
+            if (levels[k] == 0)
+            {
+                current.push_back(maxlevel > 0 ? 1 << (maxlevel - 1) : 0);
+                SmolyakTensor(levels, maxlevel, current, indices);
+                current.pop_back();
+                return;
+            }
+            int npts   = (1 << levels[k]) + 1;
+            int stride = 1 << (maxlevel - levels[k]);
+            for (int j = 0; j < npts; ++j)
+            {
+                current.push_back(j * stride);
+                SmolyakTensor(levels, maxlevel, current, indices);
+                current.pop_back();
+            }
+        }
+    }
+
+    Array<OneD, Array<OneD, NekDouble> > ParameterSampling::TensorGrid(
+        const Array<OneD, const NekDouble> &lower,
+        const Array<OneD, const NekDouble> &upper,
+        const Array<OneD, const int>       &npoints)
+    {
+        int dim = int(lower.num_elements());
+        ASSERTL0(int(upper.num_elements()) == dim &&
+                 int(npoints.num_elements()) == dim,
+                 "bounds and number of points differ in dimension");
+
+        int ntotal = 1;
+        for (int k = 0; k < dim; ++k)
+        {
+            ASSERTL0(npoints[k] > 0, "need at least one point per direction");
+            ntotal *= npoints[k];
+        }
+
+        Array<OneD, Array<OneD, NekDouble> > samples(ntotal);
+        for (int i = 0; i < ntotal; ++i)
+        {
+            samples[i] = Array<OneD, NekDouble>(dim);
+            // dir0 is the slowest index
+            int rem = i;
+            for (int k = dim - 1; k >= 0; --k)
+            {
+                int ik = rem % npoints[k];
+                rem   /= npoints[k];
+                NekDouble t = (npoints[k] > 1) ?
+                    NekDouble(ik) / (npoints[k] - 1) : 0.5;
+                samples[i][k] = lower[k] + t * (upper[k] - lower[k]);
+            }
+        }
+        return samples;
+    }
+
+    Array<OneD, Array<OneD, NekDouble> > ParameterSampling::SmolyakGrid(
+        const Array<OneD, const NekDouble> &lower,
+        const Array<OneD, const NekDouble> &upper,
+        const int                           level)
+    {
+        int dim = int(lower.num_elements());
+        ASSERTL0(int(upper.num_elements()) == dim, "bounds differ in dimension");
+        ASSERTL0(level >= 0, "Smolyak level has to be non-negative");
+
+        std::vector<std::vector<int> > levels;
+        std::vector<int> current;
+        SmolyakLevels(dim, level, current, levels);
+
+        // nested points coincide exactly on the finest index grid, so the
+        // set removes the duplicates between the tensor products
+        std::set<std::vector<int> > indices;
+        for (int i = 0; i < levels.size(); ++i)
+        {
+            current.clear();
+            SmolyakTensor(levels[i], level, current, indices);
+        }
+
+        int nfinest = 1 << level;
+        std::vector<std::vector<NekDouble> > points;
+        std::set<std::vector<int> >::const_iterator it;
+        for (it = indices.begin(); it != indices.end(); ++it)
+        {
+            std::vector<NekDouble> point(dim);
+            for (int k = 0; k < dim; ++k)
+            {
+                // the centre is kept exact, cos(pi/2) is not zero in
+                // floating point
+                NekDouble t = (2 * (*it)[k] == nfinest || level == 0) ? 0.5 :
+                    0.5 * (1.0 - cos(M_PI * (*it)[k] / nfinest));
+                point[k] = lower[k] + t * (upper[k] - lower[k]);
+            }
+            points.push_back(point);
+        }
+        return ToArray(points);
+    }
+
+    Array<OneD, Array<OneD, NekDouble> > ParameterSampling::LatinHypercube(
+        const Array<OneD, const NekDouble> &lower,
+        const Array<OneD, const NekDouble> &upper,
+        const int                           nsamples,
+        const unsigned int                  seed)
+    {
+        int dim = int(lower.num_elements());
+        ASSERTL0(int(upper.num_elements()) == dim, "bounds differ in dimension");
+        ASSERTL0(nsamples > 0, "need at least one sample");
+
+        boost::random::mt19937 rng(seed);
+        boost::random::uniform_real_distribution<NekDouble> unif(0.0, 1.0);
+
+        std::vector<std::vector<NekDouble> > points(
+            nsamples, std::vector<NekDouble>(dim));
+        std::vector<int> perm(nsamples);
+        for (int k = 0; k < dim; ++k)
+        {
+            for (int i = 0; i < nsamples; ++i)
+            {
+                perm[i] = i;
+            }
+            for (int i = nsamples - 1; i > 0; --i)
+            {
+                boost::random::uniform_int_distribution<int> pick(0, i);
+                std::swap(perm[i], perm[pick(rng)]);
+            }
+            for (int i = 0; i < nsamples; ++i)
+            {
+                NekDouble t = (perm[i] + unif(rng)) / nsamples;
+                points[i][k] = lower[k] + t * (upper[k] - lower[k]);
+            }
+        }
+        std::sort(points.begin(), points.end());
+        return ToArray(points);
+    }
+
+    void ParameterSampling::Write(const std::string &filename,
+        const Array<OneD, const Array<OneD, NekDouble> > &samples)
+    {
+        std::ofstream out(filename.c_str());
+        ASSERTL0(out.is_open(), "Unable to open file " + filename);
+        for (int i = 0; i < samples.num_elements(); ++i)
+        {
+            for (int k = 0; k < samples[i].num_elements(); ++k)
+            {
+                out << std::setprecision(17) << samples[i][k];
+                out << ((k + 1 < samples[i].num_elements()) ? "\t" : "\n");
+            }
+        }
+    }
+
+    Array<OneD, Array<OneD, NekDouble> > ParameterSampling::Read(
+        const std::string &filename,
+        const int          dimension)
+    {
+        std::ifstream in(filename.c_str());
+        ASSERTL0(in.is_open(), "Unable to open file " + filename);
+        std::vector<std::vector<NekDouble> > points;
+        std::vector<NekDouble> point(dimension);
+        while (true)
+        {
+            int k = 0;
+            for (; k < dimension; ++k)
+            {
+                if (!(in >> point[k]))
+                {
+                    break;
+                }
+            }
+            if (k < dimension)
+            {
+                ASSERTL0(k == 0, "incomplete sample in " + filename);
+                break;
+            }
+            points.push_back(point);
+        }
+        return ToArray(points);
+    }
+
+    int ParameterSampling::Closest(
+        const Array<OneD, const NekDouble>               &point,
+        const Array<OneD, const Array<OneD, NekDouble> > &samples)
+    {
+        int       closest = -1;
+        NekDouble min_dist = 0.0;
+        for (int i = 0; i < samples.num_elements(); ++i)
+        {
+            NekDouble dist = 0.0;
+            for (int k = 0; k < point.num_elements(); ++k)
+            {
+                dist += (point[k] - samples[i][k]) * (point[k] - samples[i][k]);
+            }
+            if (closest < 0 || dist < min_dist)
+            {
+                closest  = i;
+                min_dist = dist;
+            }
+        }
+        return closest;
+    }
+
+    Array<OneD, Array<OneD, NekDouble> > ParameterSampling::ToArray(
+        const std::vector<std::vector<NekDouble> > &points)
+    {
+        Array<OneD, Array<OneD, NekDouble> > samples(points.size());
+        for (int i = 0; i < points.size(); ++i)
+        {
+            samples[i] = Array<OneD, NekDouble>(points[i].size());
+            std::copy(points[i].begin(), points[i].end(), samples[i].get());
+        }
+        return samples;
+    }
+}
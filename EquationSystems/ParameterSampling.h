@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File ParameterSampling.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Sample sets for N-dimensional parameter spaces
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_PARAMETERSAMPLING_H
+#define NEKTAR_SOLVERS_PARAMETERSAMPLING_H
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <string>
+#include <vector>
+
+namespace Nektar
+{
+    /**
+     * Generates training and validation points in a box
+     * [lower_0, upper_0] x ... x [lower_{d-1}, upper_{d-1}].
+     *
+     * Every sampler returns one Array of length d per point, ordered
+     * lexicographically with dir0 as the slowest index, i.e. the same
+     * layout as the nested loops over param<i>_dir0 / param<i>_dir1.
+     */
+    class ParameterSampling
+    {
+    public:
+        enum SamplerType
+        {
+            eTensor        = 0,
+            eSmolyak       = 1,
+            eLatinHypercube = 2
+        };
+
+        /// Full tensor grid of equidistant points, npoints[k] in dir k.
+        static Array<OneD, Array<OneD, NekDouble> > TensorGrid(
+            const Array<OneD, const NekDouble> &lower,
+            const Array<OneD, const NekDouble> &upper,
+            const Array<OneD, const int>       &npoints);
+
+        /// Smolyak sparse grid on nested Clenshaw-Curtis points. Level 0 is
+        /// the centre of the box, level l adds the tensor products whose
+        /// 1D levels sum up to at most l.
+        static Array<OneD, Array<OneD, NekDouble> > SmolyakGrid(
+            const Array<OneD, const NekDouble> &lower,
+            const Array<OneD, const NekDouble> &upper,
+            const int                           level);
+
+        /// Latin hypercube design with nsamples points: every one of the
+        /// nsamples strata in each direction holds exactly one point.
+        static Array<OneD, Array<OneD, NekDouble> > LatinHypercube(
+            const Array<OneD, const NekDouble> &lower,
+            const Array<OneD, const NekDouble> &upper,
+            const int                           nsamples,
+            const unsigned int                  seed = 0);
+
+        /// Tab separated, one point per line.
+        static void Write(const std::string &filename,
+            const Array<OneD, const Array<OneD, NekDouble> > &samples);
+
+        /// Reads a file in the format produced by Write().
+        static Array<OneD, Array<OneD, NekDouble> > Read(
+            const std::string &filename,
+            const int          dimension);
+
+        /// Index of the closest sample in the euclidean norm.
+        static int Closest(
+            const Array<OneD, const NekDouble>                 &point,
+            const Array<OneD, const Array<OneD, NekDouble> >   &samples);
+
+    protected:
+        static Array<OneD, Array<OneD, NekDouble> > ToArray(
+            const std::vector<std::vector<NekDouble> > &points);
+    };
+}
+
+#endif
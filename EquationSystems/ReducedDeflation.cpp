@@ -0,0 +1,192 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File ReducedDeflation.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Deflation operator measured in a reduced Gram matrix norm
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./ReducedDeflation.h"
+#include <LibUtilities/BasicUtils/ErrorUtil.hpp>
+#include <cmath>
+
+namespace Nektar
+{
+    namespace
+    {
+        // keeps the operator finite when an iterate lands on a root
+        const NekDouble DistanceFloor = 1e-14;
+    }
+
+    ReducedDeflation::ReducedDeflation()
+        : m_power(2.0),
+          m_shift(1.0),
+          m_distanceScale(1.0)
+    {
+    }
+
+    ReducedDeflation::ReducedDeflation(const Eigen::MatrixXd &gram,
+                                       const NekDouble power,
+                                       const NekDouble shift,
+                                       const NekDouble distanceScale)
+        : m_gram(gram),
+          m_power(power),
+          m_shift(shift),
+          m_distanceScale(distanceScale)
+    {
+        ASSERTL0(gram.rows() == gram.cols(), "Gram matrix has to be square");
+        ASSERTL0(power > 0.0, "deflation power has to be positive");
+        ASSERTL0(shift >= 0.0, "deflation shift has to be non-negative");
+        ASSERTL0(gram.rows() > 0 || power == 1.0 || power == 2.0,
+                 "the Euclidean deflation step supports the powers 1 and 2");
+        if (m_distanceScale <= 0.0)
+        {
+            m_distanceScale = (gram.rows() > 0) ?
+                sqrt(gram.trace() / gram.rows()) : 1.0;
+        }
+    }
+
+    Eigen::VectorXd ReducedDeflation::GramProduct(
+        const Eigen::VectorXd &e) const
+    {
+        return (m_gram.rows() > 0) ? Eigen::VectorXd(m_gram * e) : e;
+    }
+
+    NekDouble ReducedDeflation::Distance(const Eigen::VectorXd &a,
+                                         const Eigen::VectorXd &b) const
+    {
+        Eigen::VectorXd e = a - b;
+        if (m_gram.rows() == 0)
+        {
+            return e.norm();
+        }
+        return sqrt(std::max(e.dot(m_gram * e), 0.0));
+    }
+
+    int ReducedDeflation::Closest(const Eigen::VectorXd              &u,
+                                  const std::vector<Eigen::VectorXd> &solutions,
+                                  const std::vector<int>             &indices,
+                                  NekDouble                          &dist) const
+    {
+        int closest = -1;
+        dist = 1e20;
+        for (int k = 0; k < indices.size(); ++k)
+        {
+            NekDouble d = Distance(u, solutions[indices[k]]);
+            if (d < dist)
+            {
+                dist    = d;
+                closest = indices[k];
+            }
+        }
+        return closest;
+    }
+
+    Eigen::VectorXd ReducedDeflation::LogGradient(
+        const Eigen::VectorXd              &u,
+        const std::vector<Eigen::VectorXd> &solutions,
+        const std::vector<int>             &indices) const
+    {
+        // m_k = d_k^{-p} + s, grad m_k = -p d_k^{-p-2} G e_k
+        Eigen::VectorXd weighted = Eigen::VectorXd::Zero(u.size());
+        for (int k = 0; k < indices.size(); ++k)
+        {
+            Eigen::VectorXd e = u - solutions[indices[k]];
+            NekDouble d   = std::max(Distance(u, solutions[indices[k]]),
+                                     DistanceFloor);
+            NekDouble dmp = pow(d, -m_power);
+            weighted -= (m_power * dmp / (d * d) / (dmp + m_shift)) * e;
+        }
+        return GramProduct(weighted);
+    }
+
+    NekDouble ReducedDeflation::StepScaling(
+        const Eigen::VectorXd              &u,
+        const Eigen::VectorXd              &du,
+        const std::vector<Eigen::VectorXd> &solutions,
+        const std::vector<int>             &indices) const
+    {
+        return 1.0 / (1.0 - LogGradient(u, solutions, indices).dot(du));
+    }
+
+    NekDouble ReducedDeflation::ContinuationStep(
+        const Eigen::VectorXd              &u,
+        const Eigen::VectorXd              &last,
+        const std::vector<Eigen::VectorXd> &solutions,
+        const std::vector<int>             &indices,
+        const NekDouble                    near,
+        const NekDouble                    nearTau,
+        const NekDouble                    minNegativeTau,
+        NekDouble                          &dist) const
+    {
+        int closest = Closest(u, solutions, indices, dist);
+        ASSERTL0(closest >= 0, "deflation needs at least one known solution");
+
+        NekDouble tau;
+        if (m_gram.rows() > 0)
+        {
+            tau = StepScaling(last, u - last, solutions, indices);
+        }
+        else
+        {
+            // original heuristic, derivative of the closest factor only
+            NekDouble scalar_product =
+                -(u - solutions[closest]).dot(u - last);
+            if (m_power == 1.0)
+            {
+                tau = 1 / (1 - 1/(1+1/dist) * scalar_product /
+                           (dist * dist * dist));
+            }
+            else
+            {
+                tau = 2 / (1 - 1/(1+1/dist/dist) * scalar_product /
+                           (dist * dist * dist * dist));
+            }
+        }
+
+        if (dist < Threshold(near))
+        {
+            tau = nearTau;
+        }
+        if (tau < 0 && tau > minNegativeTau)
+        {
+            tau = minNegativeTau;
+        }
+        if (tau > 0 && tau < 0.5)
+        {
+            tau = 0.5;
+        }
+        if (tau > 1)
+        {
+            tau = 1;
+        }
+        return tau;
+    }
+}
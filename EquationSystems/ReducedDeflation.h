@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File ReducedDeflation.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Deflation operator measured in a reduced Gram matrix norm
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_REDUCEDDEFLATION_H
+#define NEKTAR_SOLVERS_REDUCEDDEFLATION_H
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include "../Eigen/Dense"
+#include <vector>
+
+namespace Nektar
+{
+    /**
+     * Deflation operator for the reduced continuation
+     *
+     *   M(u) = prod_k ( ||u - r_k||_G^{-p} + s ),   ||e||_G^2 = e^T G e,
+     *
+     * where r_k are the reduced solutions already found, p the power and
+     * s the shift. G is the Gram matrix of the reduced basis in the mass or
+     * H1 inner product, so the distances coincide with the continuous norm
+     * of the reconstructed velocity difference while costing O(RBsize^2).
+     * An empty G selects the Euclidean norm of the coefficients together
+     * with the original step heuristic of the continuation, for p = 1, 2.
+     *
+     * Newton on the deflated residual M(u) F(u) has the Jacobian
+     * M J + F grad M^T. By Sherman-Morrison its update is the undeflated
+     * update du scaled by tau = 1 / (1 - grad log M(u) . du), which is what
+     * StepScaling returns.
+     *
+     * The distance thresholds of the continuation were tuned for the
+     * Euclidean coefficient norm. Threshold() converts them with the
+     * distance scale, by default sqrt(trace(G) / RBsize), the mean Gram norm
+     * of a unit coefficient vector.
+     */
+    class ReducedDeflation
+    {
+    public:
+        ReducedDeflation();
+
+        ReducedDeflation(const Eigen::MatrixXd &gram,
+                         const NekDouble power = 2.0,
+                         const NekDouble shift = 1.0,
+                         const NekDouble distanceScale = 0.0);
+
+        /// Distance of two reduced solutions in the Gram norm.
+        NekDouble Distance(const Eigen::VectorXd &a,
+                           const Eigen::VectorXd &b) const;
+
+        /// Entry of indices closest to u, its distance is returned in dist.
+        int Closest(const Eigen::VectorXd              &u,
+                    const std::vector<Eigen::VectorXd> &solutions,
+                    const std::vector<int>             &indices,
+                    NekDouble                          &dist) const;
+
+        /// M(u)^{-1} grad M(u).
+        Eigen::VectorXd LogGradient(
+            const Eigen::VectorXd              &u,
+            const std::vector<Eigen::VectorXd> &solutions,
+            const std::vector<int>             &indices) const;
+
+        /// Factor tau of the deflated Newton update tau * du taken at u.
+        NekDouble StepScaling(const Eigen::VectorXd              &u,
+                              const Eigen::VectorXd              &du,
+                              const std::vector<Eigen::VectorXd> &solutions,
+                              const std::vector<int>             &indices) const;
+
+        /// Safeguarded factor tau of the damped update
+        /// tau u + (1 - tau) last of the reduced continuation. Within
+        /// Threshold(near) of a known solution tau is set to nearTau,
+        /// negative values are kept below minNegativeTau and positive ones
+        /// in [0.5, 1]. dist returns the distance of u to the closest
+        /// solution.
+        NekDouble ContinuationStep(
+            const Eigen::VectorXd              &u,
+            const Eigen::VectorXd              &last,
+            const std::vector<Eigen::VectorXd> &solutions,
+            const std::vector<int>             &indices,
+            const NekDouble                    near,
+            const NekDouble                    nearTau,
+            const NekDouble                    minNegativeTau,
+            NekDouble                          &dist) const;
+
+        /// Distance threshold given for the Euclidean coefficient norm,
+        /// measured in the norm of this operator.
+        NekDouble Threshold(const NekDouble euclidean) const
+        {
+            return m_distanceScale * euclidean;
+        }
+
+        const Eigen::MatrixXd &GetGram() const
+        {
+            return m_gram;
+        }
+
+    protected:
+        Eigen::MatrixXd m_gram;
+        NekDouble       m_power;
+        NekDouble       m_shift;
+        NekDouble       m_distanceScale;
+
+        /// G e, or e for the Euclidean norm.
+        Eigen::VectorXd GramProduct(const Eigen::VectorXd &e) const;
+    };
+}
+
+#endif
@@ -0,0 +1,532 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File ReducedModel.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Immutable, reentrant evaluator of the reduced model
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./ReducedModel.h"
+#include <LibUtilities/BasicUtils/ErrorUtil.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace Nektar
+{
+    namespace
+    {
+        const std::string ModelFileTag = "ITHACA_ReducedModel";
+        const int         ModelFileVersion = 2;
+
+        void WriteBlock(std::ofstream &out, const std::string &name,
+                        const Eigen::MatrixXd &mat)
+        {
+            out << name << " " << mat.rows() << " " << mat.cols() << "\n";
+            for (int i = 0; i < mat.rows(); ++i)
+            {
+                for (int j = 0; j < mat.cols(); ++j)
+                {
+                    out << mat(i,j) << " ";
+                }
+                out << "\n";
+            }
+        }
+
+        Eigen::MatrixXd ReadBlock(std::ifstream &in, const std::string &name)
+        {
+            std::string tag;
+            int rows, cols;
+            in >> tag >> rows >> cols;
+            ASSERTL0(in && tag == name,
+                     "Reduced model file: expected block " + name);
+            Eigen::MatrixXd mat(rows, cols);
+            for (int i = 0; i < rows; ++i)
+            {
+                for (int j = 0; j < cols; ++j)
+                {
+                    in >> mat(i,j);
+                }
+            }
+            ASSERTL0(in, "Reduced model file: truncated block " + name);
+            return mat;
+        }
+    }
+
+    NekDouble ChannelGeometryMap(NekDouble w, int elemT, int index)
+    {
+        Eigen::Matrix2d T;
+        if (elemT == 0)
+        {
+            T << 1, 0, 0, 1/w;
+        }
+        else if (elemT == 1)
+        {
+            T << 1, 0, 0, 2/(3-w);
+        }
+        else if (elemT == 2)
+        {
+            T << 1, 0, -(1-w)/2, 1;
+        }
+        else if (elemT == 3)
+        {
+            T << 1, 0, -(w-1)/2, 1;
+        }
+        else if (elemT == 4)
+        {
+            T << 1, 0, 0, 1;
+        }
+
+        if (index == 0)
+        {
+            return 1/(T(0,0)*T(1,1) - T(0,1)*T(1,0)); // 1/det
+        }
+        else if (index == 1)
+        {
+            return T(0,0);
+        }
+        else if (index == 2)
+        {
+            return T(0,1);
+        }
+        else if (index == 3)
+        {
+            return T(1,0);
+        }
+        else if (index == 4)
+        {
+            return T(1,1);
+        }
+        return 0;
+    }
+
+    int ReducedQoI::AddQoI(const std::string &name, const bool average)
+    {
+        m_names.push_back(name);
+        m_average.push_back(average);
+        return m_names.size() - 1;
+    }
+
+    void ReducedQoI::AddPiece(const int index, const int type,
+                              const int group, const NekDouble tx,
+                              const NekDouble ty, const NekDouble area,
+                              const NekDouble lift,
+                              const Eigen::RowVectorXd &row)
+    {
+        ASSERTL0(index >= 0 && index < GetNumQoI(),
+                 "Piece of an unknown quantity of interest");
+        ASSERTL0(m_rows.rows() == 0 || m_rows.cols() == row.size(),
+                 "Pieces of different reduced sizes");
+        const int npieces = GetNumPieces();
+        m_index.push_back(index);
+        m_type.push_back(type);
+        m_group.push_back(group);
+        m_tangentX.push_back(tx);
+        m_tangentY.push_back(ty);
+        m_area.push_back(area);
+        m_lift.conservativeResize(npieces + 1);
+        m_lift(npieces) = lift;
+        m_rows.conservativeResize(npieces + 1, row.size());
+        m_rows.row(npieces) = row;
+    }
+
+    NekDouble ReducedQoI::Scale(GeometryMapFunction geometry,
+                                const NekDouble w, const int piece) const
+    {
+        const int group = m_group[piece];
+        if (m_type[piece] == ePoint || group < 0)
+        {
+            return 1.0;
+        }
+        NekDouble detJ = geometry(w, group, 0);
+        if (m_type[piece] == eVolume)
+        {
+            return detJ;
+        }
+        // J t = det J (Td tx - Tb ty, -Tc tx + Ta ty) for J = T^-1
+        NekDouble Ta = geometry(w, group, 1);
+        NekDouble Tb = geometry(w, group, 2);
+        NekDouble Tc = geometry(w, group, 3);
+        NekDouble Td = geometry(w, group, 4);
+        NekDouble jx = Td * m_tangentX[piece] - Tb * m_tangentY[piece];
+        NekDouble jy = Ta * m_tangentY[piece] - Tc * m_tangentX[piece];
+        return std::abs(detJ) * std::sqrt(jx*jx + jy*jy);
+    }
+
+    Eigen::VectorXd ReducedQoI::Evaluate(GeometryMapFunction geometry,
+                                         const NekDouble w,
+                                         const Eigen::VectorXd &solution) const
+    {
+        const int nqoi = GetNumQoI();
+        Eigen::VectorXd qoi  = Eigen::VectorXd::Zero(nqoi);
+        Eigen::VectorXd area = Eigen::VectorXd::Zero(nqoi);
+        for (int p = 0; p < GetNumPieces(); ++p)
+        {
+            NekDouble scale = Scale(geometry, w, p);
+            qoi(m_index[p])  += scale * (m_lift(p) + m_rows.row(p).dot(solution));
+            area(m_index[p]) += scale * m_area[p];
+        }
+        for (int k = 0; k < nqoi; ++k)
+        {
+            if (m_average[k])
+            {
+                ASSERTL0(area(k) > 0.0,
+                         "Average of " + m_names[k] + " over an empty region");
+                qoi(k) /= area(k);
+            }
+        }
+        return qoi;
+    }
+
+    ReducedModel::ReducedModel(const ReducedOperators &ops,
+                               const NekDouble tol,
+                               const int max_iter,
+                               const bool fixedSize)
+        : m_ops(ops),
+          m_tol(tol),
+          m_maxIter(max_iter),
+          m_fixedSize(fixedSize)
+    {
+        ASSERTL0(m_ops.m_geometry, "Reduced model needs a geometry map");
+        ASSERTL0(m_ops.m_advMatX.size() == m_ops.m_size &&
+                 m_ops.m_advMatY.size() == m_ops.m_size,
+                 "Expected one advection operator per basis function");
+        m_isFixedSize =
+            CreateReducedOseenKernel(m_ops.m_size, m_fixedSize)->IsFixedSize();
+    }
+
+    void ReducedModel::AssembleOperators(const NekDouble w,
+                                         const NekDouble nu,
+                                         Eigen::MatrixXd &mat_const,
+                                         std::vector<Eigen::MatrixXd> &mat_x,
+                                         std::vector<Eigen::MatrixXd> &mat_y,
+                                         Eigen::VectorXd &vec_const,
+                                         Eigen::MatrixXd &vec_x,
+                                         Eigen::MatrixXd &vec_y) const
+    {
+        const int n = m_ops.m_size;
+        mat_const.resize(n, n);
+        mat_x.assign(n, Eigen::MatrixXd(n, n));
+        mat_y.assign(n, Eigen::MatrixXd(n, n));
+        vec_const.resize(n);
+        vec_x.resize(n, n);
+        vec_y.resize(n, n);
+        m_ops.Assemble(w, nu, mat_const, mat_x, mat_y, vec_const, vec_x, vec_y);
+    }
+
+    ReducedOseenKernelSharedPtr ReducedModel::CreateKernel() const
+    {
+        ReducedOseenKernelSharedPtr kernel =
+            CreateReducedOseenKernel(m_ops.m_size, m_fixedSize);
+        kernel->SetProjection(m_ops.m_projX, m_ops.m_projY,
+                              m_ops.m_liftX, m_ops.m_liftY);
+        return kernel;
+    }
+
+    Eigen::VectorXd ReducedModel::Evaluate(
+        const Array<OneD, const NekDouble> &param,
+        int &no_iter) const
+    {
+        return Evaluate(param, m_ops.m_initialProj, no_iter);
+    }
+
+    Eigen::VectorXd ReducedModel::Evaluate(
+        const Array<OneD, const NekDouble> &param,
+        const Eigen::MatrixXd &init_xy_proj,
+        int &no_iter) const
+    {
+        if (!m_threadKernel.get())
+        {
+            m_threadKernel.reset(
+                new ReducedOseenKernelSharedPtr(CreateKernel()));
+        }
+        return Evaluate(param, init_xy_proj, **m_threadKernel, no_iter);
+    }
+
+    Eigen::VectorXd ReducedModel::Evaluate(
+        const Array<OneD, const NekDouble> &param,
+        const Eigen::MatrixXd &init_xy_proj,
+        ReducedOseenKernel &kernel,
+        int &no_iter) const
+    {
+        ASSERTL0(param.num_elements() == 2,
+                 "Reduced model expects the parameter (w, nu)");
+        ASSERTL0(kernel.GetSize() == m_ops.m_size,
+                 "Kernel was not created for this reduced model");
+
+        kernel.SetOperators(m_ops, param[0], param[1]);
+        return kernel.Solve(init_xy_proj, m_tol, m_maxIter, no_iter);
+    }
+
+    Eigen::VectorXd ReducedModel::EvaluateQoI(
+        const Array<OneD, const NekDouble> &param,
+        const Eigen::VectorXd &solution) const
+    {
+        ASSERTL0(param.num_elements() == 2,
+                 "Reduced model expects the parameter (w, nu)");
+        return m_ops.m_qoi.Evaluate(m_ops.m_geometry, param[0], solution);
+    }
+
+    void ReducedModel::ReconstructVelocity(const Eigen::VectorXd &solution,
+                                           Eigen::VectorXd &u,
+                                           Eigen::VectorXd &v) const
+    {
+        ASSERTL0(m_ops.m_modeX.rows() > 0,
+                 "Reduced model was stored without velocity modes");
+        u = m_ops.m_fieldLiftX + m_ops.m_modeX * solution;
+        v = m_ops.m_fieldLiftY + m_ops.m_modeY * solution;
+    }
+
+    void ReducedModel::Save(const std::string &filename) const
+    {
+        ASSERTL0(m_ops.m_geometry == &ChannelGeometryMap,
+                 "Only reduced models on the channel geometry can be saved");
+        std::ofstream out(filename.c_str());
+        ASSERTL0(out.is_open(), "Unable to open file " + filename);
+
+        const int n = m_ops.m_size;
+        const int nelem = m_ops.m_numElem;
+        out << std::setprecision(17);
+        out << ModelFileTag << " " << ModelFileVersion << "\n";
+        out << "geometry channel\n";
+        out << "size " << n << "\n";
+        out << "elements " << nelem << "\n";
+        out << "tolerance " << m_tol << "\n";
+        out << "max_iter " << m_maxIter << "\n";
+        const ReducedQoI &qoi = m_ops.m_qoi;
+        out << "qoi_names " << qoi.GetNumQoI();
+        for (int k = 0; k < qoi.GetNumQoI(); ++k)
+        {
+            out << " " << qoi.m_names[k] << " " << qoi.m_average[k];
+        }
+        out << "\n";
+
+        for (int e = 0; e < nelem; ++e)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                WriteBlock(out, "const_mat", m_ops.m_constMat[e][k]);
+                WriteBlock(out, "abcd_mat",  m_ops.m_abcdMat[e][k]);
+                WriteBlock(out, "const_vec", m_ops.m_constVec[e][k]);
+                WriteBlock(out, "abcd_vec",  m_ops.m_abcdVec[e][k]);
+            }
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            for (int e = 0; e < nelem; ++e)
+            {
+                for (int k = 0; k < 2; ++k)
+                {
+                    WriteBlock(out, "adv_mat_x", m_ops.m_advMatX[i][e][k]);
+                    WriteBlock(out, "adv_mat_y", m_ops.m_advMatY[i][e][k]);
+                    WriteBlock(out, "adv_vec_x", m_ops.m_advVecX[i][e][k]);
+                    WriteBlock(out, "adv_vec_y", m_ops.m_advVecY[i][e][k]);
+                }
+            }
+        }
+        WriteBlock(out, "proj_x",       m_ops.m_projX);
+        WriteBlock(out, "proj_y",       m_ops.m_projY);
+        WriteBlock(out, "lift_x",       m_ops.m_liftX);
+        WriteBlock(out, "lift_y",       m_ops.m_liftY);
+        WriteBlock(out, "initial_proj", m_ops.m_initialProj);
+        Eigen::MatrixXd pieces(qoi.GetNumPieces(), 6);
+        for (int p = 0; p < qoi.GetNumPieces(); ++p)
+        {
+            pieces(p,0) = qoi.m_index[p];
+            pieces(p,1) = qoi.m_type[p];
+            pieces(p,2) = qoi.m_group[p];
+            pieces(p,3) = qoi.m_tangentX[p];
+            pieces(p,4) = qoi.m_tangentY[p];
+            pieces(p,5) = qoi.m_area[p];
+        }
+        WriteBlock(out, "qoi_pieces",   pieces);
+        WriteBlock(out, "qoi_lift",     qoi.m_lift);
+        WriteBlock(out, "qoi",          qoi.m_rows);
+        WriteBlock(out, "mode_x",       m_ops.m_modeX);
+        WriteBlock(out, "mode_y",       m_ops.m_modeY);
+        WriteBlock(out, "field_lift_x", m_ops.m_fieldLiftX);
+        WriteBlock(out, "field_lift_y", m_ops.m_fieldLiftY);
+        WriteBlock(out, "coord_x",      m_ops.m_coordX);
+        WriteBlock(out, "coord_y",      m_ops.m_coordY);
+    }
+
+    ReducedModelSharedPtr ReducedModel::Load(const std::string &filename,
+                                             const bool fixedSize)
+    {
+        std::ifstream in(filename.c_str());
+        ASSERTL0(in.is_open(), "Unable to open file " + filename);
+
+        std::string tag, key, geometry;
+        int version, nqoi;
+        NekDouble tol;
+        int max_iter;
+        ReducedOperators ops;
+        in >> tag >> version;
+        ASSERTL0(in && tag == ModelFileTag && version == ModelFileVersion,
+                 filename + " is not a reduced model file of this version");
+        in >> key >> geometry;
+        ASSERTL0(key == "geometry" && geometry == "channel",
+                 "Unknown geometry map in " + filename);
+        ops.m_geometry = &ChannelGeometryMap;
+        in >> key >> ops.m_size >> key >> ops.m_numElem;
+        in >> key >> tol >> key >> max_iter;
+        in >> key >> nqoi;
+        ASSERTL0(in && key == "qoi_names", "Corrupt header in " + filename);
+        for (int k = 0; k < nqoi; ++k)
+        {
+            std::string name;
+            int average;
+            in >> name >> average;
+            ops.m_qoi.AddQoI(name, average);
+        }
+
+        const int n = ops.m_size;
+        const int nelem = ops.m_numElem;
+        ops.m_constMat.resize(nelem);
+        ops.m_abcdMat.resize(nelem);
+        ops.m_constVec.resize(nelem);
+        ops.m_abcdVec.resize(nelem);
+        for (int e = 0; e < nelem; ++e)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                ops.m_constMat[e].push_back(ReadBlock(in, "const_mat"));
+                ops.m_abcdMat[e].push_back(ReadBlock(in, "abcd_mat"));
+                ops.m_constVec[e].push_back(ReadBlock(in, "const_vec"));
+                ops.m_abcdVec[e].push_back(ReadBlock(in, "abcd_vec"));
+            }
+        }
+        ops.m_advMatX.resize(n);
+        ops.m_advMatY.resize(n);
+        ops.m_advVecX.resize(n);
+        ops.m_advVecY.resize(n);
+        for (int i = 0; i < n; ++i)
+        {
+            ops.m_advMatX[i].resize(nelem);
+            ops.m_advMatY[i].resize(nelem);
+            ops.m_advVecX[i].resize(nelem);
+            ops.m_advVecY[i].resize(nelem);
+            for (int e = 0; e < nelem; ++e)
+            {
+                for (int k = 0; k < 2; ++k)
+                {
+                    ops.m_advMatX[i][e].push_back(ReadBlock(in, "adv_mat_x"));
+                    ops.m_advMatY[i][e].push_back(ReadBlock(in, "adv_mat_y"));
+                    ops.m_advVecX[i][e].push_back(ReadBlock(in, "adv_vec_x"));
+                    ops.m_advVecY[i][e].push_back(ReadBlock(in, "adv_vec_y"));
+                }
+            }
+        }
+        ops.m_projX       = ReadBlock(in, "proj_x");
+        ops.m_projY       = ReadBlock(in, "proj_y");
+        ops.m_liftX       = ReadBlock(in, "lift_x");
+        ops.m_liftY       = ReadBlock(in, "lift_y");
+        ops.m_initialProj = ReadBlock(in, "initial_proj");
+        Eigen::MatrixXd pieces = ReadBlock(in, "qoi_pieces");
+        Eigen::VectorXd qoi_lift = ReadBlock(in, "qoi_lift");
+        Eigen::MatrixXd qoi_rows = ReadBlock(in, "qoi");
+        ASSERTL0(qoi_lift.size() == pieces.rows() &&
+                 qoi_rows.rows() == pieces.rows(),
+                 "Inconsistent quantities of interest in " + filename);
+        for (int p = 0; p < pieces.rows(); ++p)
+        {
+            ops.m_qoi.AddPiece(int(pieces(p,0)), int(pieces(p,1)),
+                               int(pieces(p,2)), pieces(p,3), pieces(p,4),
+                               pieces(p,5), qoi_lift(p), qoi_rows.row(p));
+        }
+        ops.m_modeX       = ReadBlock(in, "mode_x");
+        ops.m_modeY       = ReadBlock(in, "mode_y");
+        ops.m_fieldLiftX  = ReadBlock(in, "field_lift_x");
+        ops.m_fieldLiftY  = ReadBlock(in, "field_lift_y");
+        ops.m_coordX      = ReadBlock(in, "coord_x");
+        ops.m_coordY      = ReadBlock(in, "coord_y");
+
+        return ReducedModelSharedPtr(
+            new ReducedModel(ops, tol, max_iter, fixedSize));
+    }
+
+    namespace
+    {
+        // evaluates all parameters starting at offset, so that concurrent
+        // callers work on different parameters at the same time
+        void EvaluateAll(
+            const ReducedModelSharedPtr &model,
+            const Array<OneD, const Array<OneD, NekDouble> > &params,
+            const int offset,
+            std::vector<Eigen::VectorXd> *results)
+        {
+            const int nparams = params.num_elements();
+            for (int k = 0; k < nparams; ++k)
+            {
+                int i = (k + offset) % nparams;
+                int no_iter;
+                (*results)[i] = model->Evaluate(params[i], no_iter);
+            }
+        }
+    }
+
+    NekDouble CheckConcurrentEvaluation(
+        const ReducedModelSharedPtr &model,
+        const Array<OneD, const Array<OneD, NekDouble> > &params,
+        const int nthreads)
+    {
+        ASSERTL0(nthreads > 0, "Need at least one thread");
+        const int nparams = params.num_elements();
+
+        std::vector<Eigen::VectorXd> serial(nparams);
+        EvaluateAll(model, params, 0, &serial);
+
+        std::vector<std::vector<Eigen::VectorXd> > concurrent(
+            nthreads, std::vector<Eigen::VectorXd>(nparams));
+        boost::thread_group threads;
+        for (int t = 0; t < nthreads; ++t)
+        {
+            threads.create_thread(boost::bind(&EvaluateAll, model,
+                                              boost::cref(params),
+                                              t * nparams / nthreads,
+                                              &concurrent[t]));
+        }
+        threads.join_all();
+
+        NekDouble deviation = 0.0;
+        for (int t = 0; t < nthreads; ++t)
+        {
+            for (int i = 0; i < nparams; ++i)
+            {
+                deviation = std::max(deviation,
+                    (concurrent[t][i] - serial[i]).lpNorm<Eigen::Infinity>());
+            }
+        }
+        return deviation;
+    }
+}
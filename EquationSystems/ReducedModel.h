@@ -0,0 +1,329 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File ReducedModel.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Immutable, reentrant evaluator of the reduced model
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_REDUCEDMODEL_H
+#define NEKTAR_SOLVERS_REDUCEDMODEL_H
+
+#include "./ReducedOseenKernel.h"
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/tss.hpp>
+#include "../Eigen/Dense"
+#include <string>
+#include <vector>
+
+namespace Nektar
+{
+    class ReducedModel;
+    typedef boost::shared_ptr<const ReducedModel> ReducedModelSharedPtr;
+
+    /// det(T)^-1 and the entries of the element map T(w), see below
+    typedef NekDouble (*GeometryMapFunction)(NekDouble w, int elemT,
+                                             int index);
+
+    /// Element maps T(w) of the channel geometry of CoupledLinearNS_TT;
+    /// index 0 returns 1/det(T), indices 1 to 4 the entries of T row-wise.
+    NekDouble ChannelGeometryMap(NekDouble w, int elemT, int index);
+
+    /**
+     * Linear quantities of interest of a reduced solution a on the geometry
+     * of the parameter w. The reduced fields are stored on the reference
+     * geometry, so every quantity is split into pieces that each lie on the
+     * elements of one element map T(w) and carry the scaling of that map,
+     *
+     *   q_k(w, a) = sum_{p of k} s_p(w) (lift_p + rows_p a),
+     *
+     * divided by sum_{p of k} s_p(w) area_p for averages. With the Jacobian
+     * J = T^-1 of the map from the reference to the physical element,
+     * s_p = 1 for point values, s_p = det J for volume integrals and
+     * s_p = |J t_p| for integrals along an edge with reference unit
+     * tangent t_p. Pieces on untransformed elements have group -1.
+     */
+    struct ReducedQoI
+    {
+        enum PieceType
+        {
+            ePoint    = 0,
+            eVolume   = 1,
+            eBoundary = 2
+        };
+
+        std::vector<std::string>   m_names;
+        std::vector<int>           m_average;  // per quantity
+
+        std::vector<int>           m_index;    // per piece: quantity
+        std::vector<int>           m_type;
+        std::vector<int>           m_group;
+        std::vector<NekDouble>     m_tangentX;
+        std::vector<NekDouble>     m_tangentY;
+        std::vector<NekDouble>     m_area;
+        Eigen::VectorXd            m_lift;
+        Eigen::MatrixXd            m_rows;
+
+        int GetNumQoI() const
+        {
+            return m_names.size();
+        }
+
+        int GetNumPieces() const
+        {
+            return m_index.size();
+        }
+
+        /// Appends a quantity without pieces and returns its index.
+        int AddQoI(const std::string &name, const bool average);
+
+        void AddPiece(const int index, const int type, const int group,
+                      const NekDouble tx, const NekDouble ty,
+                      const NekDouble area, const NekDouble lift,
+                      const Eigen::RowVectorXd &row);
+
+        /// Geometry factor s_p(w) of a piece.
+        NekDouble Scale(GeometryMapFunction geometry, const NekDouble w,
+                        const int piece) const;
+
+        Eigen::VectorXd Evaluate(GeometryMapFunction geometry,
+                                 const NekDouble w,
+                                 const Eigen::VectorXd &solution) const;
+    };
+
+    /**
+     * Reduced operators of the geometry-parametrised Oseen problem, copied
+     * out of CoupledLinearNS_TT. For every transformed element e the
+     * operators are split into the pieces multiplied by the entries of the
+     * element map T(w), as in gen_affine_mat_proj_2d; the advection pieces
+     * carry one entry per reduced basis function i.
+     */
+    struct ReducedOperators
+    {
+        typedef std::vector<Eigen::MatrixXd> MatrixPieces;
+        typedef std::vector<Eigen::VectorXd> VectorPieces;
+
+        /// det(T)^-1 and the entries of T for (w, element, index)
+        GeometryMapFunction                        m_geometry;
+
+        int                                        m_size;
+        int                                        m_numElem;
+        std::vector<MatrixPieces>                  m_constMat;  // [e][0..3]
+        std::vector<MatrixPieces>                  m_abcdMat;   // [e][0..3]
+        std::vector<VectorPieces>                  m_constVec;  // [e][0..3]
+        std::vector<VectorPieces>                  m_abcdVec;   // [e][0..3]
+        std::vector<std::vector<MatrixPieces> >    m_advMatX;   // [i][e][0..1]
+        std::vector<std::vector<MatrixPieces> >    m_advMatY;
+        std::vector<std::vector<VectorPieces> >    m_advVecX;
+        std::vector<std::vector<VectorPieces> >    m_advVecY;
+
+        /// velocity projection c = lift + proj a of a reduced solution a
+        Eigen::MatrixXd                            m_projX;
+        Eigen::MatrixXd                            m_projY;
+        Eigen::VectorXd                            m_liftX;
+        Eigen::VectorXd                            m_liftY;
+        /// projected advecting velocity the iteration starts from
+        Eigen::MatrixXd                            m_initialProj;
+
+        /// linear quantities of interest on the geometry of w
+        ReducedQoI                                 m_qoi;
+
+        /// optional velocity at the quadrature points of the reference
+        /// geometry, u = field_lift + mode a; empty if not stored
+        Eigen::MatrixXd                            m_modeX;
+        Eigen::MatrixXd                            m_modeY;
+        Eigen::VectorXd                            m_fieldLiftX;
+        Eigen::VectorXd                            m_fieldLiftY;
+        Eigen::VectorXd                            m_coordX;
+        Eigen::VectorXd                            m_coordY;
+
+        /// Geometry-summed affine terms for (w, nu), see
+        /// ReducedModel::AssembleOperators. The outputs must already have
+        /// m_size rows and columns (mat_x, mat_y m_size entries), so the
+        /// fixed-size storage of ReducedOseenKernel is filled in place.
+        template <typename MatType, typename VecType, typename MatVector>
+        void Assemble(const NekDouble w, const NekDouble nu,
+                      MatType &mat_const, MatVector &mat_x, MatVector &mat_y,
+                      VecType &vec_const, MatType &vec_x,
+                      MatType &vec_y) const
+        {
+            mat_const.setZero();
+            vec_const.setZero();
+            vec_x.setZero();
+            vec_y.setZero();
+            for (int i = 0; i < m_size; ++i)
+            {
+                mat_x[i].setZero();
+                mat_y[i].setZero();
+            }
+
+            for (int e = 0; e < m_numElem; ++e)
+            {
+                NekDouble detT = m_geometry(w, e, 0);
+                NekDouble Ta   = m_geometry(w, e, 1);
+                NekDouble Tb   = m_geometry(w, e, 2);
+                NekDouble Tc   = m_geometry(w, e, 3);
+                NekDouble Td   = m_geometry(w, e, 4);
+                NekDouble c00  = Ta*Ta + Tb*Tb;
+                NekDouble c01  = Ta*Tc + Tb*Td;
+                NekDouble c11  = Tc*Tc + Td*Td;
+                for (int i = 0; i < m_size; ++i)
+                {
+                    mat_x[i] += detT * (Ta * m_advMatX[i][e][0] +
+                                        Tc * m_advMatX[i][e][1]);
+                    mat_y[i] += detT * (Tb * m_advMatY[i][e][0] +
+                                        Td * m_advMatY[i][e][1]);
+                    vec_x.col(i) += detT * (Ta * m_advVecX[i][e][0] +
+                                            Tc * m_advVecX[i][e][1]);
+                    vec_y.col(i) += detT * (Tb * m_advVecY[i][e][0] +
+                                            Td * m_advVecY[i][e][1]);
+                }
+                // pressure terms plus nu times the viscous ones
+                mat_const += detT * (Ta * m_constMat[e][0] +
+                                     Tc * m_constMat[e][1] +
+                                     Tb * m_constMat[e][2] +
+                                     Td * m_constMat[e][3]);
+                mat_const += (nu * detT) * (c00 * m_abcdMat[e][0] +
+                                            c01 * (m_abcdMat[e][1] +
+                                                   m_abcdMat[e][2]) +
+                                            c11 * m_abcdMat[e][3]);
+                vec_const -= detT * (Ta * m_constVec[e][0] +
+                                     Tc * m_constVec[e][1] +
+                                     Tb * m_constVec[e][2] +
+                                     Td * m_constVec[e][3]);
+                vec_const -= (nu * detT) * (c00 * m_abcdVec[e][0] +
+                                            c01 * (m_abcdVec[e][1] +
+                                                   m_abcdVec[e][2]) +
+                                            c11 * m_abcdVec[e][3]);
+            }
+        }
+    };
+
+    /**
+     * Evaluates the reduced model for a parameter (w, nu) without touching
+     * the solver object it was built from. The operators are deep copies and
+     * every method is const, so a single instance can serve any number of
+     * concurrent callers. The Oseen iteration runs in a ReducedOseenKernel
+     * workspace, either one owned by the caller (see CreateKernel) or one
+     * kept per calling thread, so a query does not allocate operators.
+     */
+    class ReducedModel
+    {
+    public:
+        ReducedModel(const ReducedOperators &ops,
+                     const NekDouble tol = 1e-5,
+                     const int max_iter = 100,
+                     const bool fixedSize = true);
+
+        /// Converged reduced solution for param = (w, nu).
+        Eigen::VectorXd Evaluate(const Array<OneD, const NekDouble> &param,
+                                 int &no_iter) const;
+
+        /// Same, starting from the projected advecting velocity init_xy_proj.
+        Eigen::VectorXd Evaluate(const Array<OneD, const NekDouble> &param,
+                                 const Eigen::MatrixXd &init_xy_proj,
+                                 int &no_iter) const;
+
+        /// Same, in a workspace obtained from CreateKernel() of this model.
+        Eigen::VectorXd Evaluate(const Array<OneD, const NekDouble> &param,
+                                 const Eigen::MatrixXd &init_xy_proj,
+                                 ReducedOseenKernel &kernel,
+                                 int &no_iter) const;
+
+        /// Kernel with the velocity projection of this model set, to be
+        /// reused by one thread across queries.
+        ReducedOseenKernelSharedPtr CreateKernel() const;
+
+        /// Quantities of interest of a reduced solution for param = (w, nu).
+        Eigen::VectorXd EvaluateQoI(const Array<OneD, const NekDouble> &param,
+                                    const Eigen::VectorXd &solution) const;
+
+        /// Velocity of a reduced solution at the quadrature points of the
+        /// reference geometry, needs a model with stored modes.
+        void ReconstructVelocity(const Eigen::VectorXd &solution,
+                                 Eigen::VectorXd &u,
+                                 Eigen::VectorXd &v) const;
+
+        /// Write the operators to a text file, only models on the channel
+        /// geometry map can be stored.
+        void Save(const std::string &filename) const;
+
+        /// Read a model written by Save(), no session is needed.
+        static ReducedModelSharedPtr Load(const std::string &filename,
+                                          const bool fixedSize = true);
+
+        /// Geometry-summed affine terms for (w, nu). mat_x[i] and the i-th
+        /// column of vec_x multiply the i-th projected x-velocity
+        /// coefficient, likewise for y; the remainder is in the constants.
+        void AssembleOperators(const NekDouble w, const NekDouble nu,
+                               Eigen::MatrixXd &mat_const,
+                               std::vector<Eigen::MatrixXd> &mat_x,
+                               std::vector<Eigen::MatrixXd> &mat_y,
+                               Eigen::VectorXd &vec_const,
+                               Eigen::MatrixXd &vec_x,
+                               Eigen::MatrixXd &vec_y) const;
+
+        int GetSize() const
+        {
+            return m_ops.m_size;
+        }
+
+        bool IsFixedSize() const
+        {
+            return m_isFixedSize;
+        }
+
+        const ReducedOperators &GetOperators() const
+        {
+            return m_ops;
+        }
+
+    protected:
+        const ReducedOperators  m_ops;
+        const NekDouble         m_tol;
+        const int               m_maxIter;
+        const bool              m_fixedSize;
+        bool                    m_isFixedSize;
+        /// workspace of the calling thread for Evaluate() without a kernel
+        mutable boost::thread_specific_ptr<ReducedOseenKernelSharedPtr>
+                                m_threadKernel;
+    };
+
+    /// Evaluates all params serially and then on nthreads threads sharing
+    /// the model, each starting at a different parameter; returns the
+    /// largest deviation of a concurrent from the serial result.
+    NekDouble CheckConcurrentEvaluation(
+        const ReducedModelSharedPtr &model,
+        const Array<OneD, const Array<OneD, NekDouble> > &params,
+        const int nthreads);
+}
+
+#endif
@@ -0,0 +1,234 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File ReducedOseenKernel.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Reduced Oseen iteration with fixed-size Eigen storage
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./ReducedOseenKernel.h"
+#include "./ReducedModel.h"
+#include <LibUtilities/BasicUtils/ErrorUtil.hpp>
+#include "../Eigen/StdVector"
+
+namespace Nektar
+{
+    namespace
+    {
+        // fixed-size kernels are instantiated up to this basis size; beyond
+        // it the per-mode operator storage grows as N^3 and Eigen's dynamic
+        // kernels are as fast as the unrolled ones
+        const int MaxFixedSize = 16;
+
+        template <int N>
+        class ReducedOseenKernelImpl : public ReducedOseenKernel
+        {
+        public:
+            EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+            typedef Eigen::Matrix<NekDouble, N, N> MatN;
+            typedef Eigen::Matrix<NekDouble, N, 1> VecN;
+            typedef std::vector<MatN, Eigen::aligned_allocator<MatN> > MatNVector;
+
+            ReducedOseenKernelImpl(const int size)
+                : m_size(size),
+                  m_projX(size, size),
+                  m_projY(size, size),
+                  m_liftX(size),
+                  m_liftY(size),
+                  m_matConst(size, size),
+                  m_matX(size, MatN(size, size)),
+                  m_matY(size, MatN(size, size)),
+                  m_vecConst(size),
+                  m_vecX(size, size),
+                  m_vecY(size, size),
+                  m_cx(size),
+                  m_cy(size),
+                  m_mat(size, size),
+                  m_rhs(size),
+                  m_solve(size),
+                  m_prevSolve(size),
+                  m_qr(size, size)
+            {
+                ASSERTL0(N == Eigen::Dynamic || N == size,
+                         "Reduced Oseen kernel instantiated for another size");
+            }
+
+            virtual void SetProjection(const Eigen::MatrixXd &proj_x,
+                                       const Eigen::MatrixXd &proj_y,
+                                       const Eigen::VectorXd &lift_x,
+                                       const Eigen::VectorXd &lift_y)
+            {
+                ASSERTL0(proj_x.rows() == m_size && proj_x.cols() == m_size,
+                         "Projection does not match the reduced basis size");
+                m_projX = proj_x;
+                m_projY = proj_y;
+                m_liftX = lift_x;
+                m_liftY = lift_y;
+            }
+
+            virtual void SetOperators(const Eigen::MatrixXd &mat_const,
+                                      const std::vector<Eigen::MatrixXd> &mat_x,
+                                      const std::vector<Eigen::MatrixXd> &mat_y,
+                                      const Eigen::VectorXd &vec_const,
+                                      const Eigen::MatrixXd &vec_x,
+                                      const Eigen::MatrixXd &vec_y)
+            {
+                ASSERTL0(mat_x.size() == m_size && mat_y.size() == m_size,
+                         "Expected one advection matrix per basis function");
+                m_matConst = mat_const;
+                for (int i = 0; i < m_size; ++i)
+                {
+                    m_matX[i] = mat_x[i];
+                    m_matY[i] = mat_y[i];
+                }
+                m_vecConst = vec_const;
+                m_vecX     = vec_x;
+                m_vecY     = vec_y;
+            }
+
+            virtual void SetOperators(const ReducedOperators &ops,
+                                      const NekDouble w,
+                                      const NekDouble nu)
+            {
+                ASSERTL0(ops.m_size == m_size,
+                         "Reduced operators do not match the kernel size");
+                ops.Assemble(w, nu, m_matConst, m_matX, m_matY,
+                             m_vecConst, m_vecX, m_vecY);
+            }
+
+            virtual Eigen::VectorXd Solve(const Eigen::MatrixXd &init_xy_proj,
+                                          const NekDouble tol,
+                                          const int max_iter,
+                                          int &no_iter)
+            {
+                m_cx = init_xy_proj.col(0);
+                m_cy = init_xy_proj.col(1);
+
+                Assemble(m_cx, m_cy, m_mat, m_rhs);
+                m_solve = m_qr.compute(m_mat).solve(m_rhs);
+
+                NekDouble relative_change_error;
+                no_iter = 0;
+                do
+                {
+                    m_prevSolve = m_solve;
+                    m_cx.noalias() = m_projX * m_solve;
+                    m_cx += m_liftX;
+                    m_cy.noalias() = m_projY * m_solve;
+                    m_cy += m_liftY;
+                    Assemble(m_cx, m_cy, m_mat, m_rhs);
+                    m_solve = m_qr.compute(m_mat).solve(m_rhs);
+                    relative_change_error =
+                        (m_solve - m_prevSolve).norm() / m_prevSolve.norm();
+                    no_iter++;
+                }
+                while (relative_change_error > tol && no_iter < max_iter);
+
+                return m_solve;
+            }
+
+            virtual int GetSize() const
+            {
+                return m_size;
+            }
+
+            virtual bool IsFixedSize() const
+            {
+                return N != Eigen::Dynamic;
+            }
+
+        protected:
+            void Assemble(const VecN &cx, const VecN &cy,
+                          MatN &mat, VecN &rhs) const
+            {
+                mat = m_matConst;
+                for (int i = 0; i < m_size; ++i)
+                {
+                    mat += cx(i) * m_matX[i] + cy(i) * m_matY[i];
+                }
+                rhs = m_vecConst;
+                rhs.noalias() -= m_vecX * cx;
+                rhs.noalias() -= m_vecY * cy;
+            }
+
+            int         m_size;
+            MatN        m_projX;
+            MatN        m_projY;
+            VecN        m_liftX;
+            VecN        m_liftY;
+            MatN        m_matConst;
+            MatNVector  m_matX;
+            MatNVector  m_matY;
+            VecN        m_vecConst;
+            MatN        m_vecX;
+            MatN        m_vecY;
+
+            // iteration workspace
+            VecN        m_cx;
+            VecN        m_cy;
+            MatN        m_mat;
+            VecN        m_rhs;
+            VecN        m_solve;
+            VecN        m_prevSolve;
+            Eigen::ColPivHouseholderQR<MatN> m_qr;
+        };
+
+        template <int N>
+        ReducedOseenKernelSharedPtr CreateFixed(const int size)
+        {
+            if (size == N)
+            {
+                return ReducedOseenKernelSharedPtr(
+                    new ReducedOseenKernelImpl<N>(size));
+            }
+            return CreateFixed<N - 1>(size);
+        }
+
+        template <>
+        ReducedOseenKernelSharedPtr CreateFixed<0>(const int size)
+        {
+            return ReducedOseenKernelSharedPtr(
+                new ReducedOseenKernelImpl<Eigen::Dynamic>(size));
+        }
+    }
+
+    ReducedOseenKernelSharedPtr CreateReducedOseenKernel(const int size,
+                                                         const bool fixedSize)
+    {
+        ASSERTL0(size > 0, "Reduced basis is empty");
+        if (fixedSize && size <= MaxFixedSize)
+        {
+            return CreateFixed<MaxFixedSize>(size);
+        }
+        return ReducedOseenKernelSharedPtr(
+            new ReducedOseenKernelImpl<Eigen::Dynamic>(size));
+    }
+}
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File ReducedOseenKernel.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Reduced Oseen iteration with fixed-size Eigen storage
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_REDUCEDOSEENKERNEL_H
+#define NEKTAR_SOLVERS_REDUCEDOSEENKERNEL_H
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <boost/shared_ptr.hpp>
+#include "../Eigen/Dense"
+#include <vector>
+
+namespace Nektar
+{
+    struct ReducedOperators;
+    class ReducedOseenKernel;
+    typedef boost::shared_ptr<ReducedOseenKernel> ReducedOseenKernelSharedPtr;
+
+    /**
+     * Picard iteration for the reduced Oseen problem of the online phase,
+     * kept entirely in the reduced space. With the velocity projection
+     * c(a) = lift + P a of the reduced solution a, one step solves
+     *
+     *   ( M_0 + sum_i c_x,i M_x,i + c_y,i M_y,i ) a = r_0 - V_x c_x - V_y c_y,
+     *
+     * where M_0, M_x,i, M_y,i, r_0, V_x and V_y are the geometry-summed affine
+     * terms of the current parameter, set once per query by SetOperators().
+     *
+     * CreateReducedOseenKernel() instantiates the iteration on fixed-size
+     * Eigen types for the small basis sizes, so every operator and temporary
+     * has compile-time dimensions and no heap allocation happens inside the
+     * iteration. Larger bases, or fixedSize = false, use the dynamic-size
+     * instantiation of the same code, sized once at construction.
+     *
+     * A kernel is a workspace: it is reused across queries but must not be
+     * shared between threads.
+     */
+    class ReducedOseenKernel
+    {
+    public:
+        virtual ~ReducedOseenKernel()
+        {
+        }
+
+        /// Velocity projection of the reduced solution, once per basis.
+        virtual void SetProjection(const Eigen::MatrixXd &proj_x,
+                                   const Eigen::MatrixXd &proj_y,
+                                   const Eigen::VectorXd &lift_x,
+                                   const Eigen::VectorXd &lift_y) = 0;
+
+        /// Affine terms of the current parameter, mat_x/mat_y hold one
+        /// matrix per basis function, vec_x/vec_y one column each.
+        virtual void SetOperators(const Eigen::MatrixXd &mat_const,
+                                  const std::vector<Eigen::MatrixXd> &mat_x,
+                                  const std::vector<Eigen::MatrixXd> &mat_y,
+                                  const Eigen::VectorXd &vec_const,
+                                  const Eigen::MatrixXd &vec_x,
+                                  const Eigen::MatrixXd &vec_y) = 0;
+
+        /// Same, summed over the element maps of w straight from the
+        /// pieces in ops into the kernel's own storage.
+        virtual void SetOperators(const ReducedOperators &ops,
+                                  const NekDouble w,
+                                  const NekDouble nu) = 0;
+
+        /// Iterate from the velocity projection init_xy_proj until the
+        /// relative change of the reduced solution drops below tol.
+        virtual Eigen::VectorXd Solve(const Eigen::MatrixXd &init_xy_proj,
+                                      const NekDouble tol,
+                                      const int max_iter,
+                                      int &no_iter) = 0;
+
+        virtual int  GetSize() const = 0;
+        virtual bool IsFixedSize() const = 0;
+    };
+
+    ReducedOseenKernelSharedPtr CreateReducedOseenKernel(
+        const int size, const bool fixedSize = true);
+}
+
+#endif
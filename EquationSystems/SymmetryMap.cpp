@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File SymmetryMap.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Reflection partners of quadrature points via a spatial hash
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./SymmetryMap.h"
+#include <LibUtilities/BasicUtils/ErrorUtil.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace Nektar
+{
+    SymmetryMap::SymmetryMap(const Array<OneD, const NekDouble> &x,
+                             const Array<OneD, const NekDouble> &y)
+        : m_x(x.num_elements()),
+          m_y(y.num_elements()),
+          m_cellsize(0.0),
+          m_numUnmatched(0)
+    {
+        ASSERTL0(x.num_elements() == y.num_elements(),
+                 "coordinate arrays differ in length");
+        int npts = x.num_elements();
+        for (int i = 0; i < npts; ++i)
+        {
+            m_x[i] = x[i];
+            m_y[i] = y[i];
+        }
+    }
+
+    SymmetryMap::CellKey SymmetryMap::Cell(const NekDouble px,
+                                           const NekDouble py) const
+    {
+        return CellKey(int(floor((px - m_xmin) / m_cellsize)),
+                       int(floor((py - m_ymin) / m_cellsize)));
+    }
+
+    void SymmetryMap::BuildCells(const NekDouble cellsize)
+    {
+        int npts = m_x.num_elements();
+        m_xmin = npts > 0 ? *std::min_element(m_x.begin(), m_x.end()) : 0.0;
+        m_ymin = npts > 0 ? *std::min_element(m_y.begin(), m_y.end()) : 0.0;
+        m_cellsize = cellsize;
+        m_cells.clear();
+        for (int i = 0; i < npts; ++i)
+        {
+            m_cells[Cell(m_x[i], m_y[i])].push_back(i);
+        }
+    }
+
+    const std::vector<int> &SymmetryMap::GetReflection(const NekDouble cx,
+                                                       const NekDouble cy,
+                                                       const NekDouble nx,
+                                                       const NekDouble ny,
+                                                       const NekDouble tol)
+    {
+        NekDouble nlen = sqrt(nx*nx + ny*ny);
+        ASSERTL0(nlen > 0.0, "reflection normal must not vanish");
+        ASSERTL0(tol > 0.0, "matching tolerance has to be positive");
+
+        std::vector<NekDouble> key(5);
+        key[0] = cx;
+        key[1] = cy;
+        key[2] = nx / nlen;
+        key[3] = ny / nlen;
+        key[4] = tol;
+        std::map<std::vector<NekDouble>, Reflection>::iterator it =
+            m_cache.find(key);
+        if (it != m_cache.end())
+        {
+            m_numUnmatched = it->second.m_numUnmatched;
+            return it->second.m_partner;
+        }
+
+        int npts = m_x.num_elements();
+        if (m_cellsize < tol)
+        {
+            // about one point per cell on a uniform cloud, never below tol
+            NekDouble xmax = npts > 0 ? *std::max_element(m_x.begin(), m_x.end()) : 0.0;
+            NekDouble ymax = npts > 0 ? *std::max_element(m_y.begin(), m_y.end()) : 0.0;
+            NekDouble xmin = npts > 0 ? *std::min_element(m_x.begin(), m_x.end()) : 0.0;
+            NekDouble ymin = npts > 0 ? *std::min_element(m_y.begin(), m_y.end()) : 0.0;
+            NekDouble extent = std::max(xmax - xmin, ymax - ymin);
+            BuildCells(std::max(tol, extent / std::max(1.0, sqrt(NekDouble(npts)))));
+        }
+
+        Reflection &reflection = m_cache[key];
+        std::vector<int> &partner = reflection.m_partner;
+        partner.resize(npts);
+        m_numUnmatched = 0;
+        for (int i = 0; i < npts; ++i)
+        {
+            NekDouble dist = (m_x[i] - cx)*key[2] + (m_y[i] - cy)*key[3];
+            NekDouble rx   = m_x[i] - 2.0*dist*key[2];
+            NekDouble ry   = m_y[i] - 2.0*dist*key[3];
+            CellKey   c    = Cell(rx, ry);
+
+            int       found = -1;
+            NekDouble best  = tol;
+            for (int di = -1; di <= 1; ++di)
+            {
+                for (int dj = -1; dj <= 1; ++dj)
+                {
+                    CellMap::const_iterator cell =
+                        m_cells.find(CellKey(c.first + di, c.second + dj));
+                    if (cell == m_cells.end())
+                    {
+                        continue;
+                    }
+                    for (int k = 0; k < cell->second.size(); ++k)
+                    {
+                        int j = cell->second[k];
+                        NekDouble d = std::max(fabs(m_x[j] - rx),
+                                               fabs(m_y[j] - ry));
+                        // duplicated points on element edges: keep the lowest index
+                        if (d < best || (d == best && found >= 0 && j < found))
+                        {
+                            best  = d;
+                            found = j;
+                        }
+                    }
+                }
+            }
+
+            if (found < 0)
+            {
+                found = i;
+                ++m_numUnmatched;
+            }
+            partner[i] = found;
+        }
+        reflection.m_numUnmatched = m_numUnmatched;
+        return partner;
+    }
+}
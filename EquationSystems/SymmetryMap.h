@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File SymmetryMap.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Reflection partners of quadrature points via a spatial hash
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_SYMMETRYMAP_H
+#define NEKTAR_SOLVERS_SYMMETRYMAP_H
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <map>
+#include <vector>
+
+namespace Nektar
+{
+    class SymmetryMap;
+    typedef boost::shared_ptr<SymmetryMap> SymmetryMapSharedPtr;
+
+    /**
+     * Maps every point of a 2D point cloud to its mirror image across the
+     * line through (cx, cy) with normal (nx, ny). The points are bucketed
+     * once in a hashed uniform grid whose cell size is at least the
+     * matching tolerance, so each lookup only inspects the 3x3 cells around
+     * the reflected point and the whole map costs O(N) expected time
+     * instead of O(N^2).
+     *
+     * One object is meant to live as long as the mesh; the maps are cached
+     * per reflection axis and tolerance.
+     */
+    class SymmetryMap
+    {
+    public:
+        SymmetryMap(const Array<OneD, const NekDouble> &x,
+                    const Array<OneD, const NekDouble> &y);
+
+        /// Index of the mirror point of every point. Points without a
+        /// partner within tol are mapped onto themselves.
+        const std::vector<int> &GetReflection(const NekDouble cx,
+                                              const NekDouble cy,
+                                              const NekDouble nx,
+                                              const NekDouble ny,
+                                              const NekDouble tol);
+
+        /// Number of points left unmatched by the map GetReflection
+        /// returned last.
+        int GetNumUnmatched() const
+        {
+            return m_numUnmatched;
+        }
+
+    protected:
+        typedef std::pair<int, int>                            CellKey;
+        typedef boost::unordered_map<CellKey, std::vector<int> > CellMap;
+
+        struct Reflection
+        {
+            std::vector<int> m_partner;
+            int              m_numUnmatched;
+        };
+
+        void BuildCells(const NekDouble cellsize);
+
+        CellKey Cell(const NekDouble px, const NekDouble py) const;
+
+        Array<OneD, NekDouble>                           m_x;
+        Array<OneD, NekDouble>                           m_y;
+        NekDouble                                        m_xmin;
+        NekDouble                                        m_ymin;
+        NekDouble                                        m_cellsize;
+        CellMap                                          m_cells;
+        std::map<std::vector<NekDouble>, Reflection>     m_cache;
+        int                                              m_numUnmatched;
+    };
+}
+
+#endif
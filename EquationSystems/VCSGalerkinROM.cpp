@@ -0,0 +1,583 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File VCSGalerkinROM.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: POD-Galerkin reduced order model of the velocity correction
+// scheme for the Incompressible Navier Stokes equations
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./VCSGalerkinROM.h"
+#include <LibUtilities/BasicUtils/Timer.h>
+#include <iomanip>
+#include <deque>
+
+using namespace std;
+
+namespace Nektar
+{
+    string VCSGalerkinROM::className = 
+        SolverUtils::GetEquationSystemFactory().RegisterCreatorFunction(
+            "VCSGalerkinROM", 
+            VCSGalerkinROM::create);
+
+    VCSGalerkinROM::VCSGalerkinROM(
+            const LibUtilities::SessionReaderSharedPtr& pSession)
+        : UnsteadySystem(pSession),
+          VelocityCorrectionScheme(pSession)  
+    {
+
+    }
+
+    VCSGalerkinROM::~VCSGalerkinROM()
+    {
+
+    }
+
+    void VCSGalerkinROM::v_InitObject()
+    {
+        VelocityCorrectionScheme::v_InitObject();
+
+        m_nvel = m_velocity.num_elements();
+
+        switch(m_intScheme->GetIntegrationMethod())
+        {
+            case LibUtilities::eIMEXOrder1:
+            {
+                m_order = 1;
+            }
+            break;
+            case LibUtilities::eIMEXOrder2:
+            {
+                m_order = 2;
+            }
+            break;
+            case LibUtilities::eIMEXOrder3:
+            {
+                m_order = 3;
+            }
+            break;
+            default:
+            {
+                ASSERTL0(false, "VCSGalerkinROM supports IMEXOrder1, "
+                                "IMEXOrder2 and IMEXOrder3.");
+            }
+        }
+
+        if (m_session->DefinesParameter("ROM_trajectory_steps"))
+        {
+            m_trajectorySteps = m_session->GetParameter("ROM_trajectory_steps");
+        }
+        else
+        {
+            m_trajectorySteps = 1;
+        }
+        if (m_session->DefinesParameter("ROM_write_fld"))
+        {
+            m_writeFld = m_session->GetParameter("ROM_write_fld");
+        }
+        else
+        {
+            m_writeFld = false;
+        }
+        if (m_session->DefinesParameter("ROM_compare_FOM"))
+        {
+            m_compareFOM = m_session->GetParameter("ROM_compare_FOM");
+        }
+        else
+        {
+            m_compareFOM = false;
+        }
+    }
+
+    void VCSGalerkinROM::v_DoSolve()
+    {
+        LibUtilities::Timer timer;
+
+        timer.Start();
+        BuildReducedModel();
+        timer.Stop();
+        if (m_comm->GetRank() == 0)
+        {
+            cout << "ROM offline phase: " << m_nmodes << " modes, "
+                 << timer.TimePerTest(1) << " s" << endl;
+        }
+
+        timer.Start();
+        SolveReducedModel();
+        timer.Stop();
+        m_romTime = timer.TimePerTest(1);
+        if (m_comm->GetRank() == 0)
+        {
+            cout << "ROM online phase: " << m_steps << " steps, "
+                 << m_romTime << " s" << endl;
+        }
+
+        if (!m_compareFOM)
+        {
+            return;
+        }
+
+        if (m_comm->GetRank() == 0)
+        {
+            m_compareFile.open((m_sessionName + "_rom_vs_fom.txt").c_str());
+            m_compareFile << "# time  rel_L2_error_ROM  rel_L2_error_projection"
+                          << endl;
+        }
+
+        timer.Start();
+        UnsteadySystem::v_DoSolve();
+        timer.Stop();
+
+        if (m_comm->GetRank() == 0)
+        {
+            m_compareFile.close();
+            cout << "FOM: " << m_steps << " steps, " << timer.TimePerTest(1)
+                 << " s, speed-up of the ROM online phase "
+                 << timer.TimePerTest(1) / m_romTime << endl;
+        }
+    }
+
+    /**
+     * Method of snapshots on the velocity fluctuations in the L2 inner
+     * product, followed by the Galerkin projection of the convective and
+     * viscous terms.
+     */
+    void VCSGalerkinROM::BuildReducedModel()
+    {
+        int nq = m_fields[0]->GetNpoints();
+        int nsnap = m_session->GetParameter("number_of_snapshots");
+        ASSERTL0(nsnap > 1, "VCSGalerkinROM needs at least two snapshots.");
+
+        std::vector<std::string> fieldStr;
+        for (int v = 0; v < m_nvel; ++v)
+        {
+            fieldStr.push_back(m_session->GetVariable(m_velocity[v]));
+        }
+
+        // load the snapshots and subtract their mean
+        Array<OneD, VelField> snap(nsnap);
+        m_mean = VelField(m_nvel);
+        for (int v = 0; v < m_nvel; ++v)
+        {
+            m_mean[v] = Array<OneD, NekDouble>(nq, 0.0);
+        }
+        for (int i = 0; i < nsnap; ++i)
+        {
+            std::stringstream sstm;
+            sstm << "TestSnap" << i+1;
+            snap[i] = VelField(m_nvel);
+            for (int v = 0; v < m_nvel; ++v)
+            {
+                snap[i][v] = Array<OneD, NekDouble>(nq, 0.0);
+            }
+            EvaluateFunction(fieldStr, snap[i], sstm.str());
+            for (int v = 0; v < m_nvel; ++v)
+            {
+                Vmath::Svtvp(nq, 1.0 / nsnap, snap[i][v], 1,
+                             m_mean[v], 1, m_mean[v], 1);
+            }
+        }
+        for (int i = 0; i < nsnap; ++i)
+        {
+            for (int v = 0; v < m_nvel; ++v)
+            {
+                Vmath::Vsub(nq, snap[i][v], 1, m_mean[v], 1, snap[i][v], 1);
+            }
+        }
+
+        Eigen::MatrixXd gram(nsnap, nsnap);
+        for (int i = 0; i < nsnap; ++i)
+        {
+            for (int j = 0; j <= i; ++j)
+            {
+                gram(i, j) = gram(j, i) = InnerProduct(snap[i], snap[j]);
+            }
+        }
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eig(gram);
+        // eigenvalues come in increasing order
+        Eigen::VectorXd lambda = eig.eigenvalues().reverse();
+        Eigen::MatrixXd coeffs = eig.eigenvectors().rowwise().reverse();
+
+        if (m_session->DefinesParameter("ROM_modes"))
+        {
+            m_nmodes = m_session->GetParameter("ROM_modes");
+        }
+        else
+        {
+            NekDouble POD_tolerance = 0.9999;
+            if (m_session->DefinesParameter("POD_tolerance"))
+            {
+                POD_tolerance = m_session->GetParameter("POD_tolerance");
+            }
+            m_nmodes = 1;
+            NekDouble energy = 0.0;
+            for (int k = 0; k < nsnap - 1; ++k)
+            {
+                energy += lambda(k) / lambda.sum();
+                if (energy < POD_tolerance)
+                {
+                    m_nmodes = k + 2;
+                }
+            }
+        }
+        m_nmodes = min(m_nmodes, nsnap - 1);
+        ASSERTL0(lambda(m_nmodes - 1) > 0.0,
+                 "Snapshots do not support the requested number of modes.");
+
+        m_modes = Array<OneD, VelField>(m_nmodes);
+        for (int k = 0; k < m_nmodes; ++k)
+        {
+            m_modes[k] = VelField(m_nvel);
+            for (int v = 0; v < m_nvel; ++v)
+            {
+                m_modes[k][v] = Array<OneD, NekDouble>(nq, 0.0);
+                for (int i = 0; i < nsnap; ++i)
+                {
+                    Vmath::Svtvp(nq, coeffs(i, k) / sqrt(lambda(k)),
+                                 snap[i][v], 1,
+                                 m_modes[k][v], 1, m_modes[k][v], 1);
+                }
+            }
+        }
+
+        // gradients of the mean and of the modes
+        Array<OneD, VelField> gradMean;
+        Gradient(m_mean, gradMean);
+        Array<OneD, Array<OneD, VelField> > gradModes(m_nmodes);
+        for (int k = 0; k < m_nmodes; ++k)
+        {
+            Gradient(m_modes[k], gradModes[k]);
+        }
+
+        VelField conv(m_nvel), conv2(m_nvel);
+        for (int v = 0; v < m_nvel; ++v)
+        {
+            conv[v]  = Array<OneD, NekDouble>(nq);
+            conv2[v] = Array<OneD, NekDouble>(nq);
+        }
+
+        // constant term
+        m_romC = Eigen::VectorXd(m_nmodes);
+        Convection(m_mean, gradMean, conv);
+        for (int i = 0; i < m_nmodes; ++i)
+        {
+            m_romC(i) = -InnerProduct(m_modes[i], conv)
+                - m_kinvis * GradInnerProduct(gradModes[i], gradMean);
+        }
+
+        // linear terms
+        m_romL = Eigen::MatrixXd(m_nmodes, m_nmodes);
+        m_romK = Eigen::MatrixXd(m_nmodes, m_nmodes);
+        for (int j = 0; j < m_nmodes; ++j)
+        {
+            Convection(m_mean, gradModes[j], conv);
+            Convection(m_modes[j], gradMean, conv2);
+            for (int v = 0; v < m_nvel; ++v)
+            {
+                Vmath::Vadd(nq, conv[v], 1, conv2[v], 1, conv[v], 1);
+            }
+            for (int i = 0; i < m_nmodes; ++i)
+            {
+                m_romL(i, j) = -InnerProduct(m_modes[i], conv);
+                m_romK(i, j) = -m_kinvis *
+                    GradInnerProduct(gradModes[i], gradModes[j]);
+            }
+        }
+
+        // quadratic term, column j*m_nmodes+k holds (phi_j . grad) phi_k
+        m_romQ = Eigen::MatrixXd(m_nmodes, m_nmodes * m_nmodes);
+        for (int j = 0; j < m_nmodes; ++j)
+        {
+            for (int k = 0; k < m_nmodes; ++k)
+            {
+                Convection(m_modes[j], gradModes[k], conv);
+                for (int i = 0; i < m_nmodes; ++i)
+                {
+                    m_romQ(i, j * m_nmodes + k) =
+                        -InnerProduct(m_modes[i], conv);
+                }
+            }
+        }
+    }
+
+    Eigen::VectorXd VCSGalerkinROM::ReducedRHS(const Eigen::VectorXd &a)
+    {
+        Eigen::VectorXd aa(m_nmodes * m_nmodes);
+        for (int j = 0; j < m_nmodes; ++j)
+        {
+            aa.segment(j * m_nmodes, m_nmodes) = a(j) * a;
+        }
+        return m_romC + m_romL * a + m_romQ * aa;
+    }
+
+    /**
+     * Stiffly stable IMEX scheme with the coefficients of the velocity
+     * correction scheme; the order is raised during the first steps in the
+     * same way.
+     */
+    void VCSGalerkinROM::SolveReducedModel()
+    {
+        static const NekDouble gamma0[3]   = {1.0, 1.5, 11.0/6.0};
+        static const NekDouble alpha[3][3] = {{1.0,  0.0, 0.0},
+                                              {2.0, -0.5, 0.0},
+                                              {3.0, -1.5, 1.0/3.0}};
+        static const NekDouble beta[3][3]  = {{1.0,  0.0, 0.0},
+                                              {2.0, -1.0, 0.0},
+                                              {3.0, -3.0, 1.0}};
+
+        Eigen::MatrixXd I = Eigen::MatrixXd::Identity(m_nmodes, m_nmodes);
+        std::vector<Eigen::PartialPivLU<Eigen::MatrixXd> > lhs(m_order);
+        for (int q = 0; q < m_order; ++q)
+        {
+            lhs[q].compute(gamma0[q] * I - m_timestep * m_romK);
+        }
+
+        int nq = m_fields[0]->GetNpoints();
+        VelField u0(m_nvel);
+        for (int v = 0; v < m_nvel; ++v)
+        {
+            u0[v] = Array<OneD, NekDouble>(nq);
+            Vmath::Vcopy(nq, m_fields[m_velocity[v]]->GetPhys(), 1, u0[v], 1);
+        }
+        Eigen::VectorXd a = Project(u0);
+
+        // newest first
+        std::deque<Eigen::VectorXd> aHist, nHist;
+        aHist.push_front(a);
+        nHist.push_front(ReducedRHS(a));
+
+        m_trajectory.clear();
+        if (m_compareFOM)
+        {
+            m_trajectory.push_back(a);
+        }
+
+        std::ofstream trajFile;
+        if (m_comm->GetRank() == 0)
+        {
+            trajFile.open((m_sessionName + "_rom_coeffs.txt").c_str());
+            trajFile << "# time  a_0 ... a_" << m_nmodes - 1 << endl;
+            trajFile << std::setprecision(12) << m_time << " "
+                     << a.transpose() << endl;
+        }
+
+        int nchk = 0;
+        NekDouble time = m_time;
+        for (int n = 0; n < m_steps; ++n)
+        {
+            int order = min(n + 1, m_order);
+            Eigen::VectorXd rhs = Eigen::VectorXd::Zero(m_nmodes);
+            for (int q = 0; q < order; ++q)
+            {
+                rhs += alpha[order-1][q] * aHist[q]
+                    + m_timestep * beta[order-1][q] * nHist[q];
+            }
+            a = lhs[order-1].solve(rhs);
+            time += m_timestep;
+
+            aHist.push_front(a);
+            nHist.push_front(ReducedRHS(a));
+            if (aHist.size() > m_order)
+            {
+                aHist.pop_back();
+                nHist.pop_back();
+            }
+
+            if (m_compareFOM)
+            {
+                m_trajectory.push_back(a);
+            }
+            if (trajFile.is_open() && !((n+1) % m_trajectorySteps))
+            {
+                trajFile << time << " " << a.transpose() << endl;
+            }
+            if (m_writeFld && m_checksteps && !((n+1) % m_checksteps))
+            {
+                WriteReconstruction(a, ++nchk);
+            }
+        }
+    }
+
+    /**
+     * Compares the full solution with the reduced one and with its best
+     * approximation in the reduced space.
+     */
+    bool VCSGalerkinROM::v_PostIntegrate(int step)
+    {
+        if (m_compareFOM && !((step+1) % m_trajectorySteps) &&
+            step + 1 < m_trajectory.size())
+        {
+            int nq = m_fields[0]->GetNpoints();
+            VelField fom(m_nvel), rom, proj, diff(m_nvel);
+            for (int v = 0; v < m_nvel; ++v)
+            {
+                fom[v]  = Array<OneD, NekDouble>(nq);
+                diff[v] = Array<OneD, NekDouble>(nq);
+                Vmath::Vcopy(nq, m_fields[m_velocity[v]]->GetPhys(), 1,
+                             fom[v], 1);
+            }
+            Reconstruct(m_trajectory[step+1], rom);
+            Reconstruct(Project(fom), proj);
+
+            NekDouble norm = 0.0, errRom = 0.0, errProj = 0.0, tmp;
+            for (int v = 0; v < m_nvel; ++v)
+            {
+                tmp = m_fields[0]->L2(fom[v]);
+                norm += tmp * tmp;
+                Vmath::Vsub(nq, fom[v], 1, rom[v], 1, diff[v], 1);
+                tmp = m_fields[0]->L2(diff[v]);
+                errRom += tmp * tmp;
+                Vmath::Vsub(nq, fom[v], 1, proj[v], 1, diff[v], 1);
+                tmp = m_fields[0]->L2(diff[v]);
+                errProj += tmp * tmp;
+            }
+            if (m_compareFile.is_open())
+            {
+                m_compareFile << m_time << " " << sqrt(errRom / norm) << " "
+                              << sqrt(errProj / norm) << endl;
+            }
+        }
+
+        return VelocityCorrectionScheme::v_PostIntegrate(step);
+    }
+
+    Eigen::VectorXd VCSGalerkinROM::Project(const VelField &u)
+    {
+        int nq = m_fields[0]->GetNpoints();
+        VelField fluct(m_nvel);
+        for (int v = 0; v < m_nvel; ++v)
+        {
+            fluct[v] = Array<OneD, NekDouble>(nq);
+            Vmath::Vsub(nq, u[v], 1, m_mean[v], 1, fluct[v], 1);
+        }
+        Eigen::VectorXd a(m_nmodes);
+        for (int k = 0; k < m_nmodes; ++k)
+        {
+            a(k) = InnerProduct(m_modes[k], fluct);
+        }
+        return a;
+    }
+
+    void VCSGalerkinROM::Reconstruct(const Eigen::VectorXd &a, VelField &u)
+    {
+        int nq = m_fields[0]->GetNpoints();
+        u = VelField(m_nvel);
+        for (int v = 0; v < m_nvel; ++v)
+        {
+            u[v] = Array<OneD, NekDouble>(nq);
+            Vmath::Vcopy(nq, m_mean[v], 1, u[v], 1);
+            for (int k = 0; k < m_nmodes; ++k)
+            {
+                Vmath::Svtvp(nq, a(k), m_modes[k][v], 1, u[v], 1, u[v], 1);
+            }
+        }
+    }
+
+    void VCSGalerkinROM::WriteReconstruction(
+        const Eigen::VectorXd &a, const int n)
+    {
+        VelField u;
+        Reconstruct(a, u);
+
+        std::vector<Array<OneD, NekDouble> > fieldcoeffs(m_nvel);
+        std::vector<std::string> variables(m_nvel);
+        for (int v = 0; v < m_nvel; ++v)
+        {
+            fieldcoeffs[v] = Array<OneD, NekDouble>(
+                m_fields[m_velocity[v]]->GetNcoeffs());
+            m_fields[m_velocity[v]]->FwdTrans_IterPerExp(u[v], fieldcoeffs[v]);
+            variables[v] = m_session->GetVariable(m_velocity[v]);
+        }
+
+        std::stringstream outname;
+        outname << m_sessionName << "_rom_" << n << ".chk";
+        WriteFld(outname.str(), m_fields[0], fieldcoeffs, variables);
+    }
+
+    NekDouble VCSGalerkinROM::InnerProduct(const VelField &u, const VelField &v)
+    {
+        int nq = m_fields[0]->GetNpoints();
+        Array<OneD, NekDouble> tmp(nq);
+        NekDouble result = 0.0;
+        for (int i = 0; i < m_nvel; ++i)
+        {
+            Vmath::Vmul(nq, u[i], 1, v[i], 1, tmp, 1);
+            result += m_fields[0]->PhysIntegral(tmp);
+        }
+        return result;
+    }
+
+    NekDouble VCSGalerkinROM::GradInnerProduct(
+        const Array<OneD, VelField> &gradu,
+        const Array<OneD, VelField> &gradv)
+    {
+        NekDouble result = 0.0;
+        for (int i = 0; i < m_nvel; ++i)
+        {
+            result += InnerProduct(gradu[i], gradv[i]);
+        }
+        return result;
+    }
+
+    /// gradu[i][j] = d u_i / d x_j
+    void VCSGalerkinROM::Gradient(const VelField &u,
+                                  Array<OneD, VelField> &gradu)
+    {
+        int nq = m_fields[0]->GetNpoints();
+        gradu = Array<OneD, VelField>(m_nvel);
+        for (int i = 0; i < m_nvel; ++i)
+        {
+            gradu[i] = VelField(m_nvel);
+            for (int j = 0; j < m_nvel; ++j)
+            {
+                gradu[i][j] = Array<OneD, NekDouble>(nq);
+                m_fields[0]->PhysDeriv(MultiRegions::DirCartesianMap[j],
+                                       u[i], gradu[i][j]);
+            }
+        }
+    }
+
+    /// outarray = (u . grad) v
+    void VCSGalerkinROM::Convection(const VelField              &u,
+                                    const Array<OneD, VelField> &gradv,
+                                          VelField              &outarray)
+    {
+        int nq = m_fields[0]->GetNpoints();
+        for (int i = 0; i < m_nvel; ++i)
+        {
+            Vmath::Vmul(nq, u[0], 1, gradv[i][0], 1, outarray[i], 1);
+            for (int j = 1; j < m_nvel; ++j)
+            {
+                Vmath::Vvtvp(nq, u[j], 1, gradv[i][j], 1,
+                             outarray[i], 1, outarray[i], 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File VCSGalerkinROM.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: POD-Galerkin reduced order model of the velocity correction scheme header
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_VCSGALERKINROM_H
+#define NEKTAR_SOLVERS_VCSGALERKINROM_H
+
+#include "./VelocityCorrectionScheme.h"
+#include "../Eigen/Dense"
+#include <fstream>
+
+namespace Nektar
+{
+    /**
+     * Unsteady POD-Galerkin reduced order model. The velocity is expanded as
+     * u = U + sum_k a_k phi_k around the snapshot mean U, with the modes
+     * phi_k computed by the method of snapshots from TestSnap1..N. The modes
+     * are divergence free and vanish on Dirichlet boundaries, so the
+     * projected momentum equation loses its pressure term:
+     *
+     *   da/dt = C + L a + Q (a x a) + K a
+     *
+     * K is the projected viscous term and is treated implicitly, the
+     * remaining terms are extrapolated with the stiffly stable IMEX scheme
+     * of the same order as the TimeIntegrationMethod of the full solver.
+     *
+     * With ROM_compare_FOM the full velocity correction scheme is run
+     * afterwards from the same initial condition and the reduced solution
+     * is compared against it on the fly.
+     */
+    class VCSGalerkinROM: public VelocityCorrectionScheme
+    {
+    public:
+
+        /// Creates an instance of this class
+        static SolverUtils::EquationSystemSharedPtr create(
+                const LibUtilities::SessionReaderSharedPtr& pSession) {
+            SolverUtils::EquationSystemSharedPtr p =
+                                MemoryManager<VCSGalerkinROM>::
+                                            AllocateSharedPtr(pSession);
+            p->InitObject();
+            return p;
+        }
+
+        /// Name of class
+        static std::string className;
+
+        /// Constructor.
+        VCSGalerkinROM(const LibUtilities::SessionReaderSharedPtr& pSession);
+
+        virtual ~VCSGalerkinROM();
+
+        virtual void v_InitObject();
+
+    protected:
+        typedef Array<OneD, Array<OneD, NekDouble> > VelField;
+
+        /// Number of velocity components
+        int                                 m_nvel;
+        /// Number of POD modes, set from ROM_modes or POD_tolerance
+        int                                 m_nmodes;
+        /// Order of the IMEX scheme
+        int                                 m_order;
+        int                                 m_trajectorySteps;
+        bool                                m_writeFld;
+        bool                                m_compareFOM;
+
+        VelField                            m_mean;
+        Array<OneD, VelField>               m_modes;
+
+        /// Reduced operators
+        Eigen::VectorXd                     m_romC;
+        Eigen::MatrixXd                     m_romL;
+        Eigen::MatrixXd                     m_romK;
+        Eigen::MatrixXd                     m_romQ;
+
+        /// Reduced trajectory, kept for the comparison with the full model
+        std::vector<Eigen::VectorXd>        m_trajectory;
+        std::ofstream                       m_compareFile;
+        NekDouble                           m_romTime;
+
+        virtual void v_DoSolve();
+
+        virtual bool v_PostIntegrate(int step);
+
+        void BuildReducedModel();
+
+        void SolveReducedModel();
+
+        Eigen::VectorXd ReducedRHS(const Eigen::VectorXd &a);
+
+        Eigen::VectorXd Project(const VelField &u);
+
+        void Reconstruct(const Eigen::VectorXd &a, VelField &u);
+
+        void WriteReconstruction(const Eigen::VectorXd &a, const int n);
+
+        NekDouble InnerProduct(const VelField &u, const VelField &v);
+
+        NekDouble GradInnerProduct(const Array<OneD, VelField> &gradu,
+                                   const Array<OneD, VelField> &gradv);
+
+        void Gradient(const VelField &u, Array<OneD, VelField> &gradu);
+
+        void Convection(const VelField                &u,
+                        const Array<OneD, VelField>   &gradv,
+                              VelField                &outarray);
+    };
+
+    typedef boost::shared_ptr<VCSGalerkinROM>
+                VCSGalerkinROMSharedPtr;
+
+} //end of namespace
+
+#endif //NEKTAR_SOLVERS_VCSGALERKINROM_H
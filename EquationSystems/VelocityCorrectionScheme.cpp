@@ -60,7 +60,11 @@ namespace Nektar
             const LibUtilities::SessionReaderSharedPtr& pSession)
         : UnsteadySystem(pSession),
           IncNavierStokes(pSession),
-          m_varCoeffLap(StdRegions::NullVarCoeffMap)
+          m_varCoeffLap(StdRegions::NullVarCoeffMap),
+          m_adaptiveTimeStep(false),
+          m_dtLevel(0),
+          m_viscousTime(0.0),
+          m_viscousCalls(0)
     {
         
     }
@@ -116,6 +120,34 @@ namespace Nektar
                 m_advObject);
         }
 
+        // Load parameters for CFL controlled time stepping
+        m_session->MatchSolverInfo("AdaptiveTimeStep", "True",
+                                   m_adaptiveTimeStep, false);
+        if (m_adaptiveTimeStep)
+        {
+            NekDouble maxGrowth;
+            m_session->LoadParameter("CFLTarget", m_cflTarget, 0.5);
+            m_session->LoadParameter("CFLMin", m_cflMin, 0.7*m_cflTarget);
+            m_session->LoadParameter("CFLMax", m_cflMax, 1.2*m_cflTarget);
+            m_session->LoadParameter("TimeStepTolerance", m_dtTolerance, 0.1);
+            m_session->LoadParameter("TimeStepMaxGrowth", maxGrowth, 1.25);
+            m_session->LoadParameter("TimeStepMin", m_dtMin, 0.0);
+            m_session->LoadParameter("TimeStepMax", m_dtMax, 0.0);
+            m_session->LoadParameter("TimeStepCheckSteps", m_dtCheckSteps, 1);
+
+            ASSERTL0(m_cflMin < m_cflTarget && m_cflTarget < m_cflMax,
+                     "Need CFLMin < CFLTarget < CFLMax");
+            ASSERTL0(m_dtTolerance > 0.0,
+                     "TimeStepTolerance must be positive");
+            ASSERTL0(m_dtCheckSteps > 0,
+                     "TimeStepCheckSteps must be positive");
+
+            m_dtRef       = m_timestep;
+            m_dtMaxGrowth = max(1, (int) floor(log(maxGrowth) /
+                                               log(1.0 + m_dtTolerance) +
+                                               NekConstants::kNekZeroTol));
+        }
+
         // Integrate only the convective fields
         for (n = 0; n < m_nConvectiveFields; ++n)
         {
@@ -191,6 +223,20 @@ namespace Nektar
      */
     VelocityCorrectionScheme::~VelocityCorrectionScheme(void)
     {        
+        if (m_viscousCalls > 0 && m_session->GetComm()->GetRank() == 0)
+        {
+            int ngroups = 0;
+            std::map<NekDouble, std::vector<ViscousGroup> >::const_iterator it;
+            for (it = m_viscousGroups.begin(); it != m_viscousGroups.end(); ++it)
+            {
+                ngroups += it->second.size();
+            }
+
+            cout << "Viscous solve: " << m_viscousCalls << " steps, mean time "
+                 << m_viscousTime / m_viscousCalls << " s per step, "
+                 << m_viscousGroups.size() << " time step factors, "
+                 << ngroups << " Helmholtz operators" << endl;
+        }
     }
     
     /**
@@ -209,6 +255,16 @@ namespace Nektar
                               m_extrapolation->GetSubStepIntegrationMethod()]);
         }
 
+        if (m_adaptiveTimeStep)
+        {
+            SolverUtils::AddSummaryItem(
+                s, "Time Step Control", "CFL "
+                + boost::lexical_cast<string>(m_cflTarget) + " in ["
+                + boost::lexical_cast<string>(m_cflMin) + ", "
+                + boost::lexical_cast<string>(m_cflMax) + "], tolerance "
+                + boost::lexical_cast<string>(m_dtTolerance));
+        }
+
         string dealias = m_homogen_dealiasing ? "Homogeneous1D" : "";
         if (m_specHP_dealiasing)
         {
@@ -264,6 +320,94 @@ namespace Nektar
     }
     
 
+    /**
+     * Update the time step before the extrapolation of the new step.
+     */
+    bool VelocityCorrectionScheme::v_PreIntegrate(int step)
+    {
+        if (m_adaptiveTimeStep)
+        {
+            AdaptTimeStep(step);
+        }
+
+        return IncNavierStokes::v_PreIntegrate(step);
+    }
+
+    /**
+     * CFL controlled time step. The time step is only changed when the
+     * CFL number leaves [CFLMin, CFLMax], and then towards CFLTarget. It
+     * moves on a geometric ladder of ratio 1 + TimeStepTolerance, so that
+     * the Helmholtz operators, which are factorised for every new
+     * lambda, are not rebuilt for small variations and are reused when a
+     * time step is revisited. The time step grows by at most
+     * TimeStepMaxGrowth at once but shrinks as much as needed.
+     */
+    void VelocityCorrectionScheme::AdaptTimeStep(int step)
+    {
+        NekDouble logRatio = log(1.0 + m_dtTolerance);
+        NekDouble oldStep  = m_timestep;
+        NekDouble cfl      = 0.0;
+        int       elmtid   = 0;
+        bool      checked  = !(step % m_dtCheckSteps);
+
+        if (checked)
+        {
+            cfl = GetCFLEstimate(elmtid);
+
+            if (cfl > m_cflMax || cfl < m_cflMin)
+            {
+                NekDouble ratio = m_cflTarget /
+                    max(cfl, NekConstants::kNekZeroTol);
+                int dlevel = (int) floor(log(ratio) / logRatio);
+                m_dtLevel += min(dlevel, m_dtMaxGrowth);
+
+                if (m_dtMin > 0.0)
+                {
+                    m_dtLevel = max(m_dtLevel, (int) ceil(
+                        log(m_dtMin / m_dtRef) / logRatio -
+                        NekConstants::kNekZeroTol));
+                }
+                if (m_dtMax > 0.0)
+                {
+                    m_dtLevel = min(m_dtLevel, (int) floor(
+                        log(m_dtMax / m_dtRef) / logRatio +
+                        NekConstants::kNekZeroTol));
+                }
+            }
+        }
+
+        m_timestep = m_dtRef * pow(1.0 + m_dtTolerance, m_dtLevel);
+
+        // Finish at the final time
+        if (m_fintime > 0.0 && m_time + m_timestep > m_fintime)
+        {
+            m_timestep = m_fintime - m_time;
+        }
+
+        if (m_timestep != oldStep)
+        {
+            m_fieldMetaDataMap["TimeStep"] =
+                boost::lexical_cast<std::string>(m_timestep);
+
+            if (m_comm->GetRank() == 0)
+            {
+                cout << "Time step changed from " << oldStep << " to "
+                     << m_timestep << " at time " << m_time;
+                if (checked)
+                {
+                    cout << " (CFL " << cfl << " in elmt " << elmtid << ")";
+                }
+                cout << endl;
+            }
+        }
+
+        // The extrapolation keeps track of the previous steps
+        if (m_extrapolation)
+        {
+            m_extrapolation->SetTimeStep(m_timestep);
+        }
+    }
+
     /**
      * 
      */
@@ -461,23 +605,81 @@ namespace Nektar
         Array<OneD, Array<OneD, NekDouble> > &outarray,
         const NekDouble aii_Dt)
     {
-        StdRegions::ConstFactorMap factors;
+        LibUtilities::Timer timer;
+        timer.Start();
+
+        // Look up the components sharing a Helmholtz operator for this
+        // time step factor, the start-up steps and time step changes
+        // each add their own entry
+        std::map<NekDouble, std::vector<ViscousGroup> >::iterator it =
+            m_viscousGroups.find(aii_Dt);
+        if (it == m_viscousGroups.end())
+        {
+            it = m_viscousGroups.insert(
+                std::make_pair(aii_Dt, BuildViscousGroups(aii_Dt))).first;
+        }
 
-        if(m_useSpecVanVisc)
+        // Solve Helmholtz system and put in Physical space, one operator
+        // after the other
+        for (int g = 0; g < it->second.size(); ++g)
         {
-            factors[StdRegions::eFactorSVVCutoffRatio] = m_sVVCutoffRatio;
-            factors[StdRegions::eFactorSVVDiffCoeff]   = m_sVVDiffCoeff/m_kinvis;
+            const ViscousGroup &group = it->second[g];
+            for (int j = 0; j < group.m_fields.size(); ++j)
+            {
+                int i = group.m_fields[j];
+                m_fields[i]->HelmSolve(Forcing[i], m_fields[i]->UpdateCoeffs(),
+                                       NullFlagList, group.m_factors);
+                m_fields[i]->BwdTrans(m_fields[i]->GetCoeffs(),outarray[i]);
+            }
         }
 
-        // Solve Helmholtz system and put in Physical space
+        timer.Stop();
+        m_viscousTime += timer.TimePerTest(1);
+        ++m_viscousCalls;
+    }
+
+    /**
+     * Groups the convective fields by their Helmholtz factor
+     * lambda = 1/(aii_Dt*m_diffCoeff[i]), so that fields with the same
+     * operator are solved back to back with one factor map.
+     */
+    std::vector<VelocityCorrectionScheme::ViscousGroup>
+        VelocityCorrectionScheme::BuildViscousGroups(const NekDouble aii_Dt)
+    {
+        std::vector<ViscousGroup> groups;
+
         for(int i = 0; i < m_nConvectiveFields; ++i)
         {
-            // Setup coefficients for equation
-            factors[StdRegions::eFactorLambda] = 1.0/aii_Dt/m_diffCoeff[i];
-            m_fields[i]->HelmSolve(Forcing[i], m_fields[i]->UpdateCoeffs(),
-                                   NullFlagList, factors);
-            m_fields[i]->BwdTrans(m_fields[i]->GetCoeffs(),outarray[i]);
+            NekDouble lambda = 1.0/aii_Dt/m_diffCoeff[i];
+
+            int g;
+            for (g = 0; g < groups.size(); ++g)
+            {
+                if (groups[g].m_factors[StdRegions::eFactorLambda] == lambda)
+                {
+                    break;
+                }
+            }
+
+            if (g == groups.size())
+            {
+                groups.push_back(ViscousGroup());
+
+                StdRegions::ConstFactorMap &factors = groups[g].m_factors;
+                if(m_useSpecVanVisc)
+                {
+                    factors[StdRegions::eFactorSVVCutoffRatio] =
+                        m_sVVCutoffRatio;
+                    factors[StdRegions::eFactorSVVDiffCoeff]   =
+                        m_sVVDiffCoeff/m_kinvis;
+                }
+                factors[StdRegions::eFactorLambda] = lambda;
+            }
+
+            groups[g].m_fields.push_back(i);
         }
+
+        return groups;
     }
     
 } //end of namespace
@@ -122,6 +122,38 @@ namespace Nektar
         /// Variable Coefficient map for the Laplacian which can be activated as part of SVV or otherwise
         StdRegions::VarCoeffMap m_varCoeffLap; 
 
+        /// bool to identify if the time step follows the CFL number
+        bool m_adaptiveTimeStep;
+        /// CFL number aimed at when the time step is changed
+        NekDouble m_cflTarget;
+        /// CFL band within which the time step is kept
+        NekDouble m_cflMin;
+        NekDouble m_cflMax;
+        /// Time steps are m_dtRef*(1+m_dtTolerance)^m_dtLevel, so that the
+        /// Helmholtz operators of a level are reused when it is revisited
+        NekDouble m_dtRef;
+        NekDouble m_dtTolerance;
+        int       m_dtLevel;
+        /// Maximum number of levels the time step may grow by at once
+        int       m_dtMaxGrowth;
+        /// Bounds of the time step (no bound if zero)
+        NekDouble m_dtMin;
+        NekDouble m_dtMax;
+        /// Number of steps between CFL checks
+        int       m_dtCheckSteps;
+
+        /// Velocity components solved with the same Helmholtz factors
+        struct ViscousGroup
+        {
+            StdRegions::ConstFactorMap m_factors;
+            std::vector<int>           m_fields;
+        };
+        /// Groups of the viscous solve, keyed on aii_Dt
+        std::map<NekDouble, std::vector<ViscousGroup> > m_viscousGroups;
+        /// Accumulated time and number of calls of the viscous solve
+        NekDouble m_viscousTime;
+        int       m_viscousCalls;
+
         // Virtual functions
         virtual void v_GenerateSummary(SolverUtils::SummaryList& s);
 
@@ -157,6 +189,12 @@ namespace Nektar
                     Array<OneD, Array<OneD, NekDouble> > &outarray,
                     const NekDouble time);
 
+        virtual bool v_PreIntegrate(int step);
+
+        void AdaptTimeStep(int step);
+
+        std::vector<ViscousGroup> BuildViscousGroups(const NekDouble aii_Dt);
+
         virtual bool v_RequireFwdTrans()
         {
             return false;
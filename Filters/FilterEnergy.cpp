@@ -44,8 +44,25 @@ std::string FilterEnergy::className = SolverUtils::GetFilterFactory().
 FilterEnergy::FilterEnergy(
     const LibUtilities::SessionReaderSharedPtr &pSession,
     const ParamMap &pParams)
-    : FilterEnergyBase(pSession, pParams, true)
+    : FilterEnergyBase(pSession, pParams, true),
+      m_binaryOutput(false),
+      m_binaryFrequency(1),
+      m_binaryIndex(0)
 {
+    ParamMap::const_iterator it = pParams.find("OutputFormat");
+    if (it != pParams.end())
+    {
+        ASSERTL0(it->second == "Text" || it->second == "Binary",
+                 "OutputFormat should be Text or Binary.");
+        m_binaryOutput = it->second == "Binary";
+    }
+
+    it = pParams.find("OutputFrequency");
+    if (it != pParams.end())
+    {
+        LibUtilities::Equation equ(pSession, it->second);
+        m_binaryFrequency = round(equ.Evaluate());
+    }
 }
 
 FilterEnergy::~FilterEnergy()
@@ -61,4 +78,162 @@ void FilterEnergy::v_GetVelocity(
     velocity = pFields[i]->GetPhys();
 }
 
+/**
+ * In binary mode the base class is bypassed, since its output is formatted
+ * text, and the same quantities are computed here: the kinetic energy
+ * 1/(2V) int |u|^2 and the enstrophy 1/(2V) int |curl u|^2, with V the
+ * area of the (plane of the) domain.
+ */
+void FilterEnergy::v_Initialise(
+    const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+    const NekDouble &time)
+{
+    if (!m_binaryOutput)
+    {
+        FilterEnergyBase::v_Initialise(pFields, time);
+        return;
+    }
+
+    ASSERTL0(pFields[0]->GetExpType() == MultiRegions::e3D ||
+             pFields[0]->GetExpType() == MultiRegions::e3DH1D,
+             "Binary energy output needs a 3D or homogeneous 1D expansion");
+    m_binaryHomogeneous = pFields[0]->GetExpType() == MultiRegions::e3DH1D;
+
+    MultiRegions::ExpListSharedPtr areaField = m_binaryHomogeneous ?
+        pFields[0]->GetPlane(0) : pFields[0];
+    Array<OneD, NekDouble> unit(areaField->GetNpoints(), 1.0);
+    m_binaryArea = areaField->PhysIntegral(unit);
+    if (m_binaryHomogeneous)
+    {
+        pFields[0]->GetComm()->GetRowComm()->AllReduce(
+            m_binaryArea, LibUtilities::ReduceSum);
+    }
+    else
+    {
+        pFields[0]->GetComm()->AllReduce(
+            m_binaryArea, LibUtilities::ReduceSum);
+    }
+
+    if (pFields[0]->GetComm()->GetRank() == 0)
+    {
+        std::vector<TimeSeriesWriter::Column> columns;
+        columns.push_back(TimeSeriesWriter::Column("Time", 17, 8));
+        columns.push_back(TimeSeriesWriter::Column("Kinetic energy", 22, 11));
+        columns.push_back(TimeSeriesWriter::Column("Enstrophy", 22, 11));
+        m_binaryStream = MemoryManager<TimeSeriesWriter>::AllocateSharedPtr(
+            m_session->GetSessionName() + ".eny.bin", columns);
+    }
+
+    m_binaryIndex = 0;
+    v_Update(pFields, time);
+}
+
+void FilterEnergy::v_Update(
+    const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+    const NekDouble &time)
+{
+    if (!m_binaryOutput)
+    {
+        FilterEnergyBase::v_Update(pFields, time);
+        return;
+    }
+
+    if ((m_binaryIndex++) % m_binaryFrequency > 0)
+    {
+        return;
+    }
+
+    int nPoints = pFields[0]->GetNpoints();
+    Array<OneD, Array<OneD, NekDouble> > u(3);
+    Array<OneD, NekDouble> tmp(nPoints, 0.0);
+
+    // kinetic energy
+    for (int i = 0; i < 3; ++i)
+    {
+        u[i] = Array<OneD, NekDouble>(nPoints);
+        Array<OneD, NekDouble> velocity;
+        v_GetVelocity(pFields, i, velocity);
+        if (m_binaryHomogeneous && pFields[i]->GetWaveSpace())
+        {
+            pFields[i]->HomogeneousBwdTrans(velocity, u[i]);
+        }
+        else
+        {
+            Vmath::Vcopy(nPoints, velocity, 1, u[i], 1);
+        }
+        Vmath::Vvtvp(nPoints, u[i], 1, u[i], 1, tmp, 1, tmp, 1);
+    }
+    NekDouble row[3];
+    row[0] = time;
+    row[1] = MeanIntegral(pFields, tmp) / (2.0*m_binaryArea);
+
+    // enstrophy, derivatives of the physical velocity
+    bool waveSpace[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        waveSpace[i] = pFields[i]->GetWaveSpace();
+        pFields[i]->SetWaveSpace(false);
+    }
+
+    Array<OneD, NekDouble> tmp2(nPoints), tmp3(nPoints);
+    Vmath::Zero(nPoints, tmp, 1);
+    for (int i = 0; i < 3; ++i)
+    {
+        int f1 = (i+2) % 3, c2 = f1;
+        int c1 = (i+1) % 3, f2 = c1;
+        pFields[f1]->PhysDeriv(c1, u[f1], tmp2);
+        pFields[f2]->PhysDeriv(c2, u[f2], tmp3);
+        Vmath::Vsub (nPoints, tmp2, 1, tmp3, 1, tmp2, 1);
+        Vmath::Vvtvp(nPoints, tmp2, 1, tmp2, 1, tmp, 1, tmp, 1);
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        pFields[i]->SetWaveSpace(waveSpace[i]);
+    }
+    row[2] = MeanIntegral(pFields, tmp) / (2.0*m_binaryArea);
+
+    if (m_binaryStream)
+    {
+        m_binaryStream->Write(row);
+    }
+}
+
+void FilterEnergy::v_Finalise(
+    const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+    const NekDouble &time)
+{
+    if (!m_binaryOutput)
+    {
+        FilterEnergyBase::v_Finalise(pFields, time);
+        return;
+    }
+    m_binaryStream.reset();
+}
+
+/**
+ * Integral over the domain, for homogeneous expansions of the mean mode
+ * over the plane, summed over all ranks. \a inarray is overwritten.
+ */
+NekDouble FilterEnergy::MeanIntegral(
+    const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+    Array<OneD, NekDouble> &inarray)
+{
+    NekDouble integral = 0.0;
+    if (m_binaryHomogeneous)
+    {
+        pFields[0]->HomogeneousFwdTrans(inarray, inarray);
+        if (pFields[0]->GetZIDs()[0] == 0)
+        {
+            integral = pFields[0]->GetPlane(0)->PhysIntegral(inarray);
+        }
+    }
+    else
+    {
+        integral = pFields[0]->PhysIntegral(inarray);
+    }
+    pFields[0]->GetComm()->AllReduce(integral, LibUtilities::ReduceSum);
+    return integral;
+}
+
 }
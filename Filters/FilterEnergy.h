@@ -37,6 +37,7 @@
 #define NEKTAR_INCNAVIERSTOKESSOLVER_FILTERS_FILTERENERGY_H
 
 #include <SolverUtils/Filters/FilterEnergyBase.h>
+#include "./TimeSeriesWriter.h"
 
 namespace Nektar
 {
@@ -68,6 +69,30 @@ protected:
         const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
         const int i,
         Array<OneD, NekDouble> &velocity);
+
+    virtual void v_Initialise(
+        const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+        const NekDouble &time);
+    virtual void v_Update(
+        const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+        const NekDouble &time);
+    virtual void v_Finalise(
+        const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+        const NekDouble &time);
+
+private:
+    /// OutputFormat = Binary: the filter computes the energy itself and
+    /// writes <session>.eny.bin, otherwise FilterEnergyBase writes text
+    bool                      m_binaryOutput;
+    unsigned int              m_binaryFrequency;
+    unsigned int              m_binaryIndex;
+    bool                      m_binaryHomogeneous;
+    NekDouble                 m_binaryArea;
+    TimeSeriesWriterSharedPtr m_binaryStream;
+
+    NekDouble MeanIntegral(
+        const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+        Array<OneD, NekDouble> &inarray);
 };
 
 }
@@ -38,6 +38,8 @@
 #include <LocalRegions/Expansion1D.h>
 #include <LocalRegions/Expansion2D.h>
 #include <LocalRegions/Expansion3D.h>
+#include <LibUtilities/BasicUtils/Timer.h>
+#include <LibUtilities/LinearAlgebra/Blas.hpp>
 #include "./FilterMovingBody.h"
 
 using namespace std;
@@ -56,7 +58,9 @@ FilterMovingBody::FilterMovingBody(
         const LibUtilities::SessionReaderSharedPtr &pSession,
         const ParamMap &pParams)
     : Filter(pSession),
-      m_session(pSession)
+      m_session(pSession),
+      m_forceTime(0.0),
+      m_forceCalls(0)
 {
     ParamMap::const_iterator it;
 
@@ -97,6 +101,29 @@ FilterMovingBody::FilterMovingBody(
         m_outputFrequency = round(equ.Evaluate());
     }
 
+    // OutputFormat: Text (default) or Binary, see TimeSeriesToText
+    it = pParams.find("OutputFormat");
+    m_binaryOutput = false;
+    if (it != pParams.end())
+    {
+        ASSERTL0(it->second == "Text" || it->second == "Binary",
+                 "OutputFormat should be Text or Binary.");
+        m_binaryOutput = it->second == "Binary";
+    }
+
+    // TraceOperators: 1 (default) evaluates the forces with cached edge
+    // operators, 0 with the original element derivatives
+    it = pParams.find("TraceOperators");
+    if (it == pParams.end())
+    {
+        m_useTraceOperators = true;
+    }
+    else
+    {
+        LibUtilities::Equation equ(m_session, it->second);
+        m_useTraceOperators = round(equ.Evaluate()) != 0;
+    }
+
     pSession->MatchSolverInfo("Homogeneous", "1D", m_isHomogeneous1D, false);
     ASSERTL0(m_isHomogeneous1D, "Moving Body implemented just for 3D "
                                 "Homogeneous 1D discetisations.");
@@ -114,7 +141,13 @@ FilterMovingBody::FilterMovingBody(
  */
 FilterMovingBody::~FilterMovingBody()
 {
-
+    if (m_forceCalls > 0 && m_session->GetComm()->GetRank() == 0)
+    {
+        cout << "FilterMovingBody: " << m_forceCalls << " force evaluations "
+             << (m_useTraceOperators ? "with trace operators"
+                                     : "with element derivatives")
+             << ", mean time " << m_forceTime/m_forceCalls << " s" << endl;
+    }
 }
 
 
@@ -128,6 +161,21 @@ void FilterMovingBody::v_Initialise(
     m_index_f = 0;
     m_index_m = 0;
     m_outputStream =  Array<OneD, std::ofstream>(2);
+    m_binaryStream =  Array<OneD, TimeSeriesWriterSharedPtr>(2);
+
+    const char *forceNames[]  = {"Fx (press)", "Fx (visc)", "Fx (tot)",
+                                 "Fy (press)", "Fy (visc)", "Fy (tot)"};
+    const char *motionNames[] = {"Disp_x", "Vel_x", "Acel_x",
+                                 "Disp_y", "Vel_y", "Acel_y"};
+    m_forceColumns.clear();
+    m_forceColumns.push_back(TimeSeriesWriter::Column("Time", 8, 6));
+    m_forceColumns.push_back(TimeSeriesWriter::Column("z", 15, 6));
+    m_motionColumns = m_forceColumns;
+    for (int i = 0; i < 6; ++i)
+    {
+        m_forceColumns.push_back(TimeSeriesWriter::Column(forceNames[i], 15, 8));
+        m_motionColumns.push_back(TimeSeriesWriter::Column(motionNames[i], 15, 8));
+    }
     // Parse the boundary regions into a list.
     std::string::size_type FirstInd = m_BoundaryString.find_first_of('[') + 1;
     std::string::size_type LastInd  = m_BoundaryString.find_last_of(']') - 1;
@@ -177,47 +225,25 @@ void FilterMovingBody::v_Initialise(
 
     if (vComm->GetRank() == 0)
     {
-        // Open output stream for cable forces
-        m_outputStream[0].open(m_outputFile_fce.c_str());
-        m_outputStream[0] << "#";
-        m_outputStream[0].width(7);
-        m_outputStream[0] << "Time";
-        m_outputStream[0].width(15);
-        m_outputStream[0] << "z";
-        m_outputStream[0].width(15);
-        m_outputStream[0] << "Fx (press)";
-        m_outputStream[0].width(15);
-        m_outputStream[0] << "Fx (visc)";
-        m_outputStream[0].width(15);
-        m_outputStream[0] << "Fx (tot)";
-        m_outputStream[0].width(15);
-        m_outputStream[0] << "Fy (press)";
-        m_outputStream[0].width(15);
-        m_outputStream[0] << "Fy (visc)";
-        m_outputStream[0].width(15);
-        m_outputStream[0] << "Fy (tot)";
-        m_outputStream[0] << endl;
-
-        // Open output stream for cable motions
-        m_outputStream[1].open(m_outputFile_mot.c_str());
-        m_outputStream[1] << "#";
-        m_outputStream[1].width(7);
-        m_outputStream[1] << "Time";
-        m_outputStream[1].width(15);
-        m_outputStream[1] << "z";
-        m_outputStream[1].width(15);
-        m_outputStream[1] << "Disp_x";
-        m_outputStream[1].width(15);
-        m_outputStream[1] << "Vel_x";
-        m_outputStream[1].width(15);
-        m_outputStream[1] << "Acel_x";
-        m_outputStream[1].width(15);
-        m_outputStream[1] << "Disp_y";
-        m_outputStream[1].width(15);
-        m_outputStream[1] << "Vel_y";
-        m_outputStream[1].width(15);
-        m_outputStream[1] << "Acel_y";
-        m_outputStream[1] << endl;
+        if (m_binaryOutput)
+        {
+            m_binaryStream[0] = MemoryManager<TimeSeriesWriter>::
+                AllocateSharedPtr(m_outputFile_fce + ".bin", m_forceColumns);
+            m_binaryStream[1] = MemoryManager<TimeSeriesWriter>::
+                AllocateSharedPtr(m_outputFile_mot + ".bin", m_motionColumns);
+        }
+        else
+        {
+            // Open output stream for cable forces
+            m_outputStream[0].open(m_outputFile_fce.c_str());
+            TimeSeriesWriter::WriteTextHeader(m_outputStream[0],
+                                              m_forceColumns);
+
+            // Open output stream for cable motions
+            m_outputStream[1].open(m_outputFile_mot.c_str());
+            TimeSeriesWriter::WriteTextHeader(m_outputStream[1],
+                                              m_motionColumns);
+        }
     }
 }
 
@@ -231,28 +257,6 @@ void FilterMovingBody::UpdateForce(
               Array<OneD, NekDouble> &Aeroforces,
         const NekDouble &time)
 {
-    int n, cnt, elmtid, nq, offset, boundary;
-    int nt  = pFields[0]->GetNpoints();
-    int dim = pFields.num_elements()-1;
-
-    StdRegions::StdExpansionSharedPtr elmt;
-    Array<OneD, int> BoundarytoElmtID;
-    Array<OneD, int> BoundarytoTraceID;
-    Array<OneD, MultiRegions::ExpListSharedPtr>  BndExp;
-
-    Array<OneD, const NekDouble> P(nt);
-    Array<OneD, const NekDouble> U(nt);
-    Array<OneD, const NekDouble> V(nt);
-    Array<OneD, const NekDouble> W(nt);
-
-    Array<OneD, Array<OneD, NekDouble> > gradU(dim);
-    Array<OneD, Array<OneD, NekDouble> > gradV(dim);
-    Array<OneD, Array<OneD, NekDouble> > gradW(dim);
-
-    Array<OneD, Array<OneD, NekDouble> > fgradU(dim);
-    Array<OneD, Array<OneD, NekDouble> > fgradV(dim);
-    Array<OneD, Array<OneD, NekDouble> > fgradW(dim);
-
     LibUtilities::CommSharedPtr vComm     = pFields[0]->GetComm();
     LibUtilities::CommSharedPtr vRowComm  = vComm->GetRowComm();
     LibUtilities::CommSharedPtr vColComm  = vComm->GetColumnComm();
@@ -289,158 +293,49 @@ void FilterMovingBody::UpdateForce(
     ZIDs = pFields[0]->GetZIDs();
     int local_planes = ZIDs.num_elements();
 
-    // Homogeneous 1D case  Compute forces on all WALL boundaries
-    // This only has to be done on the zero (mean) Fourier mode.
-    for(int plane = 0 ; plane < local_planes; plane++)
+    if (m_useTraceOperators && m_traceOps.empty())
     {
-        pFields[0]->GetPlane(plane)->GetBoundaryToElmtMap(BoundarytoElmtID,
-                                                          BoundarytoTraceID);
-        BndExp = pFields[0]->GetPlane(plane)->GetBndCondExpansions();
-        StdRegions::StdExpansionSharedPtr bc;
-
-        // loop over the types of boundary conditions
-        for(cnt = n = 0; n < BndExp.num_elements(); ++n)
-        {
-            if(m_boundaryRegionIsInList[n] == 1)
-            {
-                for(int i = 0; i <  BndExp[n]->GetExpSize(); ++i, cnt++)
-                {
-                    // find element of this expansion.
-                    elmtid = BoundarytoElmtID[cnt];
-                    elmt   = pFields[0]->GetPlane(plane)->GetExp(elmtid);
-                    nq     = elmt->GetTotPoints();
-                    offset = pFields[0]->GetPlane(plane)
-                                       ->GetPhys_Offset(elmtid);
-
-                    // Initialise local arrays for the velocity
-                    // gradients size of total number of quadrature
-                    // points for each element (hence local).
-                    for(int j = 0; j < dim; ++j)
-                    {
-                        gradU[j] = Array<OneD, NekDouble>(nq,0.0);
-                        gradV[j] = Array<OneD, NekDouble>(nq,0.0);
-                        gradW[j] = Array<OneD, NekDouble>(nq,0.0);
-                    }
-
-                    // identify boundary of element
-                    boundary = BoundarytoTraceID[cnt];
-
-                    // Extract  fields
-                    U = pFields[0]->GetPlane(plane)->GetPhys() + offset;
-                    V = pFields[1]->GetPlane(plane)->GetPhys() + offset;
-                    P = pFields[3]->GetPlane(plane)->GetPhys() + offset;
-
-                    // compute the gradients
-                    elmt->PhysDeriv(U,gradU[0],gradU[1]);
-                    elmt->PhysDeriv(V,gradV[0],gradV[1]);
-
-                    // Get face 1D expansion from element expansion
-                    bc = BndExp[n]->GetExp(i)->as<LocalRegions::Expansion1D>();
-
-                    // number of points on the boundary
-                    int nbc = bc->GetTotPoints();
-
-                    // several vectors for computing the forces
-                    Array<OneD, NekDouble> Pb(nbc,0.0);
-
-                    for(int j = 0; j < dim; ++j)
-                    {
-                        fgradU[j] = Array<OneD, NekDouble>(nbc,0.0);
-                        fgradV[j] = Array<OneD, NekDouble>(nbc,0.0);
-                    }
-
-                    Array<OneD, NekDouble>  drag_t(nbc,0.0);
-                    Array<OneD, NekDouble>  lift_t(nbc,0.0);
-                    Array<OneD, NekDouble>  drag_p(nbc,0.0);
-                    Array<OneD, NekDouble>  lift_p(nbc,0.0);
-                    Array<OneD, NekDouble>  temp(nbc,0.0);
-                    Array<OneD, NekDouble>  temp2(nbc,0.0);
-
-                    // identify boundary of element .
-                    boundary = BoundarytoTraceID[cnt];
-
-                    // extraction of the pressure and wss on the
-                    // boundary of the element
-                    elmt->GetEdgePhysVals(boundary,bc,P,Pb);
-
-                    for(int j = 0; j < dim; ++j)
-                    {
-                        elmt->GetEdgePhysVals(boundary,bc,gradU[j],fgradU[j]);
-                        elmt->GetEdgePhysVals(boundary,bc,gradV[j],fgradV[j]);
-                    }
-
-                    //normals of the element
-                    const Array<OneD, Array<OneD, NekDouble> > &normals
-                                            = elmt->GetEdgeNormal(boundary);
-
-                    //
-                    // Compute viscous tractive forces on wall from
-                    //
-                    //  t_i  = - T_ij * n_j  (minus sign for force
-                    //                        exerted BY fluid ON wall),
-                    //
-                    // where
-                    //
-                    //  T_ij = viscous stress tensor (here in Cartesian
-                    //         coords)
-                    //                          dU_i    dU_j
-                    //       = RHO * KINVIS * ( ----  + ---- ) .
-                    //                          dx_j    dx_i
-
-                    //a) DRAG TERMS
-                    //-rho*kinvis*(2*du/dx*nx+(du/dy+dv/dx)*ny)
-
-                    Vmath::Vadd(nbc, fgradU[1], 1, fgradV[0],  1, drag_t,    1);
-                    Vmath::Vmul(nbc, drag_t,    1, normals[1], 1, drag_t,    1);
-
-                    Vmath::Smul(nbc, 2.0,          fgradU[0],  1, fgradU[0], 1);
-                    Vmath::Vmul(nbc, fgradU[0], 1, normals[0], 1, temp2,     1);
-                    Vmath::Smul(nbc, 0.5,          fgradU[0],  1, fgradU[0], 1);
-
-                    Vmath::Vadd(nbc, temp2,     1, drag_t,     1, drag_t,    1);
-                    Vmath::Smul(nbc, -mu,          drag_t,     1, drag_t,    1);
-
-                    //zero temporary storage vector
-                    Vmath::Zero(nbc, temp,  0.0);
-                    Vmath::Zero(nbc, temp2, 0.0);
-
-
-                    //b) LIFT TERMS
-                    //-rho*kinvis*(2*dv/dy*ny+(du/dy+dv/dx)*nx)
-
-                    Vmath::Vadd(nbc, fgradU[1], 1, fgradV[0],  1, lift_t,    1);
-                    Vmath::Vmul(nbc, lift_t,    1, normals[0], 1, lift_t,    1);
-
-                    Vmath::Smul(nbc, 2.0,          fgradV[1],  1, fgradV[1], 1);
-                    Vmath::Vmul(nbc, fgradV[1], 1, normals[1], 1, temp2,     1);
-                    Vmath::Smul(nbc, -0.5,         fgradV[1],  1, fgradV[1], 1);
-
-
-                    Vmath::Vadd(nbc, temp2,     1, lift_t,     1, lift_t,    1);
-                    Vmath::Smul(nbc, -mu,          lift_t,     1, lift_t,    1);
-
-                    // Compute normal tractive forces on all WALL
-                    // boundaries
-
-                    Vmath::Vvtvp(nbc, Pb,       1, normals[0], 1, drag_p,    1,
-                                                                  drag_p,    1);
-                    Vmath::Vvtvp(nbc, Pb,       1, normals[1], 1, lift_p,    1,
-                                                                  lift_p,    1);
+        BuildTraceOperators(pFields);
+    }
 
-                    //integration over the boundary
-                    Fxv[ZIDs[plane]] += bc->Integral(drag_t);
-                    Fyv[ZIDs[plane]] += bc->Integral(lift_t);
+    LibUtilities::Timer timer;
+    timer.Start();
+    if (m_useTraceOperators)
+    {
+        TraceForces(pFields, mu, Fxp, Fxv, Fyp, Fyv);
+    }
+    else
+    {
+        DirectForces(pFields, mu, Fxp, Fxv, Fyp, Fyv);
+    }
+    timer.Stop();
+    m_forceTime += timer.TimePerTest(1);
 
-                    Fxp[ZIDs[plane]] += bc->Integral(drag_p);
-                    Fyp[ZIDs[plane]] += bc->Integral(lift_p);
-                }
-            }
-            else
-            {
-                cnt += BndExp[n]->GetExpSize();
-            }
+    // compare with the original evaluation once
+    if (m_useTraceOperators && m_forceCalls == 0)
+    {
+        Array<OneD, NekDouble> Dxp(Num_z_pos,0.0);
+        Array<OneD, NekDouble> Dxv(Num_z_pos,0.0);
+        Array<OneD, NekDouble> Dyp(Num_z_pos,0.0);
+        Array<OneD, NekDouble> Dyv(Num_z_pos,0.0);
+        DirectForces(pFields, mu, Dxp, Dxv, Dyp, Dyv);
+
+        NekDouble diff = 0.0, scale = 0.0;
+        for(int z = 0; z < Num_z_pos; ++z)
+        {
+            diff  = max(diff,  fabs(Fxp[z]-Dxp[z]) + fabs(Fxv[z]-Dxv[z])
+                             + fabs(Fyp[z]-Dyp[z]) + fabs(Fyv[z]-Dyv[z]));
+            scale = max(scale, fabs(Dxp[z]) + fabs(Dxv[z])
+                             + fabs(Dyp[z]) + fabs(Dyv[z]));
+        }
+        if (vComm->GetRank() == 0)
+        {
+            cout << "FilterMovingBody: trace operators vs. element "
+                 << "derivatives, max force deviation " << diff
+                 << " (force magnitude " << scale << ")" << endl;
         }
     }
+    ++m_forceCalls;
 
     for(int i = 0; i < pFields.num_elements(); ++i)
     {
@@ -543,26 +438,9 @@ void FilterMovingBody::UpdateForce(
 
             for(int i = 0 ; i < Num_z_pos; i++)
             {
-                m_outputStream[0].width(8);
-                m_outputStream[0] << setprecision(6) << time;
-
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(6) << z_coords[i];
-
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << Fxp[i];
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << Fxv[i];
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << Fx[i];
-
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << Fyp[i];
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << Fyv[i];
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << Fy[i];
-                m_outputStream[0] << endl;
+                NekDouble row[8] = {time, z_coords[i], Fxp[i], Fxv[i], Fx[i],
+                                    Fyp[i], Fyv[i], Fy[i]};
+                OutputRow(0, row);
             }
         }
     }
@@ -632,51 +510,17 @@ void FilterMovingBody::UpdateForce(
 
         if(colrank == 0)
         {
-            m_outputStream[0].width(8);
-            m_outputStream[0] << setprecision(6) << time;
-
-            m_outputStream[0].width(15);
-            m_outputStream[0] << setprecision(6) << z_coords[0];
-
-            m_outputStream[0].width(15);
-            m_outputStream[0] << setprecision(8) << fces[2];
-            m_outputStream[0].width(15);
-            m_outputStream[0] << setprecision(8) << fces[4];
-            m_outputStream[0].width(15);
-            m_outputStream[0] << setprecision(8) << fces[0];
-
-            m_outputStream[0].width(15);
-            m_outputStream[0] << setprecision(8) << fces[3];
-            m_outputStream[0].width(15);
-            m_outputStream[0] << setprecision(8) << fces[5];
-            m_outputStream[0].width(15);
-            m_outputStream[0] << setprecision(8) << fces[1];
-            m_outputStream[0] << endl;
+            NekDouble row[8] = {time, z_coords[0], fces[2], fces[4], fces[0],
+                                fces[3], fces[5], fces[1]};
+            OutputRow(0, row);
 
             for(int i = 1; i < nstrips; i++)
             {
                 vColComm->Recv(i, fces);
 
-                m_outputStream[0].width(8);
-                m_outputStream[0] << setprecision(6) << time;
-
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(6) << z_coords[i];
-
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << fces[2];
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << fces[4];
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << fces[0];
-
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << fces[3];
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << fces[5];
-                m_outputStream[0].width(15);
-                m_outputStream[0] << setprecision(8) << fces[1];
-                m_outputStream[0] << endl;
+                NekDouble row[8] = {time, z_coords[i], fces[2], fces[4],
+                                    fces[0], fces[3], fces[5], fces[1]};
+                OutputRow(0, row);
             }
         }
         else
@@ -693,6 +537,351 @@ void FilterMovingBody::UpdateForce(
 }
 
 
+/**
+ * Forces on the wall boundaries of the local planes from the element
+ * gradients: the whole element is differentiated and the trace of the
+ * gradient extracted, with temporaries allocated for every boundary
+ * element. This is the original evaluation, kept for comparison
+ * (TraceOperators = 0).
+ */
+void FilterMovingBody::DirectForces(
+        const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+        const NekDouble                                          mu,
+              Array<OneD, NekDouble>                            &Fxp,
+              Array<OneD, NekDouble>                            &Fxv,
+              Array<OneD, NekDouble>                            &Fyp,
+              Array<OneD, NekDouble>                            &Fyv)
+{
+    int n, cnt, elmtid, nq, offset, boundary;
+    int nt  = pFields[0]->GetNpoints();
+    int dim = pFields.num_elements()-1;
+
+    StdRegions::StdExpansionSharedPtr elmt;
+    Array<OneD, int> BoundarytoElmtID;
+    Array<OneD, int> BoundarytoTraceID;
+    Array<OneD, MultiRegions::ExpListSharedPtr>  BndExp;
+
+    Array<OneD, const NekDouble> P(nt);
+    Array<OneD, const NekDouble> U(nt);
+    Array<OneD, const NekDouble> V(nt);
+    Array<OneD, const NekDouble> W(nt);
+
+    Array<OneD, Array<OneD, NekDouble> > gradU(dim);
+    Array<OneD, Array<OneD, NekDouble> > gradV(dim);
+    Array<OneD, Array<OneD, NekDouble> > gradW(dim);
+
+    Array<OneD, Array<OneD, NekDouble> > fgradU(dim);
+    Array<OneD, Array<OneD, NekDouble> > fgradV(dim);
+    Array<OneD, Array<OneD, NekDouble> > fgradW(dim);
+
+    Array<OneD, unsigned int> ZIDs = pFields[0]->GetZIDs();
+    int local_planes = ZIDs.num_elements();
+
+    // Homogeneous 1D case  Compute forces on all WALL boundaries
+    // This only has to be done on the zero (mean) Fourier mode.
+    for(int plane = 0 ; plane < local_planes; plane++)
+    {
+        pFields[0]->GetPlane(plane)->GetBoundaryToElmtMap(BoundarytoElmtID,
+                                                          BoundarytoTraceID);
+        BndExp = pFields[0]->GetPlane(plane)->GetBndCondExpansions();
+        StdRegions::StdExpansionSharedPtr bc;
+
+        // loop over the types of boundary conditions
+        for(cnt = n = 0; n < BndExp.num_elements(); ++n)
+        {
+            if(m_boundaryRegionIsInList[n] == 1)
+            {
+                for(int i = 0; i <  BndExp[n]->GetExpSize(); ++i, cnt++)
+                {
+                    // find element of this expansion.
+                    elmtid = BoundarytoElmtID[cnt];
+                    elmt   = pFields[0]->GetPlane(plane)->GetExp(elmtid);
+                    nq     = elmt->GetTotPoints();
+                    offset = pFields[0]->GetPlane(plane)
+                                       ->GetPhys_Offset(elmtid);
+
+                    // Initialise local arrays for the velocity
+                    // gradients size of total number of quadrature
+                    // points for each element (hence local).
+                    for(int j = 0; j < dim; ++j)
+                    {
+                        gradU[j] = Array<OneD, NekDouble>(nq,0.0);
+                        gradV[j] = Array<OneD, NekDouble>(nq,0.0);
+                        gradW[j] = Array<OneD, NekDouble>(nq,0.0);
+                    }
+
+                    // identify boundary of element
+                    boundary = BoundarytoTraceID[cnt];
+
+                    // Extract  fields
+                    U = pFields[0]->GetPlane(plane)->GetPhys() + offset;
+                    V = pFields[1]->GetPlane(plane)->GetPhys() + offset;
+                    P = pFields[3]->GetPlane(plane)->GetPhys() + offset;
+
+                    // compute the gradients
+                    elmt->PhysDeriv(U,gradU[0],gradU[1]);
+                    elmt->PhysDeriv(V,gradV[0],gradV[1]);
+
+                    // Get face 1D expansion from element expansion
+                    bc = BndExp[n]->GetExp(i)->as<LocalRegions::Expansion1D>();
+
+                    // number of points on the boundary
+                    int nbc = bc->GetTotPoints();
+
+                    // several vectors for computing the forces
+                    Array<OneD, NekDouble> Pb(nbc,0.0);
+
+                    for(int j = 0; j < dim; ++j)
+                    {
+                        fgradU[j] = Array<OneD, NekDouble>(nbc,0.0);
+                        fgradV[j] = Array<OneD, NekDouble>(nbc,0.0);
+                    }
+
+                    Array<OneD, NekDouble>  drag_t(nbc,0.0);
+                    Array<OneD, NekDouble>  lift_t(nbc,0.0);
+                    Array<OneD, NekDouble>  drag_p(nbc,0.0);
+                    Array<OneD, NekDouble>  lift_p(nbc,0.0);
+                    Array<OneD, NekDouble>  temp(nbc,0.0);
+                    Array<OneD, NekDouble>  temp2(nbc,0.0);
+
+                    // identify boundary of element .
+                    boundary = BoundarytoTraceID[cnt];
+
+                    // extraction of the pressure and wss on the
+                    // boundary of the element
+                    elmt->GetEdgePhysVals(boundary,bc,P,Pb);
+
+                    for(int j = 0; j < dim; ++j)
+                    {
+                        elmt->GetEdgePhysVals(boundary,bc,gradU[j],fgradU[j]);
+                        elmt->GetEdgePhysVals(boundary,bc,gradV[j],fgradV[j]);
+                    }
+
+                    //normals of the element
+                    const Array<OneD, Array<OneD, NekDouble> > &normals
+                                            = elmt->GetEdgeNormal(boundary);
+
+                    //
+                    // Compute viscous tractive forces on wall from
+                    //
+                    //  t_i  = - T_ij * n_j  (minus sign for force
+                    //                        exerted BY fluid ON wall),
+                    //
+                    // where
+                    //
+                    //  T_ij = viscous stress tensor (here in Cartesian
+                    //         coords)
+                    //                          dU_i    dU_j
+                    //       = RHO * KINVIS * ( ----  + ---- ) .
+                    //                          dx_j    dx_i
+
+                    //a) DRAG TERMS
+                    //-rho*kinvis*(2*du/dx*nx+(du/dy+dv/dx)*ny)
+
+                    Vmath::Vadd(nbc, fgradU[1], 1, fgradV[0],  1, drag_t,    1);
+                    Vmath::Vmul(nbc, drag_t,    1, normals[1], 1, drag_t,    1);
+
+                    Vmath::Smul(nbc, 2.0,          fgradU[0],  1, fgradU[0], 1);
+                    Vmath::Vmul(nbc, fgradU[0], 1, normals[0], 1, temp2,     1);
+                    Vmath::Smul(nbc, 0.5,          fgradU[0],  1, fgradU[0], 1);
+
+                    Vmath::Vadd(nbc, temp2,     1, drag_t,     1, drag_t,    1);
+                    Vmath::Smul(nbc, -mu,          drag_t,     1, drag_t,    1);
+
+                    //zero temporary storage vector
+                    Vmath::Zero(nbc, temp,  0.0);
+                    Vmath::Zero(nbc, temp2, 0.0);
+
+
+                    //b) LIFT TERMS
+                    //-rho*kinvis*(2*dv/dy*ny+(du/dy+dv/dx)*nx)
+
+                    Vmath::Vadd(nbc, fgradU[1], 1, fgradV[0],  1, lift_t,    1);
+                    Vmath::Vmul(nbc, lift_t,    1, normals[0], 1, lift_t,    1);
+
+                    Vmath::Smul(nbc, 2.0,          fgradV[1],  1, fgradV[1], 1);
+                    Vmath::Vmul(nbc, fgradV[1], 1, normals[1], 1, temp2,     1);
+                    Vmath::Smul(nbc, -0.5,         fgradV[1],  1, fgradV[1], 1);
+
+
+                    Vmath::Vadd(nbc, temp2,     1, lift_t,     1, lift_t,    1);
+                    Vmath::Smul(nbc, -mu,          lift_t,     1, lift_t,    1);
+
+                    // Compute normal tractive forces on all WALL
+                    // boundaries
+
+                    Vmath::Vvtvp(nbc, Pb,       1, normals[0], 1, drag_p,    1,
+                                                                  drag_p,    1);
+                    Vmath::Vvtvp(nbc, Pb,       1, normals[1], 1, lift_p,    1,
+                                                                  lift_p,    1);
+
+                    //integration over the boundary
+                    Fxv[ZIDs[plane]] += bc->Integral(drag_t);
+                    Fyv[ZIDs[plane]] += bc->Integral(lift_t);
+
+                    Fxp[ZIDs[plane]] += bc->Integral(drag_p);
+                    Fyp[ZIDs[plane]] += bc->Integral(lift_p);
+                }
+            }
+            else
+            {
+                cnt += BndExp[n]->GetExpSize();
+            }
+        }
+    }
+}
+
+
+/**
+ * Builds, for every element with an edge on the force boundaries, the
+ * operator mapping the physical values of the element to the x- and
+ * y-derivatives and the values on that edge, stacked as a column-major
+ * (3 nbc) x nq matrix. The operator is assembled by applying PhysDeriv and
+ * GetEdgePhysVals to unit vectors, so it reproduces DirectForces exactly
+ * in exact arithmetic. The edge normals and the quadrature weights of the
+ * edge integral are stored alongside. All planes share the 2D mesh, so
+ * plane 0 is used.
+ */
+void FilterMovingBody::BuildTraceOperators(
+        const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields)
+{
+    MultiRegions::ExpListSharedPtr plane = pFields[0]->GetPlane(0);
+
+    Array<OneD, int> BoundarytoElmtID;
+    Array<OneD, int> BoundarytoTraceID;
+    plane->GetBoundaryToElmtMap(BoundarytoElmtID, BoundarytoTraceID);
+    Array<OneD, MultiRegions::ExpListSharedPtr> BndExp
+                                        = plane->GetBndCondExpansions();
+
+    int maxnbc = 0;
+    for(int cnt = 0, n = 0; n < BndExp.num_elements(); ++n)
+    {
+        if(m_boundaryRegionIsInList[n] != 1)
+        {
+            cnt += BndExp[n]->GetExpSize();
+            continue;
+        }
+        for(int i = 0; i < BndExp[n]->GetExpSize(); ++i, cnt++)
+        {
+            int elmtid   = BoundarytoElmtID[cnt];
+            int boundary = BoundarytoTraceID[cnt];
+            StdRegions::StdExpansionSharedPtr elmt = plane->GetExp(elmtid);
+            StdRegions::StdExpansionSharedPtr bc   =
+                BndExp[n]->GetExp(i)->as<LocalRegions::Expansion1D>();
+
+            TraceOperator op;
+            op.m_offset = plane->GetPhys_Offset(elmtid);
+            op.m_nq     = elmt->GetTotPoints();
+            op.m_nbc    = bc->GetTotPoints();
+
+            int nq  = op.m_nq;
+            int nbc = op.m_nbc;
+            op.m_op = Array<OneD, NekDouble>(3*nbc*nq, 0.0);
+
+            Array<OneD, NekDouble> unit(nq, 0.0), grad0(nq), grad1(nq);
+            Array<OneD, NekDouble> tmp;
+            for(int k = 0; k < nq; ++k)
+            {
+                unit[k] = 1.0;
+                elmt->PhysDeriv(unit, grad0, grad1);
+                elmt->GetEdgePhysVals(boundary, bc, grad0,
+                                      tmp = op.m_op + k*3*nbc);
+                elmt->GetEdgePhysVals(boundary, bc, grad1,
+                                      tmp = op.m_op + k*3*nbc + nbc);
+                elmt->GetEdgePhysVals(boundary, bc, unit,
+                                      tmp = op.m_op + k*3*nbc + 2*nbc);
+                unit[k] = 0.0;
+            }
+
+            const Array<OneD, Array<OneD, NekDouble> > &normals
+                                    = elmt->GetEdgeNormal(boundary);
+            op.m_normalX = Array<OneD, NekDouble>(nbc);
+            op.m_normalY = Array<OneD, NekDouble>(nbc);
+            Vmath::Vcopy(nbc, normals[0], 1, op.m_normalX, 1);
+            Vmath::Vcopy(nbc, normals[1], 1, op.m_normalY, 1);
+
+            op.m_weights = Array<OneD, NekDouble>(nbc);
+            Array<OneD, NekDouble> edgeUnit(nbc, 0.0);
+            for(int k = 0; k < nbc; ++k)
+            {
+                edgeUnit[k] = 1.0;
+                op.m_weights[k] = bc->Integral(edgeUnit);
+                edgeUnit[k] = 0.0;
+            }
+
+            maxnbc = max(maxnbc, nbc);
+            m_traceOps.push_back(op);
+        }
+    }
+
+    m_traceWork = Array<OneD, NekDouble>(5*maxnbc, 0.0);
+}
+
+
+/**
+ * Forces on the wall boundaries of the local planes with the operators of
+ * BuildTraceOperators: three matrix-vector products per boundary element
+ * give the trace gradients of u, v and the trace of p, and the pressure
+ * and viscous tractions are integrated in a single loop over the edge
+ * points, without temporaries.
+ */
+void FilterMovingBody::TraceForces(
+        const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+        const NekDouble                                          mu,
+              Array<OneD, NekDouble>                            &Fxp,
+              Array<OneD, NekDouble>                            &Fxv,
+              Array<OneD, NekDouble>                            &Fyp,
+              Array<OneD, NekDouble>                            &Fyv)
+{
+    Array<OneD, unsigned int> ZIDs = pFields[0]->GetZIDs();
+    int local_planes = ZIDs.num_elements();
+
+    for(int plane = 0 ; plane < local_planes; plane++)
+    {
+        const NekDouble *U = pFields[0]->GetPlane(plane)->GetPhys().get();
+        const NekDouble *V = pFields[1]->GetPlane(plane)->GetPhys().get();
+        const NekDouble *P = pFields[3]->GetPlane(plane)->GetPhys().get();
+
+        NekDouble fxp = 0.0, fxv = 0.0, fyp = 0.0, fyv = 0.0;
+        for(unsigned int e = 0; e < m_traceOps.size(); ++e)
+        {
+            const TraceOperator &op = m_traceOps[e];
+            int nq  = op.m_nq;
+            int nbc = op.m_nbc;
+
+            // [du/dx, du/dy | dv/dx, dv/dy | p] on the edge
+            NekDouble *gU = m_traceWork.get();
+            NekDouble *gV = gU + 2*nbc;
+            NekDouble *Pb = gV + 2*nbc;
+            Blas::Dgemv('N', 2*nbc, nq, 1.0, op.m_op.get(), 3*nbc,
+                        U + op.m_offset, 1, 0.0, gU, 1);
+            Blas::Dgemv('N', 2*nbc, nq, 1.0, op.m_op.get(), 3*nbc,
+                        V + op.m_offset, 1, 0.0, gV, 1);
+            Blas::Dgemv('N', nbc, nq, 1.0, op.m_op.get() + 2*nbc, 3*nbc,
+                        P + op.m_offset, 1, 0.0, Pb, 1);
+
+            for(int k = 0; k < nbc; ++k)
+            {
+                NekDouble w     = op.m_weights[k];
+                NekDouble nx    = op.m_normalX[k];
+                NekDouble ny    = op.m_normalY[k];
+                NekDouble shear = gU[nbc+k] + gV[k];
+
+                fxv -= w*mu*(shear*ny + 2.0*gU[k]*nx);
+                fyv -= w*mu*(shear*nx + 2.0*gV[nbc+k]*ny);
+                fxp += w*Pb[k]*nx;
+                fyp += w*Pb[k]*ny;
+            }
+        }
+
+        Fxp[ZIDs[plane]] += fxp;
+        Fxv[ZIDs[plane]] += fxv;
+        Fyp[ZIDs[plane]] += fyp;
+        Fyv[ZIDs[plane]] += fyv;
+    }
+}
+
+
 /**
  *
  */
@@ -727,23 +916,11 @@ void FilterMovingBody::UpdateMotion(
     for(int n = 0; n < npts; n++)
     {
         z_coords = Length/npts*n;
-        m_outputStream[1].width(8);
-        m_outputStream[1] << setprecision(6) << time;
-        m_outputStream[1].width(15);
-        m_outputStream[1] << setprecision(6) << z_coords;
-        m_outputStream[1].width(15);
-        m_outputStream[1] << setprecision(8) << MotionVars[n];
-        m_outputStream[1].width(15);
-        m_outputStream[1] << setprecision(8) << MotionVars[npts+n];
-        m_outputStream[1].width(15);
-        m_outputStream[1] << setprecision(8) << MotionVars[2*npts+n];
-        m_outputStream[1].width(15);
-        m_outputStream[1] << setprecision(8) << MotionVars[3*npts+n];
-        m_outputStream[1].width(15);
-        m_outputStream[1] << setprecision(8) << MotionVars[4*npts+n];
-        m_outputStream[1].width(15);
-        m_outputStream[1] << setprecision(8) << MotionVars[5*npts+n];
-        m_outputStream[1] << endl;
+        NekDouble row[8] = {time, z_coords,
+                            MotionVars[n],        MotionVars[npts+n],
+                            MotionVars[2*npts+n], MotionVars[3*npts+n],
+                            MotionVars[4*npts+n], MotionVars[5*npts+n]};
+        OutputRow(1, row);
     }
 }
 
@@ -757,8 +934,38 @@ void FilterMovingBody::v_Finalise(
 {
     if (pFields[0]->GetComm()->GetRank() == 0)
     {
-        m_outputStream[0].close();
-        m_outputStream[1].close();
+        if (m_binaryOutput)
+        {
+            m_binaryStream[0].reset();
+            m_binaryStream[1].reset();
+        }
+        else
+        {
+            m_outputStream[0].close();
+            m_outputStream[1].close();
+        }
+    }
+}
+
+
+/**
+ * Writes one row of the force (\a stream = 0) or motion (1) output, as
+ * text or to the buffered binary file (OutputFormat = Binary).
+ */
+void FilterMovingBody::OutputRow(const int stream, const NekDouble *row)
+{
+    if (m_binaryOutput)
+    {
+        // only opened on rank 0, like the text streams
+        if (m_binaryStream[stream])
+        {
+            m_binaryStream[stream]->Write(row);
+        }
+    }
+    else
+    {
+        TimeSeriesWriter::WriteTextRow(m_outputStream[stream],
+            stream == 0 ? m_forceColumns : m_motionColumns, row);
     }
 }
 
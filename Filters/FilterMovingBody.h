@@ -39,6 +39,8 @@
 #include <LibUtilities/BasicUtils/NekFactory.hpp>
 #include <LibUtilities/BasicUtils/SessionReader.h>
 #include <SolverUtils/Filters/Filter.h>
+#include "./TimeSeriesWriter.h"
+#include <vector>
 
 namespace Nektar
 {
@@ -96,6 +98,42 @@ class FilterMovingBody : public SolverUtils::Filter
         virtual bool v_IsTimeDependent();
 
     private:
+        /// Edge operator of one element on the force boundaries
+        struct TraceOperator
+        {
+            /// physical offset of the element in a plane
+            int                               m_offset;
+            int                               m_nq;
+            int                               m_nbc;
+            /// [d/dx; d/dy; trace] on the edge, (3 m_nbc) x m_nq
+            Array<OneD, NekDouble>            m_op;
+            Array<OneD, NekDouble>            m_normalX;
+            Array<OneD, NekDouble>            m_normalY;
+            /// quadrature weights of the edge integral
+            Array<OneD, NekDouble>            m_weights;
+        };
+
+        void DirectForces(
+            const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+            const NekDouble                                          mu,
+                  Array<OneD, NekDouble>                            &Fxp,
+                  Array<OneD, NekDouble>                            &Fxv,
+                  Array<OneD, NekDouble>                            &Fyp,
+                  Array<OneD, NekDouble>                            &Fyv);
+
+        void BuildTraceOperators(
+            const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields);
+
+        void OutputRow(const int stream, const NekDouble *row);
+
+        void TraceForces(
+            const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+            const NekDouble                                          mu,
+                  Array<OneD, NekDouble>                            &Fxp,
+                  Array<OneD, NekDouble>                            &Fxv,
+                  Array<OneD, NekDouble>                            &Fyp,
+                  Array<OneD, NekDouble>                            &Fyv);
+
         LibUtilities::SessionReaderSharedPtr m_session;
 
         /// ID's of boundary regions where we want the forces
@@ -117,6 +155,17 @@ class FilterMovingBody : public SolverUtils::Filter
         Array<OneD, std::ofstream>      m_outputStream;
         std::string                     m_outputFile_fce;
         std::string                     m_outputFile_mot;
+        /// write buffered binary files instead of text
+        bool                            m_binaryOutput;
+        Array<OneD, TimeSeriesWriterSharedPtr> m_binaryStream;
+        std::vector<TimeSeriesWriter::Column>  m_forceColumns;
+        std::vector<TimeSeriesWriter::Column>  m_motionColumns;
+        /// use the cached edge operators for the forces
+        bool                            m_useTraceOperators;
+        std::vector<TraceOperator>      m_traceOps;
+        Array<OneD, NekDouble>          m_traceWork;
+        NekDouble                       m_forceTime;
+        int                             m_forceCalls;
 };
 
 }
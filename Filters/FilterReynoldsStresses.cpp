@@ -34,6 +34,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "./FilterReynoldsStresses.h"
+#include <LibUtilities/Foundations/Interp.h>
 
 namespace Nektar
 {
@@ -63,14 +64,50 @@ std::string FilterReynoldsStresses::className =
  * It is also possible to perform the averages using an exponential moving
  *  average, in which case either the moving average parameter \f$ \alpha \f$
  * or the time constant \f$ \tau \f$ must be prescribed.
+ *
+ * The means and stresses are updated in a single pass over the points. Two
+ * optional parameters reduce the cost and the memory of the statistics:
+ * - StressPrecision = Single keeps the Reynolds stresses in single
+ *   precision (the means are always kept in double precision);
+ * - OrderReduction = k samples the velocities on k fewer quadrature points
+ *   per direction of each element, i.e. the statistics are computed in a
+ *   polynomial space of k orders less and interpolated back for output.
  */
 FilterReynoldsStresses::FilterReynoldsStresses(
     const LibUtilities::SessionReaderSharedPtr &pSession,
     const std::map<std::string, std::string> &pParams)
-    : FilterFieldConvert(pSession, pParams)
+    : FilterFieldConvert(pSession, pParams),
+      m_orderReduction(0),
+      m_nqSample(0),
+      m_singleStress(false),
+      m_sampleTime(0.0)
 {
     ParamMap::const_iterator it;
 
+    // Precision of the stresses
+    it = pParams.find("StressPrecision");
+    if (it != pParams.end())
+    {
+        if (boost::iequals(it->second, "Single"))
+        {
+            m_singleStress = true;
+        }
+        else
+        {
+            ASSERTL0(boost::iequals(it->second, "Double"),
+                     "StressPrecision should be Double or Single.");
+        }
+    }
+
+    // Coarser sampling space
+    it = pParams.find("OrderReduction");
+    if (it != pParams.end())
+    {
+        LibUtilities::Equation equ(m_session, it->second);
+        m_orderReduction = round(equ.Evaluate());
+        ASSERTL0(m_orderReduction >= 0, "OrderReduction must be >= 0.");
+    }
+
     // Check if should use moving average
     it = pParams.find("MovingAverage");
     if (it == pParams.end())
@@ -138,18 +175,42 @@ void FilterReynoldsStresses::v_Initialise(
     int dim          = pFields.num_elements() - 1;
     int nExtraFields = dim == 2 ? 3 : 6;
     int origFields   = pFields.num_elements();
+    int nq           = pFields[0]->GetTotPoints();
+    bool waveSpace   = pFields[0]->GetWaveSpace();
 
-    // Allocate storage
-    m_fields.resize(origFields + nExtraFields);
-    m_delta.resize(dim);
+    BuildCoarseSpace(pFields);
 
+    // Allocate storage, the pressure is kept in m_outFields
+    m_fields.resize(origFields + (m_singleStress ? 0 : nExtraFields));
     for (int n = 0; n < m_fields.size(); ++n)
     {
-        m_fields[n] = Array<OneD, NekDouble>(pFields[0]->GetTotPoints(), 0.0);
+        if (n != dim)
+        {
+            m_fields[n] = Array<OneD, NekDouble>(m_nqSample, 0.0);
+        }
     }
-    for (int n = 0; n < m_delta.size(); ++n)
+    if (m_singleStress)
     {
-        m_delta[n] = Array<OneD, NekDouble>(pFields[0]->GetTotPoints(), 0.0);
+        m_stressSingle.resize(nExtraFields);
+        for (int n = 0; n < nExtraFields; ++n)
+        {
+            m_stressSingle[n] = Array<OneD, float>(m_nqSample, 0.0f);
+        }
+    }
+
+    // Work space for velocities which are not available in physical space
+    // on the sampling points
+    m_vel = Array<OneD, Array<OneD, NekDouble> >(dim);
+    if (waveSpace || m_orderReduction > 0)
+    {
+        for (int n = 0; n < dim; ++n)
+        {
+            m_vel[n] = Array<OneD, NekDouble>(m_nqSample, 0.0);
+        }
+    }
+    if (waveSpace && m_orderReduction > 0)
+    {
+        m_physWork = Array<OneD, NekDouble>(nq, 0.0);
     }
 
     // Initialise output arrays
@@ -158,15 +219,23 @@ void FilterReynoldsStresses::v_Initialise(
     // Update m_fields if using restart file
     if (m_numSamples)
     {
-        for (int j = 0; j < m_fields.size(); ++j)
+        Array<OneD, NekDouble> phys(nq);
+        for (int j = 0; j < origFields + nExtraFields; ++j)
         {
-            pFields[0]->BwdTrans(m_outFields[j], m_fields[j]);
-            if (pFields[0]->GetWaveSpace())
+            if (j == dim)
             {
-                pFields[0]->HomogeneousBwdTrans(m_fields[j], m_fields[j]);
+                continue;
             }
+            pFields[0]->BwdTrans(m_outFields[j], phys);
+            if (waveSpace)
+            {
+                pFields[0]->HomogeneousBwdTrans(phys, phys);
+            }
+            StoreSampled(j, phys);
         }
     }
+
+    m_runTimer.Start();
 }
 
 void FilterReynoldsStresses::v_FillVariablesName(
@@ -201,12 +270,58 @@ void FilterReynoldsStresses::v_FillVariablesName(
     }
 }
 
+/**
+ * Single pass update of the means and of the stresses C_{ij}, see the class
+ * description. TStress is the storage type of the stresses.
+ */
+template <typename TStress>
+static void AccumulateSample(const int npts,
+                             const int dim,
+                             const NekDouble *const *vel,
+                             NekDouble *const *mean,
+                             TStress *const *stress,
+                             const bool withStress,
+                             const NekDouble facOld,
+                             const NekDouble facAvg,
+                             const NekDouble facStress,
+                             const NekDouble facDelta)
+{
+    NekDouble delta[3];
+
+    for (int q = 0; q < npts; ++q)
+    {
+        // Update mean velocities and calculate (\bar{u} - u_n)
+        for (int n = 0; n < dim; ++n)
+        {
+            NekDouble avg = facAvg * vel[n][q] + facOld * mean[n][q];
+            mean[n][q]    = avg;
+            delta[n]      = facDelta * avg - vel[n][q];
+        }
+
+        if (!withStress)
+        {
+            continue;
+        }
+
+        for (int i = 0, n = 0; i < dim; ++i)
+        {
+            for (int j = i; j < dim; ++j, ++n)
+            {
+                stress[n][q] = TStress(facStress * (delta[i] * delta[j]) +
+                                       facOld * stress[n][q]);
+            }
+        }
+    }
+}
+
 void FilterReynoldsStresses::v_ProcessSample(
     const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
     const NekDouble &time)
 {
-    int i, j, n;
-    int nq             = pFields[0]->GetTotPoints();
+    LibUtilities::Timer timer;
+    timer.Start();
+
+    int n;
     int dim            = pFields.num_elements() - 1;
     bool waveSpace     = pFields[0]->GetWaveSpace();
     NekDouble nSamples = (NekDouble)m_numSamples;
@@ -235,24 +350,37 @@ void FilterReynoldsStresses::v_ProcessSample(
         facDelta  = 1.0 / nSamples;
     }
 
-    Array<OneD, NekDouble> vel(nq);
-    Array<OneD, NekDouble> tmp(nq);
-
-    // Update original velocities in phys space and calculate (\bar{u} - u_n)
+    // Original velocities in phys space on the sampling points
+    const NekDouble *vel[3];
+    NekDouble *mean[3];
     for (n = 0; n < dim; ++n)
     {
-        if (waveSpace)
+        if (m_orderReduction > 0)
         {
-            pFields[n]->HomogeneousBwdTrans(pFields[n]->GetPhys(), vel);
+            if (waveSpace)
+            {
+                pFields[n]->HomogeneousBwdTrans(pFields[n]->GetPhys(),
+                                                m_physWork);
+                CoarsenPhys(m_physWork.get(), m_vel[n].get());
+            }
+            else
+            {
+                CoarsenPhys(pFields[n]->GetPhys().get(), m_vel[n].get());
+            }
+            vel[n] = m_vel[n].get();
+        }
+        else if (waveSpace)
+        {
+            pFields[n]->HomogeneousBwdTrans(pFields[n]->GetPhys(), m_vel[n]);
+            vel[n] = m_vel[n].get();
         }
         else
         {
-            vel = pFields[n]->GetPhys();
+            vel[n] = pFields[n]->GetPhys().get();
         }
-        Vmath::Svtsvtp(
-            nq, facAvg, vel, 1, facOld, m_fields[n], 1, m_fields[n], 1);
-        Vmath::Svtvm(nq, facDelta, m_fields[n], 1, vel, 1, m_delta[n], 1);
+        mean[n] = m_fields[n].get();
     }
+
     // Update pressure (directly to outFields)
     Vmath::Svtsvtp(m_outFields[dim].num_elements(),
                    facAvg,
@@ -264,22 +392,33 @@ void FilterReynoldsStresses::v_ProcessSample(
                    m_outFields[dim],
                    1);
 
-    // Ignore Reynolds stress for first sample (its contribution is zero)
-    if (m_numSamples == 1)
+    // Calculate C_{n} = facOld * C_{n-1} + facStress * deltaI * deltaJ,
+    // ignoring the first sample (its contribution is zero)
+    bool withStress = m_numSamples > 1;
+    int nStress     = dim == 2 ? 3 : 6;
+    if (m_singleStress)
     {
-        return;
+        float *stress[6];
+        for (n = 0; n < nStress; ++n)
+        {
+            stress[n] = m_stressSingle[n].get();
+        }
+        AccumulateSample(m_nqSample, dim, vel, mean, stress, withStress,
+                         facOld, facAvg, facStress, facDelta);
     }
-
-    // Calculate C_{n} = facOld * C_{n-1} + facStress * deltaI * deltaJ
-    for (i = 0, n = dim + 1; i < dim; ++i)
+    else
     {
-        for (j = i; j < dim; ++j, ++n)
+        NekDouble *stress[6];
+        for (n = 0; n < nStress; ++n)
         {
-            Vmath::Vmul(nq, m_delta[i], 1, m_delta[j], 1, tmp, 1);
-            Vmath::Svtsvtp(
-                nq, facStress, tmp, 1, facOld, m_fields[n], 1, m_fields[n], 1);
+            stress[n] = m_fields[dim + 1 + n].get();
         }
+        AccumulateSample(m_nqSample, dim, vel, mean, stress, withStress,
+                         facOld, facAvg, facStress, facDelta);
     }
+
+    timer.Stop();
+    m_sampleTime += timer.TimePerTest(1);
 }
 
 void FilterReynoldsStresses::v_PrepareOutput(
@@ -296,11 +435,38 @@ void FilterReynoldsStresses::v_PrepareOutput(
     pFields[0]->SetWaveSpace(false);
 
     // Forward transform and put into m_outFields (except pressure)
-    for (int i = 0; i < m_fields.size(); ++i)
+    int nq      = pFields[0]->GetTotPoints();
+    int nFields = pFields.num_elements() + (dim == 2 ? 3 : 6);
+    Array<OneD, NekDouble> stat, work(m_nqSample), phys(nq);
+    for (int i = 0; i < nFields; ++i)
     {
-        if (i != dim)
+        if (i == dim)
+        {
+            continue;
+        }
+
+        if (i > dim && m_singleStress)
+        {
+            const float *stress = m_stressSingle[i - dim - 1].get();
+            for (int q = 0; q < m_nqSample; ++q)
+            {
+                work[q] = stress[q];
+            }
+            stat = work;
+        }
+        else
+        {
+            stat = m_fields[i];
+        }
+
+        if (m_orderReduction > 0)
+        {
+            RefinePhys(stat.get(), phys.get());
+            pFields[0]->FwdTrans_IterPerExp(phys, m_outFields[i]);
+        }
+        else
         {
-            pFields[0]->FwdTrans_IterPerExp(m_fields[i], m_outFields[i]);
+            pFields[0]->FwdTrans_IterPerExp(stat, m_outFields[i]);
         }
     }
 
@@ -308,6 +474,167 @@ void FilterReynoldsStresses::v_PrepareOutput(
     pFields[0]->SetWaveSpace(waveSpace);
 }
 
+void FilterReynoldsStresses::v_Finalise(
+    const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+    const NekDouble &time)
+{
+    FilterFieldConvert::v_Finalise(pFields, time);
+
+    m_runTimer.Stop();
+    NekDouble runTime = m_runTimer.TimePerTest(1);
+    if (pFields[0]->GetComm()->GetRank() == 0 && runTime > 0.0)
+    {
+        std::cout << "FilterReynoldsStresses: " << m_numSamples
+                  << " samples on " << m_nqSample << " points took "
+                  << m_sampleTime << " s, " << 100.0 * m_sampleTime / runTime
+                  << "% of the run time" << std::endl;
+    }
+}
+
+/**
+ * Sets up the interpolation to a coarser set of sampling points per
+ * element, each direction having OrderReduction fewer points of the same
+ * type (and at least two).
+ */
+void FilterReynoldsStresses::BuildCoarseSpace(
+    const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields)
+{
+    m_coarseBlocks.clear();
+    m_nqSample = pFields[0]->GetTotPoints();
+
+    if (m_orderReduction == 0)
+    {
+        return;
+    }
+
+    // Homogeneous expansions are coarsened plane by plane
+    MultiRegions::ExpListSharedPtr base = pFields[0];
+    int nplanes = 1;
+    if (pFields[0]->GetExpType() == MultiRegions::e3DH1D)
+    {
+        base    = pFields[0]->GetPlane(0);
+        nplanes = pFields[0]->GetZIDs().num_elements();
+    }
+    else
+    {
+        ASSERTL0(pFields[0]->GetExpType() == MultiRegions::e2D ||
+                 pFields[0]->GetExpType() == MultiRegions::e3D,
+                 "OrderReduction requires a 2D, 3D or 3DH1D expansion.");
+    }
+
+    int nPlanePts = base->GetTotPoints();
+    int cnt       = 0;
+    for (int p = 0; p < nplanes; ++p)
+    {
+        for (int e = 0; e < base->GetExpSize(); ++e)
+        {
+            LocalRegions::ExpansionSharedPtr exp = base->GetExp(e);
+
+            CoarseBlock block;
+            block.m_fineOffset   = p * nPlanePts + base->GetPhys_Offset(e);
+            block.m_coarseOffset = cnt;
+
+            int ncq = 1;
+            for (int d = 0; d < exp->GetShapeDimension(); ++d)
+            {
+                const LibUtilities::PointsKey &key =
+                    exp->GetBasis(d)->GetPointsKey();
+                int npts = std::max(key.GetNumPoints() - m_orderReduction, 2);
+                npts     = std::min(npts, key.GetNumPoints());
+
+                block.m_fine.push_back(key);
+                block.m_coarse.push_back(
+                    LibUtilities::PointsKey(npts, key.GetPointsType()));
+                ncq *= npts;
+            }
+
+            m_coarseBlocks.push_back(block);
+            cnt += ncq;
+        }
+    }
+    m_nqSample = cnt;
+}
+
+void FilterReynoldsStresses::CoarsenPhys(const NekDouble *fine,
+                                         NekDouble *coarse)
+{
+    for (int b = 0; b < m_coarseBlocks.size(); ++b)
+    {
+        const CoarseBlock &block = m_coarseBlocks[b];
+        if (block.m_fine.size() == 2)
+        {
+            LibUtilities::Interp2D(block.m_fine[0], block.m_fine[1],
+                                   fine + block.m_fineOffset,
+                                   block.m_coarse[0], block.m_coarse[1],
+                                   coarse + block.m_coarseOffset);
+        }
+        else
+        {
+            LibUtilities::Interp3D(block.m_fine[0], block.m_fine[1],
+                                   block.m_fine[2],
+                                   fine + block.m_fineOffset,
+                                   block.m_coarse[0], block.m_coarse[1],
+                                   block.m_coarse[2],
+                                   coarse + block.m_coarseOffset);
+        }
+    }
+}
+
+void FilterReynoldsStresses::RefinePhys(const NekDouble *coarse,
+                                        NekDouble *fine)
+{
+    for (int b = 0; b < m_coarseBlocks.size(); ++b)
+    {
+        const CoarseBlock &block = m_coarseBlocks[b];
+        if (block.m_fine.size() == 2)
+        {
+            LibUtilities::Interp2D(block.m_coarse[0], block.m_coarse[1],
+                                   coarse + block.m_coarseOffset,
+                                   block.m_fine[0], block.m_fine[1],
+                                   fine + block.m_fineOffset);
+        }
+        else
+        {
+            LibUtilities::Interp3D(block.m_coarse[0], block.m_coarse[1],
+                                   block.m_coarse[2],
+                                   coarse + block.m_coarseOffset,
+                                   block.m_fine[0], block.m_fine[1],
+                                   block.m_fine[2],
+                                   fine + block.m_fineOffset);
+        }
+    }
+}
+
+/**
+ * Stores the physical values \a phys (on the quadrature points) of output
+ * field \a field in the sampled statistics, used when restarting.
+ */
+void FilterReynoldsStresses::StoreSampled(const int field,
+                                          const Array<OneD, NekDouble> &phys)
+{
+    int dim = m_vel.num_elements();
+
+    Array<OneD, NekDouble> sampled = phys;
+    if (m_orderReduction > 0)
+    {
+        sampled = Array<OneD, NekDouble>(m_nqSample);
+        CoarsenPhys(phys.get(), sampled.get());
+    }
+
+    if (field > dim && m_singleStress)
+    {
+        float *stress = m_stressSingle[field - dim - 1].get();
+        for (int q = 0; q < m_nqSample; ++q)
+        {
+            stress[q] = float(sampled[q]);
+        }
+    }
+    else
+    {
+        Vmath::Vcopy(m_nqSample, sampled, 1, m_fields[field], 1);
+    }
+}
+
 NekDouble FilterReynoldsStresses::v_GetScale()
 {
     if (m_movAvg)
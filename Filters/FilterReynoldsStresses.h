@@ -37,6 +37,7 @@
 #define NEKTAR_SOLVERUTILS_FILTERS_FILTERREYNOLDSSTRESSES_H
 
 #include <SolverUtils/Filters/FilterFieldConvert.h>
+#include <LibUtilities/BasicUtils/Timer.h>
 
 namespace Nektar
 {
@@ -78,16 +79,49 @@ protected:
     virtual void v_PrepareOutput(
         const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
         const NekDouble &time);
+    virtual void v_Finalise(
+        const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+        const NekDouble &time);
     virtual NekDouble v_GetScale();
     virtual std::string v_GetFileSuffix()
     {
         return "_stress";
     }
 
+    /// Interpolation between the quadrature points of one element (or one
+    /// element of a homogeneous plane) and its coarser sampling points
+    struct CoarseBlock
+    {
+        int m_fineOffset;
+        int m_coarseOffset;
+        std::vector<LibUtilities::PointsKey> m_fine;
+        std::vector<LibUtilities::PointsKey> m_coarse;
+    };
+
+    void BuildCoarseSpace(
+        const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields);
+    void CoarsenPhys(const NekDouble *fine, NekDouble *coarse);
+    void RefinePhys(const NekDouble *coarse, NekDouble *fine);
+    void StoreSampled(const int field, const Array<OneD, NekDouble> &phys);
+
     std::vector<Array<OneD, NekDouble> > m_fields;
-    std::vector<Array<OneD, NekDouble> > m_delta;
     NekDouble m_alpha;
     bool m_movAvg;
+
+    /// Number of quadrature points per direction dropped for sampling
+    int m_orderReduction;
+    /// Number of sampled points (GetTotPoints() if m_orderReduction is 0)
+    int m_nqSample;
+    std::vector<CoarseBlock> m_coarseBlocks;
+    /// Keep the Reynolds stresses in single precision
+    bool m_singleStress;
+    std::vector<Array<OneD, float> > m_stressSingle;
+    /// Velocities on the sampling points, physical-space work array
+    Array<OneD, Array<OneD, NekDouble> > m_vel;
+    Array<OneD, NekDouble> m_physWork;
+
+    LibUtilities::Timer m_runTimer;
+    NekDouble m_sampleTime;
 };
 }
 }
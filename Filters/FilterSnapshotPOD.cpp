@@ -0,0 +1,324 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File FilterSnapshotPOD.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Incremental POD of the flow fields during time-stepping.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <LibUtilities/BasicUtils/FieldIO.h>
+#include <iomanip>
+#include "./FilterSnapshotPOD.h"
+
+using namespace std;
+
+namespace Nektar
+{
+
+std::string FilterSnapshotPOD::className = SolverUtils::GetFilterFactory().
+        RegisterCreatorFunction("SnapshotPOD",
+                                FilterSnapshotPOD::create,
+                                "Incremental POD of the flow fields");
+/**
+ *
+ */
+FilterSnapshotPOD::FilterSnapshotPOD(
+        const LibUtilities::SessionReaderSharedPtr &pSession,
+        const ParamMap &pParams)
+    : Filter(pSession),
+      m_session(pSession)
+{
+    ParamMap::const_iterator it;
+
+    // OutputFile
+    it = pParams.find("OutputFile");
+    if (it == pParams.end())
+    {
+        m_outputFile = pSession->GetSessionName() + "_pod";
+    }
+    else
+    {
+        ASSERTL0(it->second.length() > 0, "Missing parameter 'OutputFile'.");
+        m_outputFile = it->second;
+    }
+
+    // SampleFrequency
+    it = pParams.find("SampleFrequency");
+    if (it == pParams.end())
+    {
+        m_sampleFrequency = 1;
+    }
+    else
+    {
+        LibUtilities::Equation equ(m_session, it->second);
+        m_sampleFrequency = round(equ.Evaluate());
+    }
+
+    // MaxModes
+    it = pParams.find("MaxModes");
+    if (it == pParams.end())
+    {
+        m_maxModes = 20;
+    }
+    else
+    {
+        LibUtilities::Equation equ(m_session, it->second);
+        m_maxModes = round(equ.Evaluate());
+    }
+    ASSERTL0(m_maxModes > 0, "MaxModes has to be positive.");
+
+    // Tolerance
+    it = pParams.find("Tolerance");
+    if (it == pParams.end())
+    {
+        m_tolerance = 1e-10;
+    }
+    else
+    {
+        LibUtilities::Equation equ(m_session, it->second);
+        m_tolerance = equ.Evaluate();
+    }
+}
+
+
+/**
+ *
+ */
+FilterSnapshotPOD::~FilterSnapshotPOD()
+{
+
+}
+
+
+/**
+ *
+ */
+void FilterSnapshotPOD::v_Initialise(
+    const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+    const NekDouble &time)
+{
+    m_index      = 0;
+    m_numSamples = 0;
+    m_comm       = pFields[0]->GetComm();
+
+    m_offset = Array<OneD, int>(pFields.num_elements() + 1, 0);
+    for (int i = 0; i < pFields.num_elements(); ++i)
+    {
+        m_offset[i+1] = m_offset[i] + pFields[i]->GetNcoeffs();
+    }
+
+    m_basis          = Eigen::MatrixXd::Zero(m_offset[pFields.num_elements()], 0);
+    m_singularValues = Eigen::VectorXd::Zero(0);
+}
+
+
+/**
+ * The coefficients are sampled rather than the physical values since the
+ * pressure is only kept up to date in coefficient space, and they can be
+ * written back to fld files without a forward transform.
+ */
+void FilterSnapshotPOD::v_Update(
+    const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+    const NekDouble &time)
+{
+    if (m_index++ % m_sampleFrequency > 0)
+    {
+        return;
+    }
+
+    Eigen::VectorXd snapshot(m_offset[pFields.num_elements()]);
+    for (int i = 0; i < pFields.num_elements(); ++i)
+    {
+        Vmath::Vcopy(pFields[i]->GetNcoeffs(), pFields[i]->GetCoeffs().get(),
+                     1, &snapshot(m_offset[i]), 1);
+    }
+
+    AddSnapshot(snapshot);
+    ++m_numSamples;
+}
+
+
+/**
+ * Rank-one update of the thin SVD U S V^T of the snapshots seen so far.
+ * With p = U^T c and r = c - U p, the new snapshot matrix is
+ *
+ *   [U r/|r|] [S p; 0 |r|] [V 0; 0 1]^T
+ *
+ * so only the SVD of the small (k+1)x(k+1) middle matrix is required. V is
+ * not needed for the basis and is not stored.
+ */
+void FilterSnapshotPOD::AddSnapshot(const Eigen::VectorXd &snapshot)
+{
+    int k = m_singularValues.size();
+
+    // Gram-Schmidt against the current basis, repeated once for stability
+    Eigen::VectorXd p = Eigen::VectorXd::Zero(k);
+    Eigen::VectorXd r = snapshot;
+    for (int pass = 0; pass < 2 && k > 0; ++pass)
+    {
+        Eigen::VectorXd q = m_basis.transpose() * r;
+        GlobalSum(q);
+        r -= m_basis * q;
+        p += q;
+    }
+
+    NekDouble norm_c = snapshot.squaredNorm();
+    NekDouble rho    = r.squaredNorm();
+    m_comm->AllReduce(norm_c, LibUtilities::ReduceSum);
+    m_comm->AllReduce(rho, LibUtilities::ReduceSum);
+    norm_c = sqrt(norm_c);
+    rho    = sqrt(rho);
+
+    if (norm_c == 0.0)
+    {
+        return;
+    }
+
+    // drop the residual direction if it is below round-off
+    if (rho <= 1e-14 * norm_c)
+    {
+        rho = 0.0;
+    }
+
+    Eigen::MatrixXd K = Eigen::MatrixXd::Zero(k + 1, k + 1);
+    K.topLeftCorner(k, k) = m_singularValues.asDiagonal();
+    K.block(0, k, k, 1)   = p;
+    K(k, k)               = rho;
+
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(K, Eigen::ComputeFullU);
+    Eigen::VectorXd sigma = svd.singularValues();
+
+    int newk = 1;
+    while (newk < k + 1 && newk < m_maxModes &&
+           sigma(newk) > m_tolerance * sigma(0))
+    {
+        ++newk;
+    }
+
+    Eigen::MatrixXd extended(m_basis.rows(), k + 1);
+    extended.leftCols(k) = m_basis;
+    if (rho > 0.0)
+    {
+        extended.col(k) = r / rho;
+    }
+    else
+    {
+        extended.col(k).setZero();
+    }
+
+    m_basis          = extended * svd.matrixU().leftCols(newk);
+    m_singularValues = sigma.head(newk);
+}
+
+
+void FilterSnapshotPOD::GlobalSum(Eigen::VectorXd &vec)
+{
+    if (m_comm->GetSize() == 1)
+    {
+        return;
+    }
+    Array<OneD, NekDouble> tmp(vec.size());
+    Vmath::Vcopy(vec.size(), vec.data(), 1, &tmp[0], 1);
+    m_comm->AllReduce(tmp, LibUtilities::ReduceSum);
+    Vmath::Vcopy(vec.size(), &tmp[0], 1, vec.data(), 1);
+}
+
+
+/**
+ *
+ */
+void FilterSnapshotPOD::v_Finalise(
+    const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+    const NekDouble &time)
+{
+    int nmodes = m_singularValues.size();
+
+    LibUtilities::FieldIOSharedPtr fld =
+        LibUtilities::FieldIO::CreateDefault(m_session);
+
+    for (int j = 0; j < nmodes; ++j)
+    {
+        std::vector<LibUtilities::FieldDefinitionsSharedPtr> FieldDef
+            = pFields[0]->GetFieldDefinitions();
+        std::vector<std::vector<NekDouble> > FieldData(FieldDef.size());
+
+        for (int n = 0; n < pFields.num_elements(); ++n)
+        {
+            Array<OneD, NekDouble> coeffs(pFields[n]->GetNcoeffs());
+            Vmath::Vcopy(pFields[n]->GetNcoeffs(),
+                         &m_basis(m_offset[n], j), 1, coeffs.get(), 1);
+            for (int i = 0; i < FieldDef.size(); ++i)
+            {
+                FieldDef[i]->m_fields.push_back(m_session->GetVariable(n));
+                pFields[n]->AppendFieldData(FieldDef[i], FieldData[i], coeffs);
+            }
+        }
+
+        LibUtilities::FieldMetaDataMap fieldMetaDataMap;
+        fieldMetaDataMap["Time"] =
+            boost::lexical_cast<std::string>(time);
+        fieldMetaDataMap["SingularValue"] =
+            boost::lexical_cast<std::string>(m_singularValues(j));
+        fieldMetaDataMap["NumberOfSamples"] =
+            boost::lexical_cast<std::string>(m_numSamples);
+
+        std::stringstream outname;
+        outname << m_outputFile << "_mode" << j << ".fld";
+        fld->Write(outname.str(), FieldDef, FieldData, fieldMetaDataMap);
+    }
+
+    if (m_comm->GetRank() == 0)
+    {
+        std::ofstream svFile((m_outputFile + ".sv").c_str());
+        svFile << "# " << m_numSamples << " samples, " << nmodes
+               << " modes" << endl;
+        for (int j = 0; j < nmodes; ++j)
+        {
+            svFile << j << " " << std::setprecision(17)
+                   << m_singularValues(j) << endl;
+        }
+        svFile.close();
+
+        cout << "SnapshotPOD: " << nmodes << " modes from " << m_numSamples
+             << " samples written to " << m_outputFile << "_mode*.fld"
+             << endl;
+    }
+}
+
+
+/**
+ *
+ */
+bool FilterSnapshotPOD::v_IsTimeDependent()
+{
+    return true;
+}
+
+}
@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File FilterSnapshotPOD.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Incremental POD of the flow fields during time-stepping.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_INCNAVIERSTOKES_FILTERS_FILTERSNAPSHOTPOD_H
+#define NEKTAR_INCNAVIERSTOKES_FILTERS_FILTERSNAPSHOTPOD_H
+
+#include <LibUtilities/BasicUtils/NekFactory.hpp>
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <SolverUtils/Filters/Filter.h>
+#include "../Eigen/Dense"
+
+namespace Nektar
+{
+
+/**
+ * Collects snapshots of all fields every SampleFrequency steps and folds
+ * them into a rank-truncated thin SVD (Brand's incremental update), so no
+ * snapshot is ever stored or written. At the end of the run the basis is
+ * written as one fld file per mode and the singular values as a text file.
+ */
+class FilterSnapshotPOD : public SolverUtils::Filter
+{
+    public:
+        friend class MemoryManager<FilterSnapshotPOD>;
+
+        /// Creates an instance of this class
+        static SolverUtils::FilterSharedPtr create(
+            const LibUtilities::SessionReaderSharedPtr &pSession,
+            const ParamMap &pParams) {
+            SolverUtils::FilterSharedPtr p = MemoryManager<FilterSnapshotPOD>
+                    ::AllocateSharedPtr(pSession, pParams);
+            return p;
+        }
+
+        static std::string className;
+
+        FilterSnapshotPOD(
+            const LibUtilities::SessionReaderSharedPtr &pSession,
+            const ParamMap &pParams);
+        ~FilterSnapshotPOD();
+
+    protected:
+        virtual void v_Initialise(
+            const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+            const NekDouble &time);
+
+        virtual void v_Update(
+            const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+            const NekDouble &time);
+
+        virtual void v_Finalise(
+            const Array<OneD, const MultiRegions::ExpListSharedPtr> &pFields,
+            const NekDouble &time);
+
+        virtual bool v_IsTimeDependent();
+
+        void AddSnapshot(const Eigen::VectorXd &snapshot);
+
+        void GlobalSum(Eigen::VectorXd &vec);
+
+    private:
+        LibUtilities::SessionReaderSharedPtr m_session;
+        LibUtilities::CommSharedPtr     m_comm;
+        std::string                     m_outputFile;
+        unsigned int                    m_sampleFrequency;
+        unsigned int                    m_index;
+        unsigned int                    m_numSamples;
+        /// Upper bound on the number of retained modes
+        int                             m_maxModes;
+        /// Modes with sigma_i < m_tolerance * sigma_0 are dropped
+        NekDouble                       m_tolerance;
+        /// Offsets of the fields in the stacked coefficient vector
+        Array<OneD, int>                m_offset;
+        /// Local part of the left singular vectors, one column per mode
+        Eigen::MatrixXd                 m_basis;
+        Eigen::VectorXd                 m_singularValues;
+};
+
+}
+
+#endif /* NEKTAR_INCNAVIERSTOKES_FILTERS_FILTERSNAPSHOTPOD_H */
@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File TimeSeriesWriter.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Buffered binary output of filter time series
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./TimeSeriesWriter.h"
+#include <LibUtilities/BasicUtils/ErrorUtil.hpp>
+#include <iomanip>
+
+namespace Nektar
+{
+    namespace
+    {
+        const char FileTag[8] = {'N','E','K','T','S','B','I','N'};
+
+        void WriteInt(std::ostream &out, int value)
+        {
+            out.write(reinterpret_cast<const char *>(&value), sizeof(int));
+        }
+
+        int ReadInt(std::istream &in)
+        {
+            int value = 0;
+            in.read(reinterpret_cast<char *>(&value), sizeof(int));
+            return value;
+        }
+    }
+
+    TimeSeriesWriter::TimeSeriesWriter(
+        const std::string         &filename,
+        const std::vector<Column> &columns,
+        const size_t               flushBytes,
+        const NekDouble            flushSeconds)
+        : m_file(filename.c_str(), std::ios::binary),
+          m_columns(columns),
+          m_flushValues(flushBytes/sizeof(NekDouble)),
+          m_flushSeconds(flushSeconds),
+          m_lastFlush(std::time(NULL))
+    {
+        ASSERTL0(m_file.good(), "Cannot open " + filename);
+
+        m_file.write(FileTag, 8);
+        WriteInt(m_file, 1);
+        WriteInt(m_file, m_columns.size());
+        for (int i = 0; i < m_columns.size(); ++i)
+        {
+            WriteInt(m_file, m_columns[i].m_width);
+            WriteInt(m_file, m_columns[i].m_precision);
+            WriteInt(m_file, m_columns[i].m_name.size());
+            m_file.write(m_columns[i].m_name.c_str(),
+                         m_columns[i].m_name.size());
+        }
+        m_file.flush();
+
+        m_buffer.reserve(m_flushValues + m_columns.size());
+    }
+
+    TimeSeriesWriter::~TimeSeriesWriter()
+    {
+        Flush();
+    }
+
+    void TimeSeriesWriter::Write(const NekDouble *row)
+    {
+        m_buffer.insert(m_buffer.end(), row, row + m_columns.size());
+
+        if (m_buffer.size() >= m_flushValues ||
+            std::difftime(std::time(NULL), m_lastFlush) >= m_flushSeconds)
+        {
+            Flush();
+        }
+    }
+
+    void TimeSeriesWriter::Flush()
+    {
+        if (!m_buffer.empty())
+        {
+            m_file.write(reinterpret_cast<const char *>(&m_buffer[0]),
+                         m_buffer.size()*sizeof(NekDouble));
+            m_buffer.clear();
+        }
+        m_file.flush();
+        m_lastFlush = std::time(NULL);
+    }
+
+    void TimeSeriesWriter::WriteTextHeader(
+        std::ostream              &out,
+        const std::vector<Column> &columns)
+    {
+        out << "#";
+        for (int i = 0; i < columns.size(); ++i)
+        {
+            out.width(i == 0 ? columns[i].m_width - 1 : columns[i].m_width);
+            out << columns[i].m_name;
+        }
+        out << std::endl;
+    }
+
+    void TimeSeriesWriter::WriteTextRow(
+        std::ostream              &out,
+        const std::vector<Column> &columns,
+        const NekDouble           *row)
+    {
+        for (int i = 0; i < columns.size(); ++i)
+        {
+            out.width(columns[i].m_width);
+            out << std::setprecision(columns[i].m_precision) << row[i];
+        }
+        out << std::endl;
+    }
+
+    void TimeSeriesWriter::ConvertToText(
+        const std::string &infile,
+        std::ostream      &out)
+    {
+        std::ifstream in(infile.c_str(), std::ios::binary);
+        ASSERTL0(in.good(), "Cannot open " + infile);
+
+        char tag[8];
+        in.read(tag, 8);
+        ASSERTL0(in.good() && std::equal(tag, tag + 8, FileTag),
+                 infile + " is not a binary time series");
+        ASSERTL0(ReadInt(in) == 1, "Unknown time series version in " + infile);
+
+        int ncols = ReadInt(in);
+        std::vector<Column> columns;
+        for (int i = 0; i < ncols; ++i)
+        {
+            int width     = ReadInt(in);
+            int precision = ReadInt(in);
+            std::string name(ReadInt(in), ' ');
+            in.read(&name[0], name.size());
+            columns.push_back(Column(name, width, precision));
+        }
+        ASSERTL0(in.good(), "Truncated header in " + infile);
+
+        WriteTextHeader(out, columns);
+
+        std::vector<NekDouble> row(ncols);
+        while (in.read(reinterpret_cast<char *>(&row[0]),
+                       ncols*sizeof(NekDouble)))
+        {
+            WriteTextRow(out, columns, &row[0]);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File TimeSeriesWriter.h
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: Buffered binary output of filter time series
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEKTAR_SOLVERS_TIMESERIESWRITER_H
+#define NEKTAR_SOLVERS_TIMESERIESWRITER_H
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <boost/shared_ptr.hpp>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Nektar
+{
+    class TimeSeriesWriter;
+    typedef boost::shared_ptr<TimeSeriesWriter> TimeSeriesWriterSharedPtr;
+
+    /**
+     * Writes rows of a fixed number of doubles to a binary file. Rows are
+     * collected in memory and written when the buffer exceeds a size or
+     * when the last write is older than a time threshold, and on
+     * destruction. The header records, for each column, its name and the
+     * width and precision of the text output the filters used to write,
+     * so that ConvertToText reproduces that layout (see the utility
+     * TimeSeriesToText).
+     */
+    class TimeSeriesWriter
+    {
+    public:
+        struct Column
+        {
+            Column(const std::string &name, int width, int precision)
+                : m_name(name), m_width(width), m_precision(precision)
+            {
+            }
+
+            std::string m_name;
+            int         m_width;
+            int         m_precision;
+        };
+
+        TimeSeriesWriter(const std::string         &filename,
+                         const std::vector<Column> &columns,
+                         const size_t               flushBytes   = 1 << 20,
+                         const NekDouble            flushSeconds = 30.0);
+
+        ~TimeSeriesWriter();
+
+        /// Append one row of GetNumColumns() values.
+        void Write(const NekDouble *row);
+
+        void Flush();
+
+        int GetNumColumns() const
+        {
+            return m_columns.size();
+        }
+
+        /// Text output with one line per row, formatted as the filters do.
+        static void WriteTextRow(std::ostream              &out,
+                                 const std::vector<Column> &columns,
+                                 const NekDouble           *row);
+
+        /// Header line of the text output.
+        static void WriteTextHeader(std::ostream              &out,
+                                    const std::vector<Column> &columns);
+
+        /// Convert a binary file to the text layout.
+        static void ConvertToText(const std::string &infile,
+                                  std::ostream      &out);
+
+    protected:
+        std::ofstream          m_file;
+        std::vector<Column>    m_columns;
+        std::vector<NekDouble> m_buffer;
+        size_t                 m_flushValues;
+        NekDouble              m_flushSeconds;
+        std::time_t            m_lastFlush;
+    };
+}
+
+#endif
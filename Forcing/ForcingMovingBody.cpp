@@ -36,6 +36,9 @@
 
 #include "./ForcingMovingBody.h"
 #include <MultiRegions/ExpList.h>
+#include <LibUtilities/LinearAlgebra/Blas.hpp>
+#include <LibUtilities/LinearAlgebra/Lapack.hpp>
+#include <algorithm>
 
 using namespace std;
 
@@ -398,133 +401,71 @@ void ForcingMovingBody::EvaluateStructDynModel(
         }
     }
 
+    // hand the displacements and velocities over to all planes of each
+    // processor: the root fills m_MotionBcast, the other ranks contribute
+    // zeros, so that a single reduction acts as a broadcast
     Array<OneD, NekDouble> Motvars(2*2*m_np);
-    // send physical coeffients to all planes of each processor
+    Array<OneD, NekDouble> tmp, tmp1;
     if(!homostrip)//full resolutions
     {
-        Array<OneD, NekDouble> tmp(2*2*m_np);
-
-        if(colrank != 0)
+        if(colrank == 0)
         {
-            vcomm->GetColumnComm()->Recv(0, tmp);
-            Vmath::Vcopy(2*2*m_np, tmp, 1, Motvars, 1);
+            for(int j = 0; j < 2; j++) //moving dimensions
+            {
+                // disp. and vel. are contiguous in m_MotionVars
+                Vmath::Vcopy(2*npts, m_MotionVars[j], 1,
+                             tmp = m_MotionBcast + j*2*npts, 1);
+            }
         }
         else
         {
-            for (int i = 1; i < nproc; ++i)
-            {
-                for(int j = 0; j < 2; j++) //moving dimensions
-                {
-                    for(int k = 0; k < 2; k++) //disp. and vel.
-                    {
-                        for (int n = 0; n < m_np; n++)
-                        {
-                            tmp[j*2*m_np+k*m_np+n] = m_MotionVars[j][k*npts+i*m_np+n];
-                        }
-                    }
-                }
-                vcomm->GetColumnComm()->Send(i, tmp);
-            }
+            Vmath::Zero(2*2*npts, m_MotionBcast, 1);
+        }
+        vcomm->GetColumnComm()->AllReduce(m_MotionBcast,
+                                          LibUtilities::ReduceSum);
 
-            for(int j = 0; j < 2; j++)
+        for(int j = 0; j < 2; j++) //moving dimensions
+        {
+            for(int k = 0; k < 2; k++) //disp. and vel.
             {
-                for(int k = 0; k < 2; k++)
-                {
-                    for(int n = 0; n < m_np; n++)
-                    {
-                        tmp[j*2*m_np+k*m_np+n] = m_MotionVars[j][k*npts+n];
-                    }
-                    Vmath::Vcopy(2*2*m_np, tmp, 1, Motvars, 1);
-                }
+                Vmath::Vcopy(m_np,
+                    tmp = m_MotionBcast + j*2*npts + k*npts + colrank*m_np, 1,
+                    tmp1 = Motvars + j*2*m_np + k*m_np, 1);
             }
         }
     }
     else //strip modelling
     {
-        Array<OneD, NekDouble> tmp(2*2);
-
-        if(colrank != 0)
+        if(colrank == 0)
         {
-            for (int j = 1; j < nproc/nstrips; j++)
-            {
-                if(colrank == j*nstrips)
-                {
-                    vcomm->GetColumnComm()->Recv(0, tmp);
-
-                    for(int plane = 0; plane < m_np; plane++)
-                    {
-                        for(int var = 0; var < 2; var++)
-                        {
-                            for(int k = 0; k < 2; k++)
-                            {
-                                Motvars[var*2*m_np+k*m_np+plane]= tmp[var*2+k];
-                            }
-                        }
-                    }
-                }
-            }
-
-            for(int i = 1; i < nstrips; i++)
+            for(int j = 0; j < 2; ++j)
             {
-                for (int j = 0; j < nproc/nstrips; j++)
+                for(int k = 0; k < 2; ++k)
                 {
-                    if(colrank == i+j*nstrips)
-                    {
-                        vcomm->GetColumnComm()->Recv(0, tmp);
-
-                        for(int plane = 0; plane < m_np; plane++)
-                        {
-                            for(int var = 0; var < 2; var++)
-                            {
-                                for(int k = 0; k < 2; k++)
-                                {
-                                    Motvars[var*2*m_np+k*m_np+plane] = tmp[var*2+k];
-                                }
-                            }
-                        }
-                    }
+                    Vmath::Vcopy(nstrips, tmp = m_MotionVars[j] + k*npts, 1,
+                                 tmp1 = m_MotionBcast + (j*2+k)*nstrips, 1);
                 }
             }
         }
         else
         {
-            for(int j = 0; j < 2; ++j)
-            {
-                for(int k = 0; k < 2; ++k)
-                {
-                    tmp[j*2+k] = m_MotionVars[j][k*npts];
-                }
-            }
+            Vmath::Zero(2*2*nstrips, m_MotionBcast, 1);
+        }
+        vcomm->GetColumnComm()->AllReduce(m_MotionBcast,
+                                          LibUtilities::ReduceSum);
 
-            for (int j = 1; j < nproc/nstrips; j++)
-            {
-                vcomm->GetColumnComm()->Send(j*nstrips, tmp);
-            }
+        // rank i+j*nstrips carries strip i
+        if(colrank < nstrips*(nproc/nstrips))
+        {
+            int strip = colrank % nstrips;
 
-            for(int plane = 0; plane < m_np; plane++)
+            for(int var = 0; var < 2; var++)
             {
-                for(int j = 0; j < 2; j++)
-                {
-                    for(int k = 0; k < 2; ++k)
-                    {
-                        Motvars[j*2*m_np+k*m_np+plane] = m_MotionVars[j][k*npts];
-                    }
-                }
-            }
-
-            for(int i = 1; i < nstrips; ++i)
-            {
-                for(int j = 0; j < 2; ++j)
-                {
-                    for(int k = 0; k < 2; ++k)
-                    {
-                        tmp[j*2+k] = m_MotionVars[j][i+k*npts];
-                    }
-                }
-
-                for (int j = 0; j < nproc/nstrips; j++)
+                for(int k = 0; k < 2; k++)
                 {
-                    vcomm->GetColumnComm()->Send(i+j*nstrips, tmp);
+                    Vmath::Fill(m_np,
+                                m_MotionBcast[(var*2+k)*nstrips + strip],
+                                tmp = Motvars + var*2*m_np + k*m_np, 1);
                 }
             }
         }
@@ -557,132 +498,88 @@ void ForcingMovingBody::Newmark_betaSolver(
         const Array<OneD, MultiRegions::ExpListSharedPtr> &pFields,
               Array<OneD, NekDouble> &HydroForces,
               Array<OneD, NekDouble> &BodyMotions)
-{  
-    std::string supptype = m_session->GetSolverInfo("SupportType");
-
+{
     int npts = HydroForces.num_elements();
-        
-    Array<OneD, Array<OneD, NekDouble> > fft_i(4);
-    Array<OneD, Array<OneD, NekDouble> > fft_o(4);
 
-    for(int i = 0; i < 4; i++)
-    {
-        fft_i[i] = Array<OneD, NekDouble>(npts, 0.0);
-        fft_o[i] = Array<OneD, NekDouble>(npts, 0.0);
-    }
+    Array<OneD, NekDouble> tmp0, tmp1;
+
+    // the force and the three motion variables are stored one after
+    // the other, i.e. as a npts x 4 column-major block
+    Vmath::Vcopy(npts, HydroForces, 1, m_waveIn, 1);
+    Vmath::Vcopy(3*npts, BodyMotions, 1, tmp0 = m_waveIn + npts, 1);
 
-    Vmath::Vcopy(npts, HydroForces, 1, fft_i[0], 1);
-    for(int i = 0; i < 3; i++)
-    {
-        Vmath::Vcopy(npts, BodyMotions+i*npts, 1, fft_i[i+1], 1);   
-    }
-    
     // Implement Fourier transformation of the motion variables
-    if(boost::iequals(supptype, "Free-Free"))
-    {
-        for(int j = 0 ; j < 4; ++j)
-        {
-            m_FFT->FFTFwdTrans(fft_i[j], fft_o[j]);
-        }
-    }
-    else if(boost::iequals(supptype, "Pinned-Pinned"))
+    if(m_freeFree)
     {
-        //TODO:
-        int N = fft_i[0].num_elements();
-
-        for(int var = 0; var < 4; var++)
+        for(int var = 0; var < 4; ++var)
         {
-            for(int i = 0; i < N; i++)
-            {
-                fft_o[var][i] = 0;
-
-                for(int k = 0; k < N; k++)
-                {
-                    fft_o[var][i] +=
-                        fft_i[var][k]*
-                            sin(M_PI/(N)*(k+1/2)*(i+1));
-                }
-            }
+            m_FFT->FFTFwdTrans(tmp0 = m_waveIn  + var*npts,
+                               tmp1 = m_waveOut + var*npts);
         }
     }
     else
     {
-        ASSERTL0(false,
-                    "Unrecognized support type for cable's motion");
+        Blas::Dgemm('N', 'N', npts, 4, npts, 1.0,
+                    &m_sineFwd[0], npts, &m_waveIn[0], npts,
+                    0.0, &m_waveOut[0], npts);
     }
 
-    // solve the ODE in the wave space
+    // solve the ODE in the wave space: the right-hand side B x + f/rho of
+    // all modes is formed with a single multiply, then every mode is
+    // solved with its LU factors
+    Blas::Dgemm('N', 'T', npts, 3, 3, 1.0,
+                &m_waveOut[npts], npts, &m_CoeffRhs[0], 3,
+                0.0, &m_waveIn[0], npts);
+    Vmath::Svtvp(npts, 1.0/m_structrho, m_waveOut, 1,
+                 m_waveIn, 1, m_waveIn, 1);
+
     for(int i = 0; i < npts; ++i)
     {
-        int nrows = 3;
+        const NekDouble *lu  = &m_CoeffLU[9*i];
+        const int       *piv = &m_CoeffPivot[3*i];
 
-        Array<OneD, NekDouble> tmp0,tmp1,tmp2;
-        tmp0 = Array<OneD, NekDouble> (3,0.0);
-        tmp1 = Array<OneD, NekDouble> (3,0.0);
-        tmp2 = Array<OneD, NekDouble> (3,0.0);
+        NekDouble x[3];
+        for(int var = 0; var < 3; ++var)
+        {
+            x[var] = m_waveIn[var*npts + i];
+        }
 
-        for(int var = 0; var < 3; var++)
+        // row interchanges, LAPACK pivots are one-based
+        for(int k = 0; k < 3; ++k)
         {
-            tmp0[var] = fft_o[var+1][i];
+            std::swap(x[k], x[piv[k]-1]);
         }
 
-        tmp2[0] = fft_o[0][i];
+        // forward substitution with the unit lower factor
+        x[1] -= lu[1]*x[0];
+        x[2] -= lu[2]*x[0] + lu[5]*x[1];
 
-        Blas::Dgemv('N', nrows, nrows, 1.0,
-                    &(m_CoeffMat_B[i]->GetPtr())[0],
-                    nrows, &tmp0[0], 1,
-                    0.0,   &tmp1[0], 1);
-        Blas::Dgemv('N', nrows, nrows, 1.0/m_structrho,
-                    &(m_CoeffMat_A[i]->GetPtr())[0],
-                    nrows, &tmp2[0], 1,
-                    1.0,   &tmp1[0], 1);
+        // back substitution with the upper factor
+        x[2]  =  x[2] / lu[8];
+        x[1]  = (x[1] - lu[7]*x[2]) / lu[4];
+        x[0]  = (x[0] - lu[3]*x[1] - lu[6]*x[2]) / lu[0];
 
-        for(int var = 0; var < 3; var++)
+        for(int var = 0; var < 3; ++var)
         {
-            fft_i[var][i] = tmp1[var];
+            m_waveIn[var*npts + i] = x[var];
         }
     }
 
     // get physical coeffients via Backward fourier transformation of wave
     // coefficients
-    if(boost::iequals(supptype, "Free-Free"))
+    if(m_freeFree)
     {
         for(int var = 0; var < 3; var++)
         {
-            m_FFT->FFTBwdTrans(fft_i[var], fft_o[var]);
-        }
-    }
-    else if(boost::iequals(supptype, "Pinned-Pinned"))
-    {
-        //TODO:
-        int N = fft_i[0].num_elements();
-
-        for(int var = 0; var < 3; var++)
-        {
-            for(int i = 0; i < N; i++)
-            {
-                fft_o[var][i] = 0;
-
-                for(int k = 0; k < N; k++)
-                {
-                    fft_o[var][i] +=
-                        fft_i[var][k]*
-                            sin(M_PI/(N)*(k+1)*(i+1/2))*2/N;
-                }
-            }
+            m_FFT->FFTBwdTrans(tmp0 = m_waveIn    + var*npts,
+                               tmp1 = BodyMotions + var*npts);
         }
     }
     else
     {
-        ASSERTL0(false,
-                    "Unrecognized support type for cable's motion");
-    }
-    
-
-    for(int i = 0; i < 3; i++)
-    {
-        Array<OneD, NekDouble> tmp(npts,0.0);
-        Vmath::Vcopy(npts, fft_o[i], 1, tmp = BodyMotions+i*npts, 1);
+        Blas::Dgemm('N', 'N', npts, 3, npts, 1.0,
+                    &m_sineBwd[0], npts, &m_waveIn[0], npts,
+                    0.0, &BodyMotions[0], npts);
     }
 }
   
@@ -746,6 +643,7 @@ void ForcingMovingBody::InitialiseCableModel(
         m_FFT = 
             LibUtilities::GetNektarFFTFactory().CreateInstance(
                                             "NekFFTW", nplanes);
+        m_MotionBcast = Array<OneD, NekDouble>(2*2*npts, 0.0);
     }
     else
     {
@@ -758,6 +656,7 @@ void ForcingMovingBody::InitialiseCableModel(
         m_FFT = 
             LibUtilities::GetNektarFFTFactory().CreateInstance(
                                             "NekFFTW", nstrips);
+        m_MotionBcast = Array<OneD, NekDouble>(2*2*nstrips, 0.0);
     }
 
     // load the structural dynamic parameters from xml file
@@ -948,7 +847,7 @@ void ForcingMovingBody::InitialiseCableModel(
 void ForcingMovingBody::SetDynEqCoeffMatrix(
         const Array<OneD, MultiRegions::ExpListSharedPtr> &pFields)
 {
-    int nplanes;
+    int nplanes, npts;
 
     bool homostrip;
     m_session->MatchSolverInfo("HomoStrip","True",homostrip,false);
@@ -956,14 +855,21 @@ void ForcingMovingBody::SetDynEqCoeffMatrix(
     if(!homostrip)
     {
         nplanes = m_session->GetParameter("HomModesZ"); 
+        npts    = nplanes;
     }
     else
     {
         m_session->LoadParameter("Strip_Z", nplanes);
+        m_session->LoadParameter("HomStructModesZ", npts);
     }
 
-    m_CoeffMat_A = Array<OneD, DNekMatSharedPtr>(nplanes);
-    m_CoeffMat_B = Array<OneD, DNekMatSharedPtr>(nplanes);
+    m_CoeffLU    = Array<OneD, NekDouble>(9*nplanes, 0.0);
+    m_CoeffPivot = Array<OneD, int>      (3*nplanes, 0);
+    m_CoeffRhs   = Array<OneD, NekDouble>(9, 0.0);
+
+    // work space of Newmark_betaSolver
+    m_waveIn  = Array<OneD, NekDouble>(4*npts, 0.0);
+    m_waveOut = Array<OneD, NekDouble>(4*npts, 0.0);
 
     NekDouble tmp1, tmp2, tmp3;
     NekDouble tmp4, tmp5, tmp6, tmp7;
@@ -987,61 +893,82 @@ void ForcingMovingBody::SetDynEqCoeffMatrix(
 
     std::string supptype = m_session->GetSolverInfo("SupportType");
 
+    if (boost::iequals(supptype, "Free-Free"))
+    {
+        m_freeFree = true;
+    }
+    else if(boost::iequals(supptype, "Pinned-Pinned"))
+    {
+        m_freeFree = false;
+
+        // sine transforms of the motion variables
+        int N = npts;
+        m_sineFwd = Array<OneD, NekDouble>(N*N, 0.0);
+        m_sineBwd = Array<OneD, NekDouble>(N*N, 0.0);
+
+        for(int i = 0; i < N; i++)
+        {
+            for(int k = 0; k < N; k++)
+            {
+                //TODO:
+                m_sineFwd[k*N+i] = sin(M_PI/(N)*(k+1/2)*(i+1));
+                m_sineBwd[k*N+i] = sin(M_PI/(N)*(k+1)*(i+1/2))*2/N;
+            }
+        }
+    }
+    else
+    {
+        ASSERTL0(false,
+                    "Unrecognized support type for cable's motion");
+    }
+
+    // the right-hand matrix does not depend on the wave number
+    m_CoeffRhs[4] = 1.0;
+    m_CoeffRhs[7] = m_timestep/2.0;
+    m_CoeffRhs[2] = 1.0;
+    m_CoeffRhs[5] = m_timestep;
+    m_CoeffRhs[8] = tmp1/4.0;
+
     for(int plane = 0; plane < nplanes; plane++)
     {
         int nel = 3;
-        m_CoeffMat_A[plane]
-                = MemoryManager<DNekMat>::AllocateSharedPtr(nel,nel);
-        m_CoeffMat_B[plane]
-                = MemoryManager<DNekMat>::AllocateSharedPtr(nel,nel);
 
         // Initialised to avoid compiler warnings.
         unsigned int K = 0;
         NekDouble beta = 0.0;
 
-        if (boost::iequals(supptype, "Free-Free"))
+        if (m_freeFree)
         {
             K = plane/2;
             beta = 2.0 * M_PI/m_lhom;
         }
-        else if(boost::iequals(supptype, "Pinned-Pinned"))
+        else
         {
             K = plane+1;
             beta = M_PI/m_lhom;
         }
-        else
-        {
-            ASSERTL0(false,
-                        "Unrecognized support type for cable's motion");
-        }
 
         tmp6 = beta * K;
         tmp6 = tmp6 * tmp6;
         tmp7 = tmp6 * tmp6;
         tmp7 = tmp2 + tmp4 * tmp6 + tmp5 * tmp7;
 
-        (*m_CoeffMat_A[plane])(0,0) = tmp7;
-        (*m_CoeffMat_A[plane])(0,1) = tmp3;
-        (*m_CoeffMat_A[plane])(0,2) = 1.0;
-        (*m_CoeffMat_A[plane])(1,0) = 0.0;
-        (*m_CoeffMat_A[plane])(1,1) = 1.0;
-        (*m_CoeffMat_A[plane])(1,2) =-m_timestep/2.0;
-        (*m_CoeffMat_A[plane])(2,0) = 1.0;
-        (*m_CoeffMat_A[plane])(2,1) = 0.0;
-        (*m_CoeffMat_A[plane])(2,2) =-tmp1/4.0;
-        (*m_CoeffMat_B[plane])(0,0) = 0.0;
-        (*m_CoeffMat_B[plane])(0,1) = 0.0;
-        (*m_CoeffMat_B[plane])(0,2) = 0.0;
-        (*m_CoeffMat_B[plane])(1,0) = 0.0;
-        (*m_CoeffMat_B[plane])(1,1) = 1.0;
-        (*m_CoeffMat_B[plane])(1,2) = m_timestep/2.0;
-        (*m_CoeffMat_B[plane])(2,0) = 1.0;
-        (*m_CoeffMat_B[plane])(2,1) = m_timestep;
-        (*m_CoeffMat_B[plane])(2,2) = tmp1/4.0;
-
-        m_CoeffMat_A[plane]->Invert();
-        (*m_CoeffMat_B[plane]) =
-            (*m_CoeffMat_A[plane]) * (*m_CoeffMat_B[plane]);
+        // column-major left-hand matrix, factorised once for all time steps
+        NekDouble *A = &m_CoeffLU[9*plane];
+        A[0] = tmp7;
+        A[3] = tmp3;
+        A[6] = 1.0;
+        A[1] = 0.0;
+        A[4] = 1.0;
+        A[7] =-m_timestep/2.0;
+        A[2] = 1.0;
+        A[5] = 0.0;
+        A[8] =-tmp1/4.0;
+
+        int info = 0;
+        Lapack::Dgetrf(nel, nel, A, nel, &m_CoeffPivot[3*plane], info);
+        ASSERTL0(info == 0,
+                 "Newmark-beta matrix of the cable is singular");
     }
 }
 
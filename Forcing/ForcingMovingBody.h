@@ -137,10 +137,23 @@ class ForcingMovingBody : public SolverUtils::Forcing
         Array<OneD, Array<OneD, Array<OneD, NekDouble> > > m_fV;
         /// fictitious acceleration storage
         Array<OneD, Array<OneD, Array<OneD, NekDouble> > > m_fA;
-        /// matrices in Newmart-beta method
-        Array<OneD, DNekMatSharedPtr> m_CoeffMat_A;
-        /// matrices in Newmart-beta method
-        Array<OneD, DNekMatSharedPtr> m_CoeffMat_B;
+        /// LU factors of the left-hand matrix in Newmark-beta method, 3x3
+        /// column-major per structural mode
+        Array<OneD, NekDouble>        m_CoeffLU;
+        /// pivots of the LU factors, 3 per structural mode
+        Array<OneD, int>              m_CoeffPivot;
+        /// right-hand matrix in Newmark-beta method (same for all modes)
+        Array<OneD, NekDouble>        m_CoeffRhs;
+        /// support type is Free-Free (FFT) rather than Pinned-Pinned (sine)
+        bool                          m_freeFree;
+        /// forward and backward sine transforms for Pinned-Pinned support
+        Array<OneD, NekDouble>        m_sineFwd;
+        Array<OneD, NekDouble>        m_sineBwd;
+        /// wave space work arrays of Newmark_betaSolver, [force, motion]
+        Array<OneD, NekDouble>        m_waveIn;
+        Array<OneD, NekDouble>        m_waveOut;
+        /// motion variables reduced over the column communicator
+        Array<OneD, NekDouble>        m_MotionBcast;
         /// [0] is displacements, [1] is velocities, [2] is accelerations
         Array<OneD, std::string> m_funcName;
         /// motion direction: [0] is 'x' and [1] is 'y'
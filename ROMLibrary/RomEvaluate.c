@@ -0,0 +1,182 @@
+/******************************************************************************
+ *
+ * File RomEvaluate.c
+ *
+ * For more information, please see: http://www.nektar.info
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+ * Department of Aeronautics, Imperial College London (UK), and Scientific
+ * Computing and Imaging Institute, University of Utah (USA).
+ *
+ * License for the specific language governing rights and limitations under
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Description: Evaluate a stored reduced model from the command line
+ *
+ *****************************************************************************/
+
+#include "./ithaca_rom.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Usage: RomEvaluate ROM_reduced_model.txt w nu [velocity.txt]
+ *        RomEvaluate -t nthreads ROM_reduced_model.txt w0 w1 nu0 nu1
+ *
+ * Prints the reduced coefficients and quantities of interest at (w, nu),
+ * optionally writes x y u v of the reconstructed velocity.
+ *
+ * With -t, evaluates a grid over [w0, w1] x [nu0, nu1] serially and on
+ * nthreads threads sharing the model, and fails unless the concurrent
+ * results match the serial ones exactly.
+ */
+static int check_threads(int nthreads, const char *filename,
+                         double w0, double w1, double nu0, double nu1)
+{
+    const int n = 12;
+    ithaca_rom_model *model;
+    double params[2 * 12 * 12], deviation;
+    int status, i, j;
+
+    status = ithaca_rom_load(filename, &model);
+    if (status != ITHACA_ROM_OK)
+    {
+        fprintf(stderr, "%s: %s\n", filename,
+                ithaca_rom_status_string(status));
+        return 1;
+    }
+    for (i = 0; i < n; ++i)
+    {
+        for (j = 0; j < n; ++j)
+        {
+            params[2 * (i * n + j)]     = w0 + (w1 - w0) * i / (n - 1);
+            params[2 * (i * n + j) + 1] = nu0 + (nu1 - nu0) * j / (n - 1);
+        }
+    }
+    status = ithaca_rom_check_threads(model, params, n * n, nthreads,
+                                      &deviation);
+    ithaca_rom_free(model);
+    if (status != ITHACA_ROM_OK)
+    {
+        fprintf(stderr, "%s\n", ithaca_rom_status_string(status));
+        return 1;
+    }
+    printf("%d threads x %d parameters, max deviation from the serial "
+           "results %.16e\n", nthreads, n * n, deviation);
+    return deviation == 0.0 ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    ithaca_rom_model *model;
+    double param[2];
+    double *coeffs, *qoi;
+    int status, iterations, i, ncoeffs, nqoi;
+
+    if (argc == 8 && strcmp(argv[1], "-t") == 0)
+    {
+        return check_threads(atoi(argv[2]), argv[3], atof(argv[4]),
+                             atof(argv[5]), atof(argv[6]), atof(argv[7]));
+    }
+    if (argc < 4)
+    {
+        fprintf(stderr, "Usage: %s model.txt w nu [velocity.txt]\n"
+                "       %s -t nthreads model.txt w0 w1 nu0 nu1\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    status = ithaca_rom_load(argv[1], &model);
+    if (status != ITHACA_ROM_OK)
+    {
+        fprintf(stderr, "%s: %s\n", argv[1],
+                ithaca_rom_status_string(status));
+        return 1;
+    }
+
+    param[0] = atof(argv[2]);
+    param[1] = atof(argv[3]);
+    ncoeffs  = ithaca_rom_num_coefficients(model);
+    nqoi     = ithaca_rom_num_qois(model);
+    coeffs   = (double *)malloc(ncoeffs * sizeof(double));
+    qoi      = (double *)malloc((nqoi > 0 ? nqoi : 1) * sizeof(double));
+
+    status = ithaca_rom_evaluate(model, param, 2, coeffs, &iterations);
+    if (status == ITHACA_ROM_OK)
+    {
+        printf("converged in %d iterations\n", iterations);
+        for (i = 0; i < ncoeffs; ++i)
+        {
+            printf("coefficient %d: %.16e\n", i, coeffs[i]);
+        }
+        status = ithaca_rom_qoi(model, param, 2, coeffs, qoi);
+    }
+    if (status == ITHACA_ROM_OK)
+    {
+        for (i = 0; i < nqoi; ++i)
+        {
+            printf("%s: %.16e\n", ithaca_rom_qoi_name(model, i), qoi[i]);
+        }
+    }
+
+    if (status == ITHACA_ROM_OK && argc > 4)
+    {
+        int npts = ithaca_rom_num_points(model);
+        double *x = (double *)malloc(4 * (npts > 0 ? npts : 1) * sizeof(double));
+        double *y = x + npts, *u = y + npts, *v = u + npts;
+        FILE *out;
+
+        status = ithaca_rom_coordinates(model, x, y);
+        if (status == ITHACA_ROM_OK)
+        {
+            status = ithaca_rom_reconstruct(model, coeffs, u, v);
+        }
+        if (status == ITHACA_ROM_OK)
+        {
+            out = fopen(argv[4], "w");
+            if (out)
+            {
+                for (i = 0; i < npts; ++i)
+                {
+                    fprintf(out, "%.16e %.16e %.16e %.16e\n",
+                            x[i], y[i], u[i], v[i]);
+                }
+                fclose(out);
+            }
+            else
+            {
+                fprintf(stderr, "cannot write %s\n", argv[4]);
+            }
+        }
+        free(x);
+    }
+
+    if (status != ITHACA_ROM_OK)
+    {
+        fprintf(stderr, "%s\n", ithaca_rom_status_string(status));
+    }
+
+    free(coeffs);
+    free(qoi);
+    ithaca_rom_free(model);
+    return status == ITHACA_ROM_OK ? 0 : 1;
+}
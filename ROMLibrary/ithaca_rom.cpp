@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// File ithaca_rom.cpp
+//
+// For more information, please see: http://www.nektar.info
+//
+// The MIT License
+//
+// Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+// Department of Aeronautics, Imperial College London (UK), and Scientific
+// Computing and Imaging Institute, University of Utah (USA).
+//
+// License for the specific language governing rights and limitations under
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// Description: C interface for evaluating a stored reduced model
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "./ithaca_rom.h"
+#include "../EquationSystems/ReducedModel.h"
+#include <exception>
+
+using namespace Nektar;
+
+struct ithaca_rom_model
+{
+    ReducedModelSharedPtr m_model;
+};
+
+namespace
+{
+    // copies between the caller's buffers and Eigen vectors
+    Eigen::VectorXd ToEigen(const double *data, int n)
+    {
+        return Eigen::Map<const Eigen::VectorXd>(data, n);
+    }
+
+    void FromEigen(const Eigen::VectorXd &vec, double *data)
+    {
+        Eigen::Map<Eigen::VectorXd>(data, vec.size()) = vec;
+    }
+}
+
+extern "C"
+{
+
+int ithaca_rom_load(const char *filename, ithaca_rom_model **model)
+{
+    if (!filename || !model)
+    {
+        return ITHACA_ROM_ERROR_ARGUMENT;
+    }
+    *model = 0;
+    try
+    {
+        ReducedModelSharedPtr loaded = ReducedModel::Load(filename);
+        *model = new ithaca_rom_model;
+        (*model)->m_model = loaded;
+    }
+    catch (...)
+    {
+        return ITHACA_ROM_ERROR_FILE;
+    }
+    return ITHACA_ROM_OK;
+}
+
+void ithaca_rom_free(ithaca_rom_model *model)
+{
+    delete model;
+}
+
+const char *ithaca_rom_status_string(int status)
+{
+    switch (status)
+    {
+        case ITHACA_ROM_OK:
+            return "success";
+        case ITHACA_ROM_ERROR_ARGUMENT:
+            return "invalid argument";
+        case ITHACA_ROM_ERROR_FILE:
+            return "cannot read reduced model file";
+        case ITHACA_ROM_ERROR_NO_FIELDS:
+            return "reduced model was stored without velocity modes";
+        case ITHACA_ROM_ERROR_EVALUATION:
+            return "reduced model evaluation failed";
+        default:
+            return "unknown status";
+    }
+}
+
+int ithaca_rom_num_parameters(const ithaca_rom_model *model)
+{
+    return model ? 2 : ITHACA_ROM_ERROR_ARGUMENT;
+}
+
+int ithaca_rom_num_coefficients(const ithaca_rom_model *model)
+{
+    return model ? model->m_model->GetSize() : ITHACA_ROM_ERROR_ARGUMENT;
+}
+
+int ithaca_rom_num_qois(const ithaca_rom_model *model)
+{
+    return model ? model->m_model->GetOperators().m_qoi.GetNumQoI()
+                 : ITHACA_ROM_ERROR_ARGUMENT;
+}
+
+const char *ithaca_rom_qoi_name(const ithaca_rom_model *model, int index)
+{
+    if (!model || index < 0 ||
+        index >= model->m_model->GetOperators().m_qoi.GetNumQoI())
+    {
+        return 0;
+    }
+    return model->m_model->GetOperators().m_qoi.m_names[index].c_str();
+}
+
+int ithaca_rom_num_points(const ithaca_rom_model *model)
+{
+    return model ? int(model->m_model->GetOperators().m_modeX.rows())
+                 : ITHACA_ROM_ERROR_ARGUMENT;
+}
+
+int ithaca_rom_evaluate(const ithaca_rom_model *model,
+                        const double *param, int nparam,
+                        double *coefficients, int *iterations)
+{
+    if (!model || !param || !coefficients || nparam != 2)
+    {
+        return ITHACA_ROM_ERROR_ARGUMENT;
+    }
+    try
+    {
+        Array<OneD, NekDouble> parameter(nparam);
+        for (int i = 0; i < nparam; ++i)
+        {
+            parameter[i] = param[i];
+        }
+        int no_iter;
+        FromEigen(model->m_model->Evaluate(parameter, no_iter), coefficients);
+        if (iterations)
+        {
+            *iterations = no_iter;
+        }
+    }
+    catch (...)
+    {
+        return ITHACA_ROM_ERROR_EVALUATION;
+    }
+    return ITHACA_ROM_OK;
+}
+
+int ithaca_rom_qoi(const ithaca_rom_model *model,
+                   const double *param, int nparam,
+                   const double *coefficients, double *qoi)
+{
+    if (!model || !param || !coefficients || !qoi || nparam != 2)
+    {
+        return ITHACA_ROM_ERROR_ARGUMENT;
+    }
+    try
+    {
+        Array<OneD, NekDouble> parameter(nparam);
+        for (int i = 0; i < nparam; ++i)
+        {
+            parameter[i] = param[i];
+        }
+        Eigen::VectorXd solution =
+            ToEigen(coefficients, model->m_model->GetSize());
+        FromEigen(model->m_model->EvaluateQoI(parameter, solution), qoi);
+    }
+    catch (...)
+    {
+        return ITHACA_ROM_ERROR_EVALUATION;
+    }
+    return ITHACA_ROM_OK;
+}
+
+int ithaca_rom_reconstruct(const ithaca_rom_model *model,
+                           const double *coefficients, double *u, double *v)
+{
+    if (!model || !coefficients || !u || !v)
+    {
+        return ITHACA_ROM_ERROR_ARGUMENT;
+    }
+    if (model->m_model->GetOperators().m_modeX.rows() == 0)
+    {
+        return ITHACA_ROM_ERROR_NO_FIELDS;
+    }
+    Eigen::VectorXd solution = ToEigen(coefficients, model->m_model->GetSize());
+    Eigen::VectorXd field_u, field_v;
+    model->m_model->ReconstructVelocity(solution, field_u, field_v);
+    FromEigen(field_u, u);
+    FromEigen(field_v, v);
+    return ITHACA_ROM_OK;
+}
+
+int ithaca_rom_coordinates(const ithaca_rom_model *model,
+                           double *x, double *y)
+{
+    if (!model || !x || !y)
+    {
+        return ITHACA_ROM_ERROR_ARGUMENT;
+    }
+    if (model->m_model->GetOperators().m_coordX.rows() == 0)
+    {
+        return ITHACA_ROM_ERROR_NO_FIELDS;
+    }
+    FromEigen(model->m_model->GetOperators().m_coordX, x);
+    FromEigen(model->m_model->GetOperators().m_coordY, y);
+    return ITHACA_ROM_OK;
+}
+
+int ithaca_rom_check_threads(const ithaca_rom_model *model,
+                             const double *params, int npoints,
+                             int nthreads, double *max_deviation)
+{
+    if (!model || !params || npoints <= 0 || nthreads <= 0 || !max_deviation)
+    {
+        return ITHACA_ROM_ERROR_ARGUMENT;
+    }
+    try
+    {
+        Array<OneD, Array<OneD, NekDouble> > parameters(npoints);
+        for (int i = 0; i < npoints; ++i)
+        {
+            parameters[i] = Array<OneD, NekDouble>(2);
+            parameters[i][0] = params[2*i];
+            parameters[i][1] = params[2*i+1];
+        }
+        *max_deviation =
+            CheckConcurrentEvaluation(model->m_model, parameters, nthreads);
+    }
+    catch (...)
+    {
+        return ITHACA_ROM_ERROR_EVALUATION;
+    }
+    return ITHACA_ROM_OK;
+}
+
+}
@@ -0,0 +1,112 @@
+/******************************************************************************
+ *
+ * File ithaca_rom.h
+ *
+ * For more information, please see: http://www.nektar.info
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2006 Division of Applied Mathematics, Brown University (USA),
+ * Department of Aeronautics, Imperial College London (UK), and Scientific
+ * Computing and Imaging Institute, University of Utah (USA).
+ *
+ * License for the specific language governing rights and limitations under
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Description: C interface for evaluating a stored reduced model
+ *
+ *****************************************************************************/
+
+#ifndef NEKTAR_SOLVERS_ITHACA_ROM_H
+#define NEKTAR_SOLVERS_ITHACA_ROM_H
+
+/*
+ * Evaluates a reduced model written by the CoupledLinearisedNS_TT online
+ * phase (parameter write_reduced_model, file ROM_reduced_model.txt)
+ * without a session file or any Nektar++ field. The parameter vector is
+ * (w, nu), the same as general_param_vector of the solver.
+ *
+ * A loaded model is immutable: any number of threads may call
+ * ithaca_rom_evaluate, ithaca_rom_qoi and ithaca_rom_reconstruct on the
+ * same handle concurrently. All functions return ITHACA_ROM_OK or a
+ * negative status; ithaca_rom_status_string describes the status.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ithaca_rom_model ithaca_rom_model;
+
+enum
+{
+    ITHACA_ROM_OK                 =  0,
+    ITHACA_ROM_ERROR_ARGUMENT     = -1,
+    ITHACA_ROM_ERROR_FILE         = -2,
+    ITHACA_ROM_ERROR_NO_FIELDS    = -3,
+    ITHACA_ROM_ERROR_EVALUATION   = -4
+};
+
+int  ithaca_rom_load(const char *filename, ithaca_rom_model **model);
+void ithaca_rom_free(ithaca_rom_model *model);
+
+const char *ithaca_rom_status_string(int status);
+
+int ithaca_rom_num_parameters(const ithaca_rom_model *model);
+int ithaca_rom_num_coefficients(const ithaca_rom_model *model);
+int ithaca_rom_num_qois(const ithaca_rom_model *model);
+const char *ithaca_rom_qoi_name(const ithaca_rom_model *model, int index);
+/* number of quadrature points of a reconstructed field, 0 if the model
+   was stored without velocity modes */
+int ithaca_rom_num_points(const ithaca_rom_model *model);
+
+/* reduced coefficients of the converged solution at param[0..1],
+   coefficients holds ithaca_rom_num_coefficients values, iterations may
+   be NULL */
+int ithaca_rom_evaluate(const ithaca_rom_model *model,
+                        const double *param, int nparam,
+                        double *coefficients, int *iterations);
+
+/* quantities of interest of the reduced coefficients of param[0..1] on the
+   geometry of param[0], qoi holds ithaca_rom_num_qois values */
+int ithaca_rom_qoi(const ithaca_rom_model *model,
+                   const double *param, int nparam,
+                   const double *coefficients, double *qoi);
+
+/* velocity at the quadrature points of the reference geometry, u and v
+   hold ithaca_rom_num_points values each */
+int ithaca_rom_reconstruct(const ithaca_rom_model *model,
+                           const double *coefficients, double *u, double *v);
+
+/* coordinates of the quadrature points of the reference geometry */
+int ithaca_rom_coordinates(const ithaca_rom_model *model,
+                           double *x, double *y);
+
+/* evaluates the npoints parameters params[2*i..2*i+1] serially and then on
+   nthreads threads sharing the model; max_deviation receives the largest
+   difference of a concurrent from the serial coefficients */
+int ithaca_rom_check_threads(const ithaca_rom_model *model,
+                             const double *params, int npoints,
+                             int nthreads, double *max_deviation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,37 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <LibUtilities/BasicUtils/ErrorUtil.hpp>
+#include "../Filters/TimeSeriesWriter.h"
+
+using namespace std;
+using namespace Nektar;
+
+// Converts binary filter output (.fce.bin, .mot.bin, .eny.bin) to the text
+// layout written by the filters.
+int main(int argc, char *argv[])
+{
+    if(argc != 2 && argc != 3)
+    {
+        fprintf(stderr,"Usage: TimeSeriesToText file.bin [file]\n");
+        fprintf(stderr,"  writes file (default: file.bin without .bin)\n");
+        exit(1);
+    }
+
+    string infile  = argv[1];
+    string outfile = argc == 3 ? argv[2] : infile;
+    if(argc == 2)
+    {
+        ASSERTL0(outfile.size() > 4 &&
+                 outfile.substr(outfile.size() - 4) == ".bin",
+                 "Output file name needed if input does not end in .bin");
+        outfile = outfile.substr(0, outfile.size() - 4);
+    }
+
+    ofstream out(outfile.c_str());
+    ASSERTL0(out.good(), "Cannot open " + outfile);
+    TimeSeriesWriter::ConvertToText(infile, out);
+
+    return 0;
+}